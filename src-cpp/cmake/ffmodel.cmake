@@ -18,6 +18,7 @@ set(MODEL_SRC
     model/utils.cpp
     model/utils.hpp
     model/defines.h
+    model/snapshot.hpp
 
     # global
     controller/global/global.cpp
@@ -27,10 +28,20 @@ set(MODEL_SRC
     model/auth/crypto.cpp
     model/auth/crypto.hpp
     model/auth/iauth.hpp
+    model/auth/kdfpool.cpp
+    model/auth/kdfpool.hpp
+    model/auth/ratelimiter.cpp
+    model/auth/ratelimiter.hpp
 
     # Simple auth
     model/auth/simple/auth.cpp
     model/auth/simple/auth.hpp
+    model/auth/simple/bantable.cpp
+    model/auth/simple/bantable.hpp
+    model/auth/simple/sessiontable.cpp
+    model/auth/simple/sessiontable.hpp
+    model/auth/simple/signedtoken.cpp
+    model/auth/simple/signedtoken.hpp
 
     # connect
 
@@ -45,16 +56,33 @@ set(MODEL_SRC
     model/connect/grpc/connect.hpp
 
     # DAO
+    model/dao/iasyncqueuelist.hpp
+    model/dao/iasyncqueue.hpp
     model/dao/iqueuelist.hpp
     model/dao/iqueue.hpp
 
     #sqlite
     model/dao/sqlite/queuelist.cpp
     model/dao/sqlite/queue.hpp
+    model/dao/sqlite/queuegroup.cpp
+    model/dao/sqlite/queuegroup.hpp
     model/dao/sqlite/queue.cpp
     model/dao/sqlite/queuelist.hpp
-    
+
+    #federation
+    model/dao/federation/queue.cpp
+    model/dao/federation/queue.hpp
+    model/dao/federation/queuelist.cpp
+    model/dao/federation/queuelist.hpp
+
     #grpc
+    model/dao/grpc/asynccall.hpp
+    model/dao/grpc/asyncqueue.cpp
+    model/dao/grpc/asyncqueue.hpp
+    model/dao/grpc/asyncqueuelist.cpp
+    model/dao/grpc/asyncqueuelist.hpp
+    model/dao/grpc/finishedcache.cpp
+    model/dao/grpc/finishedcache.hpp
     model/dao/grpc/queue.cpp
     model/dao/grpc/queue.hpp
     model/dao/grpc/queuelist.cpp
@@ -65,9 +93,23 @@ set(MODEL_SRC
     model/utils.cpp
     model/utils.hpp
 
+    # metrics
+    model/metrics/metrics.cpp
+    model/metrics/metrics.hpp
+
+    # sched
+    model/sched/estimator.cpp
+    model/sched/estimator.hpp
+    model/sched/pressure.cpp
+    model/sched/pressure.hpp
+    model/sched/scheduler.cpp
+    model/sched/scheduler.hpp
+
     # proc
     model/proc/iproc.cpp
     model/proc/iproc.hpp
+    model/proc/reactor.cpp
+    model/proc/reactor.hpp
     model/proc/task.cpp
     model/proc/task.hpp
 )
@@ -85,6 +127,8 @@ else ()
     
     if (LINUX)
         list(APPEND MODEL_SRC
+            model/proc/cgroup.cpp
+            model/proc/cgroup.hpp
             model/proc/linuxproc.cpp
             model/proc/linuxproc.hpp
         )
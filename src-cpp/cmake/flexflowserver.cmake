@@ -27,6 +27,12 @@ if(ENABLE_SERVER)
         controller/grpcserver/accessimpl.hpp
         controller/grpcserver/authinterceptor.cpp
         controller/grpcserver/authinterceptor.hpp
+        controller/grpcserver/metricsexporter.cpp
+        controller/grpcserver/metricsexporter.hpp
+        controller/grpcserver/metricsimpl.cpp
+        controller/grpcserver/metricsimpl.hpp
+        controller/grpcserver/metricsinterceptor.cpp
+        controller/grpcserver/metricsinterceptor.hpp
         controller/grpcserver/queueimpl.cpp
         controller/grpcserver/queueimpl.hpp
         controller/grpcserver/queuelistimpl.cpp
@@ -35,6 +41,8 @@ if(ENABLE_SERVER)
         controller/grpcserver/server.hpp
         controller/grpcserver/utils.cpp
         controller/grpcserver/utils.hpp
+        controller/grpcserver/workerimpl.cpp
+        controller/grpcserver/workerimpl.hpp
     )
 
     add_executable(FlexFlowServer
@@ -0,0 +1,28 @@
+if(ENABLE_TEST AND ENABLE_SERVER)
+    set(TEST_SRC
+        test/testserver.cpp
+        test/testserver.hpp
+
+        # benchmarks of the running server
+        test/loginstormtest.cpp
+        test/unixsockettest.cpp
+    )
+
+    add_executable(FlexFlowServerTest
+        ${SERVER_CONTROLLER_SRC}
+        ${TEST_SRC}
+    )
+
+    add_dependencies(FlexFlowServerTest grpc_common ffmodel)
+
+    target_link_libraries(FlexFlowServerTest
+        PRIVATE
+
+        ${FF_SERVER_LIBS}
+        ffmodel
+        GTest::gtest
+        GTest::gtest_main
+    )
+
+    add_test(NAME FlexFlowServerTest COMMAND FlexFlowServerTest)
+endif(ENABLE_TEST AND ENABLE_SERVER)
@@ -0,0 +1,22 @@
+if(ENABLE_SERVER)
+    set(WORKER_CONTROLLER_SRC
+        controller/worker/config.cpp
+        controller/worker/config.hpp
+        controller/worker/worker.cpp
+        controller/worker/worker.hpp
+    )
+
+    add_executable(FlexFlowWorker
+        ${WORKER_CONTROLLER_SRC}
+
+        workermain.cpp)
+
+    add_dependencies(FlexFlowWorker grpc_common ffmodel)
+
+    target_link_libraries(FlexFlowWorker
+        PRIVATE
+
+        ${FF_SERVER_LIBS}
+        ffmodel
+    )
+endif(ENABLE_SERVER)
@@ -30,13 +30,17 @@
 #endif
 
 #include "spdlog/spdlog.h"
+#include "spdlog/async.h"
 #include "spdlog/sinks/daily_file_sink.h"
+#include "spdlog/sinks/stdout_color_sinks.h"
 
 #include "model/utils.hpp"
 
+#include "model/auth/crypto.hpp"
 #include "model/connect/grpc/connect.hpp"
 #include "model/connect/sqlite/connect.hpp"
 
+#include "model/dao/federation/queuelist.hpp"
 #include "model/dao/grpc/queuelist.hpp"
 #include "model/dao/sqlite/queuelist.hpp"
 
@@ -120,10 +124,13 @@ void consoleFin()
 #endif
 }
 
-u8 spdlogInit(const std::string &path, const i32 logLevel)
+u8 spdlogInit(const std::string &path, const i32 logLevel,
+              const size_t asyncQueueSize, const bool asyncBlock)
 {
-    spdlog::debug("{}:{} spdlogInit", LOG_FILE_PATH(__FILE__), __LINE__);
-    spdlog::debug("{}:{} path is: {}", LOG_FILE_PATH(__FILE__), __LINE__, path);
+    FF_DEBUG("{}:{} spdlogInit", LOG_FILE_PATH(__FILE__), __LINE__);
+    FF_DEBUG("{}:{} path is: {}", LOG_FILE_PATH(__FILE__), __LINE__, path);
+    FF_DEBUG("{}:{} asyncQueueSize is: {}", LOG_FILE_PATH(__FILE__), __LINE__,
+        asyncQueueSize);
     if (path.empty())
     {
         return 0;
@@ -131,8 +138,23 @@ u8 spdlogInit(const std::string &path, const i32 logLevel)
 
     try
     {
-        auto daily_logger = spdlog::daily_logger_mt(
-            "STQLog", path);
+        std::shared_ptr<spdlog::logger> daily_logger;
+        if (asyncQueueSize)
+        {
+            // one writer thread, so messages stay in order
+            spdlog::init_thread_pool(asyncQueueSize, 1);
+            auto sink = std::make_shared<spdlog::sinks::daily_file_sink_mt>(path, 0, 0);
+            daily_logger = std::make_shared<spdlog::async_logger>(
+                "STQLog", sink, spdlog::thread_pool(),
+                asyncBlock ? spdlog::async_overflow_policy::block :
+                             spdlog::async_overflow_policy::overrun_oldest);
+            spdlog::register_logger(daily_logger);
+        }
+        else
+        {
+            daily_logger = spdlog::daily_logger_mt("STQLog", path);
+        }
+
         daily_logger->set_level(static_cast<spdlog::level::level_enum>(logLevel));
         spdlog::set_default_logger(daily_logger);
     }
@@ -146,10 +168,23 @@ u8 spdlogInit(const std::string &path, const i32 logLevel)
     return 0;
 }
 
-u8 sqliteInit(Model::DAO::IQueueList **out, std::string &target)
+void spdlogFin()
 {
-    spdlog::debug("{}:{} sqliteInit", LOG_FILE_PATH(__FILE__), __LINE__);
-    spdlog::debug("{}:{} target is: {}", LOG_FILE_PATH(__FILE__), __LINE__, target);
+    FF_DEBUG("{}:{} spdlogFin", LOG_FILE_PATH(__FILE__), __LINE__);
+
+    // flush all loggers, drain the async queue and join its thread
+    spdlog::shutdown();
+
+    // shutdown() also drops the default logger,
+    // keep a console one for whatever still logs during exit
+    spdlog::set_default_logger(spdlog::stdout_color_mt("console"));
+}
+
+u8 sqliteInit(Model::DAO::IQueueList **out, std::string &target,
+              const std::map<std::string, std::vector<std::string>> &groups)
+{
+    FF_DEBUG("{}:{} sqliteInit", LOG_FILE_PATH(__FILE__), __LINE__);
+    FF_DEBUG("{}:{} target is: {}", LOG_FILE_PATH(__FILE__), __LINE__, target);
 
     auto token = Model::Connect::SQLite::connect(target);
 
@@ -172,7 +207,7 @@ u8 sqliteInit(Model::DAO::IQueueList **out, std::string &target)
         return 1;
     }
 
-    if (sqlPtr->init(token, target))
+    if (sqlPtr->init(token, target, groups))
     {
         spdlog::error("{}:{} Fail to initialize sqlite queue list",
                       LOG_FILE_PATH(__FILE__), __LINE__);
@@ -184,6 +219,79 @@ u8 sqliteInit(Model::DAO::IQueueList **out, std::string &target)
     return 0;
 }
 
+u8 federationInit(Model::DAO::IQueueList **out,
+                  const std::vector<RemoteServer> &servers)
+{
+    FF_DEBUG("{}:{} federationInit", LOG_FILE_PATH(__FILE__), __LINE__);
+
+    std::vector<std::shared_ptr<Model::DAO::IQueueList>> members;
+    members.reserve(servers.size());
+    for (auto it = servers.begin(); it != servers.end(); ++it)
+    {
+        std::vector<u8> totpKey;
+        Model::Auth::Crypto::decodeBase32(it->totpKey, totpKey);
+        if (totpKey.empty())
+        {
+            spdlog::error("{}:{} Invalid totp key of {}:{}",
+                          LOG_FILE_PATH(__FILE__), __LINE__, it->host, it->port);
+            return 1;
+        }
+
+        Model::Connect::GRPC::ChannelOptions options;
+        options.otpProvider = [totpKey]()
+        {
+            return Model::Auth::Crypto::generateTotp(totpKey);
+        };
+
+        auto token = Model::Connect::GRPC::connect(it->host, it->port,
+            it->username, it->password, options.otpProvider(), options);
+        if (token == nullptr)
+        {
+            spdlog::error("{}:{} Fail to connect to {}:{}",
+                          LOG_FILE_PATH(__FILE__), __LINE__, it->host, it->port);
+            return 1;
+        }
+
+        std::shared_ptr<Model::DAO::GRPC::QueueList> grpcPtr(
+            new (std::nothrow) Model::DAO::GRPC::QueueList);
+        if (!grpcPtr)
+        {
+            spdlog::error("{}:{} Fail to allocate memory",
+                          LOG_FILE_PATH(__FILE__), __LINE__);
+            return 1;
+        }
+
+        if (grpcPtr->init(token))
+        {
+            spdlog::error("{}:{} Fail to initialize queue list of {}:{}",
+                          LOG_FILE_PATH(__FILE__), __LINE__, it->host, it->port);
+            return 1;
+        }
+
+        members.push_back(grpcPtr);
+    }
+
+    Model::DAO::Federation::QueueList *federationPtr =
+        new (std::nothrow) Model::DAO::Federation::QueueList;
+    if (!federationPtr)
+    {
+        spdlog::error("{}:{} Fail to allocate memory",
+                      LOG_FILE_PATH(__FILE__), __LINE__);
+        return 1;
+    }
+
+    if (federationPtr->init(members))
+    {
+        spdlog::error("{}:{} Fail to initialize federation queue list",
+                      LOG_FILE_PATH(__FILE__), __LINE__);
+        delete federationPtr;
+        return 1;
+    }
+
+    *out = federationPtr;
+    return 0;
+}
+
 } // end namespace Global
 
 } // end namespace Controller
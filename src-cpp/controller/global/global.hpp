@@ -24,7 +24,9 @@
 #ifndef _CONTROLLER_GLOBAL_GLOBAL_HPP_
 #define _CONTROLLER_GLOBAL_GLOBAL_HPP_
 
+#include <map>
 #include <string>
+#include <vector>
 
 #include "model/defines.h"
 
@@ -46,9 +48,44 @@ u8 consoleInit();
 
 void consoleFin();
 
-u8 spdlogInit(const std::string &, const i32 logLevel);
+/**
+ * @brief log into daily files under path
+ * @param asyncQueueSize 0 for synchronous logging, otherwise the messages
+ * are queued and written by a background thread
+ * @param asyncBlock block the caller when the queue is full,
+ * or overwrite the oldest message
+ */
+u8 spdlogInit(const std::string &, const i32 logLevel,
+              const size_t asyncQueueSize = 0,
+              const bool asyncBlock = true);
+
+/**
+ * @brief flush pending messages and stop the background logging thread
+ */
+void spdlogFin();
+
+/**
+ * @param groups group name to the names of its queues,
+ * idle queues of a group steal the pending tasks of the busiest one
+ */
+u8 sqliteInit(Model::DAO::IQueueList **out, std::string &target,
+              const std::map<std::string, std::vector<std::string>> &groups = {});
+
+typedef struct RemoteServer
+{
+    std::string host;
+    u16 port = 12345;
+    std::string username;
+    std::string password;
+    // Base32, the otp of every login is generated from it
+    std::string totpKey;
+} RemoteServer;
 
-u8 sqliteInit(Model::DAO::IQueueList **out, std::string &target);
+/**
+ * @brief login to every server and serve their queues as one queue list
+ */
+u8 federationInit(Model::DAO::IQueueList **out,
+                  const std::vector<RemoteServer> &servers);
 
 } // end namespace Global
 
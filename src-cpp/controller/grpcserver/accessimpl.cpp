@@ -44,7 +44,7 @@ grpc::Status AccessImpl::Info(grpc::ServerContext *ctx,
                               const ff::Empty *req,
                               ff::InfoRes *res)
 {
-    spdlog::debug("{}:{} AccessImpl::Info", LOG_FILE_PATH(__FILE__), __LINE__);
+    FF_DEBUG("{}:{} AccessImpl::Info", LOG_FILE_PATH(__FILE__), __LINE__);
     UNUSED(ctx);
     UNUSED(req);
     res->set_branch(FF_BRANCH);
@@ -57,7 +57,7 @@ grpc::Status AccessImpl::Login(grpc::ServerContext *ctx,
                                const ff::LoginReq *req,
                                ff::LoginRes *res)
 {
-    spdlog::debug("{}:{} AccessImpl::Login", LOG_FILE_PATH(__FILE__), __LINE__);
+    FF_DEBUG("{}:{} AccessImpl::Login", LOG_FILE_PATH(__FILE__), __LINE__);
     
     if (!ctx || !req || !res)
     {
@@ -67,12 +67,22 @@ grpc::Status AccessImpl::Login(grpc::ServerContext *ctx,
 
     std::string token;
 
-    if (auth->login(req->username(),
-    req->password(), req->otp(), token))
+    u8 ret = auth->login(req->username(), req->password(), req->otp(), token);
+    if (ret == 2)
+    {
+        spdlog::error("{}:{} Too many logins", LOG_FILE_PATH(__FILE__), __LINE__);
+        return grpc::Status(grpc::StatusCode::RESOURCE_EXHAUSTED,
+            "Too many logins, please retry later");
+    }
+
+    if (ret)
     {
         spdlog::error("{}:{} Fail to login", LOG_FILE_PATH(__FILE__), __LINE__);
-        std::string ip = Utils::getIPFromContext(ctx);
-        auth->addBannedIp(ip);
+        if (!Utils::isLocalPeer(ctx))
+        {
+            auth->addBannedIp(Utils::getIPFromContext(ctx));
+        }
+
         return grpc::Status(grpc::StatusCode::UNAUTHENTICATED,
             "Fail to login");
     }
@@ -96,8 +106,11 @@ grpc::Status AccessImpl::Logout(grpc::ServerContext *ctx,
     if (auth->logout(req->username(), token))
     {
         spdlog::error("{}:{} Fail to logout", LOG_FILE_PATH(__FILE__), __LINE__);
-        std::string ip = Utils::getIPFromContext(ctx);
-        auth->addBannedIp(ip);
+        if (!Utils::isLocalPeer(ctx))
+        {
+            auth->addBannedIp(Utils::getIPFromContext(ctx));
+        }
+
         return grpc::Status(grpc::StatusCode::UNAUTHENTICATED,
             "Fail to logout");
     }
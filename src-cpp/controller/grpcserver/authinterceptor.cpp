@@ -24,6 +24,7 @@
 #include "spdlog/spdlog.h"
 
 #include "model/utils.hpp"
+#include "model/metrics/metrics.hpp"
 
 #include "init.hpp"
 #include "utils.hpp"
@@ -42,9 +43,10 @@ namespace GRPCServer
 
 void AuthInterceptor::Intercept(grpc::experimental::InterceptorBatchMethods *methods)
 {
-    spdlog::debug("{}:{} Controller::GRPCServer::AuthInterceptor::Intercept",
+    FF_DEBUG("{}:{} Controller::GRPCServer::AuthInterceptor::Intercept",
         LOG_FILE_PATH(__FILE__), __LINE__);
     
+    u64 retryAfter(0);
     if (methods->QueryInterceptionHookPoint(
             grpc::experimental::InterceptionHookPoints::PRE_RECV_INITIAL_METADATA))
     {
@@ -63,34 +65,68 @@ void AuthInterceptor::Intercept(grpc::experimental::InterceptorBatchMethods *met
             return;
         }
 
+        // all local peers have one address, so one of them must not ban
+        // or throttle the others, the socket file mode guards them instead
         std::string clientIp = Utils::getIPFromContext(ctx);
+        bool isLocal = Utils::isLocalPeer(ctx);
+        u32 cost = rateLimiter.costOf(methodName);
         if (SHOULD_NOT_CHECK_TOKEN(methodName))
         {
-            if (auth->cannotAccess(clientIp))
+            // login still bans the user after "max retry" failures
+            if (!isLocal)
             {
-                spdlog::error("{}:{} cannot access",
-                    LOG_FILE_PATH(__FILE__), __LINE__);
-                goto error;
+                retryAfter = rateLimiter.acquire(clientIp, cost);
+                if (retryAfter)
+                {
+                    goto throttled;
+                }
+
+                if (auth->cannotAccess(clientIp))
+                {
+                    spdlog::error("{}:{} cannot access",
+                        LOG_FILE_PATH(__FILE__), __LINE__);
+                    goto error;
+                }
             }
         }
         else
         {
+            // tokens are only trusted after they are checked
+            if (!config.rateLimitBySession && !isLocal)
+            {
+                retryAfter = rateLimiter.acquire(clientIp, cost);
+                if (retryAfter)
+                {
+                    goto throttled;
+                }
+            }
+
             std::string token;
             if (Utils::getTokenFromContext(ctx, token))
             {
                 spdlog::error("{}:{} Fail to get token",
                     LOG_FILE_PATH(__FILE__), __LINE__);
                 
-                auth->addBannedIp(clientIp);
+                if (!isLocal) auth->addBannedIp(clientIp);
                 goto error;
             }
 
-            if (auth->cannotAccess(clientIp, token))
+            if (isLocal ? auth->cannotAccessByToken(token) :
+                          auth->cannotAccess(clientIp, token))
             {
                 spdlog::error("{}:{} cannot access",
                     LOG_FILE_PATH(__FILE__), __LINE__);
                 goto error;
             }
+
+            if (config.rateLimitBySession)
+            {
+                retryAfter = rateLimiter.acquire(token, cost);
+                if (retryAfter)
+                {
+                    goto throttled;
+                }
+            }
         } // if (SHOULD_NOT_CHECK_TOKEN(methodName))
     } // if (methods->QueryInterceptionHookPoint)
 
@@ -100,6 +136,16 @@ void AuthInterceptor::Intercept(grpc::experimental::InterceptorBatchMethods *met
 error:
     methods->ModifySendStatus(grpc::Status(grpc::StatusCode::UNAUTHENTICATED,
                 "Access Denied by Security Policy"));
+    return;
+
+throttled:
+    Model::Metrics::registry().counter("ff_rpc_throttled_total",
+        Model::Metrics::label("method", m_info->method()))->add();
+    // grpc clients with a retry policy honor this trailer
+    m_info->server_context()->AddTrailingMetadata("grpc-retry-pushback-ms",
+        std::to_string(retryAfter));
+    methods->ModifySendStatus(grpc::Status(grpc::StatusCode::RESOURCE_EXHAUSTED,
+        fmt::format("Too many requests, retry after {} ms", retryAfter)));
 } // void AuthInterceptor::Intercept(grpc::experimental::InterceptorBatchMethods *methods)
 
 } // end namespace GRPCServer
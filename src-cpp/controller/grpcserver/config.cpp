@@ -21,6 +21,7 @@
  * SOFTWARE.
  */
 
+#include <map>
 #include <vector>
 #ifdef _WIN32
 #include "direct.h"
@@ -34,6 +35,11 @@
 
 #include "model/auth/simple/auth.hpp"
 #include "model/auth/crypto.hpp"
+#ifdef __linux__
+#include "model/proc/cgroup.hpp"
+#endif
+#include "model/sched/estimator.hpp"
+#include "model/sched/scheduler.hpp"
 #include "model/utils.hpp"
 #include "init.hpp"
 
@@ -53,7 +59,7 @@ Config::~Config()
 
 u8 Config::parse(Config *in, int argc, char **argv)
 {
-    spdlog::debug("{}:{} Config::parse", LOG_FILE_PATH(__FILE__), __LINE__);
+    FF_DEBUG("{}:{} Config::parse", LOG_FILE_PATH(__FILE__), __LINE__);
 
     if (!in)
     {
@@ -133,7 +139,7 @@ u8 Config::parse(Config *in, int argc, char **argv)
 
 uint_fast8_t Config::parse(Config *obj, const std::string &path)
 {
-    spdlog::debug("{}:{} Config::parse", LOG_FILE_PATH(__FILE__), __LINE__);
+    FF_DEBUG("{}:{} Config::parse", LOG_FILE_PATH(__FILE__), __LINE__);
 
     if (!obj)
     {
@@ -174,6 +180,136 @@ uint_fast8_t Config::parse(Config *obj, const std::string &path)
         level = config["log level"].as<u8>();
         obj->logLevel = static_cast<spdlog::level::level_enum>(level);
 
+        // optional
+        if (config["extra listen addresses"])
+        {
+            obj->extraListenAddresses =
+                config["extra listen addresses"].as<std::vector<std::string>>();
+        }
+
+        if (config["unix socket mode"])
+        {
+            std::string mode = config["unix socket mode"].as<std::string>();
+            obj->unixSocketMode = static_cast<u32>(std::stoul(mode, nullptr, 8));
+            if (obj->unixSocketMode > 0777)
+            {
+                spdlog::error("{}:{} Invalid unix socket mode: {}",
+                    LOG_FILE_PATH(__FILE__), __LINE__, mode);
+                return 1;
+            }
+        }
+
+        if (config["async log queue size"])
+        {
+            obj->asyncLogQueueSize = config["async log queue size"].as<u32>();
+        }
+
+        if (config["async log overflow"])
+        {
+            std::string policy = config["async log overflow"].as<std::string>();
+            if (policy == "block")
+            {
+                obj->asyncLogBlock = true;
+            }
+            else if (policy == "drop")
+            {
+                obj->asyncLogBlock = false;
+            }
+            else
+            {
+                spdlog::error("{}:{} Invalid async log overflow: {}",
+                    LOG_FILE_PATH(__FILE__), __LINE__, policy);
+                return 1;
+            }
+        }
+
+        if (config["debug subsystems"])
+        {
+            auto subsystems =
+                config["debug subsystems"].as<std::vector<std::string>>();
+            if (Model::Utils::setDebugSubsystems(subsystems))
+            {
+                spdlog::error("{}:{} Invalid debug subsystems", LOG_FILE_PATH(__FILE__), __LINE__);
+                return 1;
+            }
+        }
+
+        if (config["metrics port"])
+        {
+            obj->metricsPort = config["metrics port"].as<u16>();
+        }
+
+        if (config["metrics ip"])
+        {
+            obj->metricsIP = config["metrics ip"].as<std::string>();
+            if (Model::Utils::verifyIP(obj->metricsIP))
+            {
+                spdlog::error("{}:{} Invalid metrics ip", LOG_FILE_PATH(__FILE__), __LINE__);
+                return 1;
+            }
+        }
+
+        if (config["rate limit"] && parseRateLimit(obj, config))
+        {
+            spdlog::error("{}:{} fail to parse rate limit config",
+                LOG_FILE_PATH(__FILE__), __LINE__);
+            return 1;
+        }
+
+        if (config["federation"] && parseFederation(obj, config))
+        {
+            spdlog::error("{}:{} fail to parse federation config",
+                LOG_FILE_PATH(__FILE__), __LINE__);
+            return 1;
+        }
+
+        if (config["queue groups"] && parseQueueGroups(obj, config))
+        {
+            spdlog::error("{}:{} fail to parse queue groups config",
+                LOG_FILE_PATH(__FILE__), __LINE__);
+            return 1;
+        }
+
+        if (config["scheduler"] && parseScheduler(config))
+        {
+            spdlog::error("{}:{} fail to parse scheduler config",
+                LOG_FILE_PATH(__FILE__), __LINE__);
+            return 1;
+        }
+
+        if (config["shortest job first"])
+        {
+            YAML::Node sjf = config["shortest job first"];
+            Model::Sched::estimator().configure(
+                sjf["queues"].as<std::vector<std::string>>(),
+                sjf["aging"] ? sjf["aging"].as<f64>() : 0.1);
+        }
+
+        if (config["queue timeouts"] && parseQueueTimeouts(obj, config))
+        {
+            spdlog::error("{}:{} fail to parse queue timeouts config",
+                LOG_FILE_PATH(__FILE__), __LINE__);
+            return 1;
+        }
+
+        if (config["cgroup"] && parseCgroup(config))
+        {
+            spdlog::error("{}:{} fail to parse cgroup config",
+                LOG_FILE_PATH(__FILE__), __LINE__);
+            return 1;
+        }
+
+        if (config["worker lease ms"])
+        {
+            obj->workerLeaseMs = config["worker lease ms"].as<u32>();
+            if (obj->workerLeaseMs < 1000)
+            {
+                spdlog::error("{}:{} worker lease ms must be at least 1000",
+                    LOG_FILE_PATH(__FILE__), __LINE__);
+                return 1;
+            }
+        }
+
         if (parseAuth(config, path))
         {
             spdlog::error("{}:{} fail to parse auth config",
@@ -201,8 +337,8 @@ void Config::printVersion()
 
 u8 Config::parseAuth(YAML::Node &config, const std::string &path)
 {
-    spdlog::debug("{}:{} Config::parseAuth", LOG_FILE_PATH(__FILE__), __LINE__);
-    spdlog::debug("{}:{} path: {}", LOG_FILE_PATH(__FILE__), __LINE__, path);
+    FF_DEBUG("{}:{} Config::parseAuth", LOG_FILE_PATH(__FILE__), __LINE__);
+    FF_DEBUG("{}:{} path: {}", LOG_FILE_PATH(__FILE__), __LINE__, path);
 
     YAML::Node authConfig = config["auth"];
     auto simpleAuth =
@@ -303,6 +439,80 @@ u8 Config::parseAuth(YAML::Node &config, const std::string &path)
     simpleAuth->maxRetry = authConfig["max retry"].as<u8>();
     simpleAuth->tokenTimeout = authConfig["token timeout"].as<u64>();
 
+    if (authConfig["ban table size"])
+    {
+        simpleAuth->ipBans.setCapacity(authConfig["ban table size"].as<u64>());
+    }
+
+    u64 kdfWorkers = 2;
+    u64 kdfQueueSize = 8;
+    if (authConfig["kdf workers"])
+    {
+        kdfWorkers = authConfig["kdf workers"].as<u64>();
+    }
+
+    if (authConfig["kdf queue size"])
+    {
+        kdfQueueSize = authConfig["kdf queue size"].as<u64>();
+    }
+
+    if (simpleAuth->kdfPool.start(kdfWorkers, kdfQueueSize))
+    {
+        spdlog::error("{}:{} fail to start kdf pool",
+            LOG_FILE_PATH(__FILE__), __LINE__);
+        return 1;
+    }
+
+    std::string tokenFormat = "session";
+    if (authConfig["token format"])
+    {
+        tokenFormat = authConfig["token format"].as<std::string>();
+    }
+
+    if (tokenFormat == "signed")
+    {
+        std::string tokenKey;
+        if (authConfig["token key"])
+        {
+            tokenKey = authConfig["token key"].as<std::string>();
+        }
+
+        std::vector<u8> key;
+        if (tokenKey.empty())
+        {
+            needWriteBack = true;
+
+            // generate 256bits key
+            key = std::vector<u8>(32);
+            if (RAND_bytes(key.data(), key.size()) != 1)
+            {
+                spdlog::error("{}:{} OpenSSL RAND_bytes failed",
+                    LOG_FILE_PATH(__FILE__), __LINE__);
+                return 1;
+            }
+
+            Model::Auth::Crypto::encodeBase64(key, tokenKey);
+            authConfig["token key"] = tokenKey;
+        }
+        else
+        {
+            Model::Auth::Crypto::decodeBase64(tokenKey, key);
+        }
+
+        if (simpleAuth->signedToken.setKey(key))
+        {
+            spdlog::error("{}:{} token key is too short or invalid token key",
+                LOG_FILE_PATH(__FILE__), __LINE__);
+            return 1;
+        }
+    }
+    else if (tokenFormat != "session")
+    {
+        spdlog::error("{}:{} invalid token format: {}",
+            LOG_FILE_PATH(__FILE__), __LINE__, tokenFormat);
+        return 1;
+    }
+
     if (needWriteBack)
     {
         // write entire yaml back into file
@@ -322,6 +532,226 @@ u8 Config::parseAuth(YAML::Node &config, const std::string &path)
     return 0;
 }
 
+u8 Config::parseRateLimit(Config *obj, YAML::Node &config)
+{
+    FF_DEBUG("{}:{} Config::parseRateLimit", LOG_FILE_PATH(__FILE__), __LINE__);
+
+    YAML::Node limitConfig = config["rate limit"];
+    f64 rate = limitConfig["rate"].as<f64>();
+    u32 burst = limitConfig["burst"].as<u32>();
+    if (rateLimiter.setLimit(rate, burst))
+    {
+        spdlog::error("{}:{} invalid rate or burst", LOG_FILE_PATH(__FILE__), __LINE__);
+        return 1;
+    }
+
+    if (limitConfig["key"])
+    {
+        std::string key = limitConfig["key"].as<std::string>();
+        if (key == "session")
+        {
+            obj->rateLimitBySession = true;
+        }
+        else if (key != "ip")
+        {
+            spdlog::error("{}:{} Invalid rate limit key: {}",
+                LOG_FILE_PATH(__FILE__), __LINE__, key);
+            return 1;
+        }
+    }
+
+    if (limitConfig["costs"])
+    {
+        auto costs = limitConfig["costs"].as<std::map<std::string, u32>>();
+        for (auto it = costs.begin(); it != costs.end(); ++it)
+        {
+            rateLimiter.setCost(it->first, it->second);
+        }
+    }
+
+    return 0;
+}
+
+u8 Config::parseFederation(Config *obj, YAML::Node &config)
+{
+    FF_DEBUG("{}:{} Config::parseFederation", LOG_FILE_PATH(__FILE__), __LINE__);
+
+    YAML::Node servers = config["federation"];
+    if (!servers.IsSequence())
+    {
+        spdlog::error("{}:{} federation must be a list", LOG_FILE_PATH(__FILE__), __LINE__);
+        return 1;
+    }
+
+    obj->federation.clear();
+    for (auto it = servers.begin(); it != servers.end(); ++it)
+    {
+        Global::RemoteServer server;
+        server.host = (*it)["host"].as<std::string>();
+        server.port = (*it)["port"].as<u16>();
+        server.username = (*it)["username"].as<std::string>();
+        server.password = (*it)["password"].as<std::string>();
+        server.totpKey = (*it)["totp key"].as<std::string>();
+        obj->federation.push_back(server);
+    }
+
+    return 0;
+}
+
+u8 Config::parseQueueGroups(Config *obj, YAML::Node &config)
+{
+    FF_DEBUG("{}:{} Config::parseQueueGroups", LOG_FILE_PATH(__FILE__), __LINE__);
+
+    YAML::Node groups = config["queue groups"];
+    if (!groups.IsMap())
+    {
+        spdlog::error("{}:{} queue groups must be a map", LOG_FILE_PATH(__FILE__), __LINE__);
+        return 1;
+    }
+
+    obj->queueGroups.clear();
+    for (auto it = groups.begin(); it != groups.end(); ++it)
+    {
+        obj->queueGroups[it->first.as<std::string>()] =
+            it->second.as<std::vector<std::string>>();
+    }
+
+    return 0;
+}
+
+u8 Config::parseQueueTimeouts(Config *obj, YAML::Node &config)
+{
+    FF_DEBUG("{}:{} Config::parseQueueTimeouts", LOG_FILE_PATH(__FILE__), __LINE__);
+
+    YAML::Node queues = config["queue timeouts"];
+    if (!queues.IsMap())
+    {
+        spdlog::error("{}:{} queue timeouts must be a map", LOG_FILE_PATH(__FILE__), __LINE__);
+        return 1;
+    }
+
+    obj->queueTimeouts.clear();
+    for (auto it = queues.begin(); it != queues.end(); ++it)
+    {
+        TaskTimeouts timeouts;
+        if (it->second["wall sec"])
+        {
+            timeouts.wallSec = it->second["wall sec"].as<u32>();
+        }
+
+        if (it->second["cpu sec"])
+        {
+            timeouts.cpuSec = it->second["cpu sec"].as<u32>();
+        }
+
+        obj->queueTimeouts[it->first.as<std::string>()] = timeouts;
+    }
+
+    return 0;
+}
+
+u8 Config::parseCgroup(YAML::Node &config)
+{
+    FF_DEBUG("{}:{} Config::parseCgroup", LOG_FILE_PATH(__FILE__), __LINE__);
+
+#ifdef __linux__
+    YAML::Node cgroup = config["cgroup"];
+    std::map<std::string, Model::Proc::Cgroup::Limits> limits;
+    if (cgroup["queues"])
+    {
+        YAML::Node queues = cgroup["queues"];
+        for (auto it = queues.begin(); it != queues.end(); ++it)
+        {
+            Model::Proc::Cgroup::Limits limit;
+            if (it->second["cpu max"])
+            {
+                limit.cpuMax = it->second["cpu max"].as<std::string>();
+            }
+
+            if (it->second["memory max"])
+            {
+                limit.memoryMax = it->second["memory max"].as<std::string>();
+            }
+
+            if (it->second["io max"])
+            {
+                limit.ioMax = it->second["io max"].as<std::string>();
+            }
+
+            limits[it->first.as<std::string>()] = limit;
+        }
+    }
+
+    return Model::Proc::Cgroup::configure(cgroup["root"].as<std::string>(), limits);
+#else
+    UNUSED(config);
+    spdlog::error("{}:{} cgroup is only supported on Linux",
+        LOG_FILE_PATH(__FILE__), __LINE__);
+    return 1;
+#endif
+}
+
+u8 Config::parseScheduler(YAML::Node &config)
+{
+    FF_DEBUG("{}:{} Config::parseScheduler", LOG_FILE_PATH(__FILE__), __LINE__);
+
+    YAML::Node schedConfig = config["scheduler"];
+    u32 cpuSlots(0);
+    u64 memoryMB(0);
+    std::map<std::string, u32> weights;
+    if (schedConfig["cpu slots"])
+    {
+        cpuSlots = schedConfig["cpu slots"].as<u32>();
+    }
+
+    if (schedConfig["memory mb"])
+    {
+        memoryMB = schedConfig["memory mb"].as<u64>();
+    }
+
+    if (schedConfig["queue weights"])
+    {
+        weights = schedConfig["queue weights"].as<std::map<std::string, u32>>();
+        for (auto it = weights.begin(); it != weights.end(); ++it)
+        {
+            if (!it->second)
+            {
+                spdlog::error("{}:{} weight of queue \"{}\" must be positive",
+                    LOG_FILE_PATH(__FILE__), __LINE__, it->first);
+                return 1;
+            }
+        }
+    }
+
+    Model::Sched::Pressure::Thresholds thresholds;
+    if (schedConfig["pressure"])
+    {
+        YAML::Node pressure = schedConfig["pressure"];
+        if (pressure["cpu"]) thresholds.cpu = pressure["cpu"].as<f64>();
+        if (pressure["memory"]) thresholds.memory = pressure["memory"].as<f64>();
+        if (pressure["io"]) thresholds.io = pressure["io"].as<f64>();
+        if (pressure["load"]) thresholds.load = pressure["load"].as<f64>();
+        if (pressure["sample ms"])
+        {
+            thresholds.sampleMs = pressure["sample ms"].as<u32>();
+            if (thresholds.sampleMs < 100)
+            {
+                spdlog::error("{}:{} sample ms must be at least 100",
+                    LOG_FILE_PATH(__FILE__), __LINE__);
+                return 1;
+            }
+        }
+    }
+
+    Model::Sched::scheduler().configure(cpuSlots, memoryMB, weights);
+    Model::Sched::scheduler().setPressure(thresholds);
+    if (schedConfig["preemption"])
+    {
+        Model::Sched::scheduler().setPreemption(schedConfig["preemption"].as<bool>());
+    }
+    return 0;
+}
+
 } // end namespace GRPCServer
 
 } // end namespace Model
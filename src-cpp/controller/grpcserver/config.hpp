@@ -24,11 +24,14 @@
 #ifndef _CONTROLLER_GRPCSERVER_CONFIG_HPP_
 #define _CONTROLLER_GRPCSERVER_CONFIG_HPP_
 
+#include <map>
 #include <string>
+#include <vector>
 
 #include "spdlog/common.h"
 #include "yaml-cpp/yaml.h"
 
+#include "controller/global/global.hpp"
 #include "model/defines.h"
 
 namespace Controller
@@ -41,6 +44,13 @@ class Config
 {
 public:
 
+    typedef struct TaskTimeouts
+    {
+        // 0 means no limit
+        u32 wallSec = 0;
+        u32 cpuSec = 0;
+    } TaskTimeouts;
+
     Config();
 
     ~Config();
@@ -57,13 +67,56 @@ public:
 
     std::string listenIP = "127.0.0.1";
 
+    // e.g. "unix:/run/flexflow.sock" or "0.0.0.0:12346"
+    std::vector<std::string> extraListenAddresses;
+
+    u32 unixSocketMode = 0660;
+
     i32 logLevel = static_cast<i32>(spdlog::level::level_enum::info);
 
+    // 0 means synchronous logging
+    u32 asyncLogQueueSize = 0;
+
+    // block the caller or drop the oldest message when the queue is full
+    bool asyncLogBlock = true;
+
+    // 0 means the Prometheus endpoint is disabled
+    u16 metricsPort = 0;
+
+    std::string metricsIP = "127.0.0.1";
+
+    // key the rate limit by session token instead of client ip
+    bool rateLimitBySession = false;
+
+    // serve the queues of these servers instead of the local database
+    std::vector<Global::RemoteServer> federation;
+
+    // remote workers must send a heartbeat within this time
+    u32 workerLeaseMs = 30000;
+
+    // group name to the names of its queues
+    std::map<std::string, std::vector<std::string>> queueGroups;
+
+    // queue name to the default limits of its tasks
+    std::map<std::string, TaskTimeouts> queueTimeouts;
+
 private:
 
     static void printVersion();
 
     static u8 parseAuth(YAML::Node &, const std::string &path);
+
+    static u8 parseRateLimit(Config *, YAML::Node &);
+
+    static u8 parseFederation(Config *, YAML::Node &);
+
+    static u8 parseQueueGroups(Config *, YAML::Node &);
+
+    static u8 parseScheduler(YAML::Node &);
+
+    static u8 parseQueueTimeouts(Config *, YAML::Node &);
+
+    static u8 parseCgroup(YAML::Node &);
 };
 
 } // end namespace GRPCServer
@@ -45,9 +45,11 @@ Model::DAO::IQueueList *queueList = nullptr;
 
 Model::Auth::IAuth *auth = nullptr;
 
+Model::Auth::RateLimiter rateLimiter;
+
 u8 init(int argc, char **argv)
 {
-    spdlog::debug("{}:{} init", LOG_FILE_PATH(__FILE__), __LINE__);
+    FF_DEBUG("{}:{} init", LOG_FILE_PATH(__FILE__), __LINE__);
 
     if (Global::consoleInit())
     {
@@ -76,7 +78,17 @@ u8 init(int argc, char **argv)
         return 1;
     }
 
-    if (Controller::Global::sqliteInit(&queueList, config.dbPath))
+    if (!config.federation.empty())
+    {
+        if (Controller::Global::federationInit(&queueList, config.federation))
+        {
+            spdlog::error("{}:{} Fail to initialize federation queue list",
+                LOG_FILE_PATH(__FILE__), __LINE__);
+            return 1;
+        }
+    }
+    else if (Controller::Global::sqliteInit(&queueList, config.dbPath,
+                                            config.queueGroups))
     {
         spdlog::error("{}:{} Fail to initialize sqlite queue list",
             LOG_FILE_PATH(__FILE__), __LINE__);
@@ -90,7 +102,8 @@ u8 init(int argc, char **argv)
     }
     else
     {
-        ret = Global::spdlogInit(config.logPath + "/STQLog.log", config.logLevel);
+        ret = Global::spdlogInit(config.logPath + "/STQLog.log", config.logLevel,
+                                 config.asyncLogQueueSize, config.asyncLogBlock);
     }
 
     if (ret)
@@ -106,10 +119,24 @@ u8 init(int argc, char **argv)
 
 void fin()
 {
-    spdlog::debug("{}:{} fin", LOG_FILE_PATH(__FILE__), __LINE__);
+    FF_DEBUG("{}:{} fin", LOG_FILE_PATH(__FILE__), __LINE__);
     Global::consoleFin();
+    if (queueList && config.federation.empty())
+    {
+        // signal every task first, so their grace times run in parallel,
+        // the remote queues of a federation keep running
+        std::vector<std::string> names;
+        UNUSED(queueList->listQueue(names));
+        for (auto it = names.begin(); it != names.end(); ++it)
+        {
+            auto queue = queueList->getQueue(*it);
+            if (queue) queue->stop();
+        }
+    }
+
     if (queueList) delete queueList;
     if (auth) delete auth;
+    Global::spdlogFin();
 }
 
 } // end namespace GRPCServer
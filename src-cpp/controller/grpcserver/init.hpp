@@ -30,6 +30,7 @@
 
 #include "controller/grpcserver/server.hpp"
 #include "model/auth/iauth.hpp"
+#include "model/auth/ratelimiter.hpp"
 #include "model/dao/iqueuelist.hpp"
 
 namespace Controller
@@ -46,6 +47,8 @@ extern Model::DAO::IQueueList *queueList;
 
 extern Model::Auth::IAuth *auth;
 
+extern Model::Auth::RateLimiter rateLimiter;
+
 u8 init(int argc, char **argv);
 
 void fin();
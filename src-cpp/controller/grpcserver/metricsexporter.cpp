@@ -0,0 +1,216 @@
+/*
+ * Flex Flow
+ * Copyright (c) 2026-present fdar0536
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include <cstring>
+
+#ifdef _WIN32
+#include "ws2tcpip.h"
+#define poll WSAPoll
+#else
+#include "arpa/inet.h"
+#include "netinet/in.h"
+#include "poll.h"
+#include "sys/socket.h"
+#include "unistd.h"
+#define INVALID_SOCKET -1
+#endif
+
+#include "spdlog/spdlog.h"
+
+#include "model/metrics/metrics.hpp"
+#include "model/utils.hpp"
+
+#include "metricsexporter.hpp"
+
+namespace Controller
+{
+
+namespace GRPCServer
+{
+
+MetricsExporter::MetricsExporter() :
+    m_fd(INVALID_SOCKET)
+{}
+
+MetricsExporter::~MetricsExporter()
+{
+    stop();
+}
+
+u8 MetricsExporter::start(const std::string &ip, u16 port)
+{
+    FF_DEBUG("{}:{} MetricsExporter::start", LOG_FILE_PATH(__FILE__), __LINE__);
+
+    sockaddr_in addr;
+    memset(&addr, 0, sizeof(addr));
+    addr.sin_family = AF_INET;
+    addr.sin_port = htons(port);
+    if (inet_pton(AF_INET, ip.c_str(), &addr.sin_addr) != 1)
+    {
+        spdlog::error("{}:{} Invalid ip: {}", LOG_FILE_PATH(__FILE__), __LINE__, ip);
+        return 1;
+    }
+
+    m_fd = socket(AF_INET, SOCK_STREAM, 0);
+    if (m_fd == INVALID_SOCKET)
+    {
+        spdlog::error("{}:{} Fail to create socket", LOG_FILE_PATH(__FILE__), __LINE__);
+        return 1;
+    }
+
+    int reuse(1);
+    setsockopt(m_fd, SOL_SOCKET, SO_REUSEADDR,
+               reinterpret_cast<const char *>(&reuse), sizeof(reuse));
+
+    if (bind(m_fd, reinterpret_cast<sockaddr *>(&addr), sizeof(addr)) ||
+        listen(m_fd, 16))
+    {
+        spdlog::error("{}:{} Fail to listen on {}:{}",
+            LOG_FILE_PATH(__FILE__), __LINE__, ip, port);
+        closeSocket(m_fd);
+        m_fd = INVALID_SOCKET;
+        return 1;
+    }
+
+    m_thread = std::jthread([this](std::stop_token token)
+    {
+        serveLoop(token);
+    });
+    spdlog::info("{}:{} Metrics are exported on http://{}:{}/metrics",
+        LOG_FILE_PATH(__FILE__), __LINE__, ip, port);
+    return 0;
+}
+
+void MetricsExporter::stop()
+{
+    if (m_thread.joinable())
+    {
+        m_thread.request_stop();
+        m_thread.join();
+    }
+
+    if (m_fd != INVALID_SOCKET)
+    {
+        closeSocket(m_fd);
+        m_fd = INVALID_SOCKET;
+    }
+}
+
+// private member functions
+void MetricsExporter::serveLoop(std::stop_token token)
+{
+    FF_DEBUG("{}:{} MetricsExporter::serveLoop", LOG_FILE_PATH(__FILE__), __LINE__);
+
+    pollfd pfd;
+    pfd.fd = m_fd;
+    pfd.events = POLLIN;
+    while (!token.stop_requested())
+    {
+        // wake up periodically to check whether we should stop
+        pfd.revents = 0;
+        int ret = poll(&pfd, 1, 500);
+        if (ret <= 0)
+        {
+            continue;
+        }
+
+        Socket client = accept(m_fd, nullptr, nullptr);
+        if (client == INVALID_SOCKET)
+        {
+            continue;
+        }
+
+        handleClient(client);
+        closeSocket(client);
+    }
+}
+
+void MetricsExporter::handleClient(Socket fd)
+{
+    FF_DEBUG("{}:{} MetricsExporter::handleClient", LOG_FILE_PATH(__FILE__), __LINE__);
+
+    // only the request line matters, ignore the rest of the request
+    pollfd pfd;
+    pfd.fd = fd;
+    pfd.events = POLLIN;
+    pfd.revents = 0;
+    if (poll(&pfd, 1, 1000) <= 0)
+    {
+        return;
+    }
+
+    char buf[1024];
+    int count = static_cast<int>(recv(fd, buf, sizeof(buf) - 1, 0));
+    if (count <= 0)
+    {
+        return;
+    }
+
+    buf[count] = '\0';
+    std::string status;
+    std::string body;
+    if (!strncmp(buf, "GET /metrics ", 13) || !strncmp(buf, "GET / ", 6))
+    {
+        status = "200 OK";
+        body = Model::Metrics::registry().toPrometheus();
+    }
+    else
+    {
+        status = "404 Not Found";
+        body = "Not Found\n";
+    }
+
+    std::string response = fmt::format(
+        "HTTP/1.1 {}\r\n"
+        "Content-Type: text/plain; version=0.0.4\r\n"
+        "Content-Length: {}\r\n"
+        "Connection: close\r\n\r\n{}",
+        status, body.size(), body);
+
+    size_t sent(0);
+    while (sent < response.size())
+    {
+        int ret = static_cast<int>(send(fd, response.data() + sent,
+                                        static_cast<int>(response.size() - sent), 0));
+        if (ret <= 0)
+        {
+            spdlog::warn("{}:{} Fail to send metrics", LOG_FILE_PATH(__FILE__), __LINE__);
+            return;
+        }
+
+        sent += static_cast<size_t>(ret);
+    }
+}
+
+void MetricsExporter::closeSocket(Socket fd)
+{
+#ifdef _WIN32
+    closesocket(fd);
+#else
+    close(fd);
+#endif
+}
+
+} // end namespace GRPCServer
+
+} // end namespace Controller
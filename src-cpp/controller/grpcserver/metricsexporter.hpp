@@ -0,0 +1,81 @@
+/*
+ * Flex Flow
+ * Copyright (c) 2026-present fdar0536
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#ifndef _CONTROLLER_GRPCSERVER_METRICSEXPORTER_HPP_
+#define _CONTROLLER_GRPCSERVER_METRICSEXPORTER_HPP_
+
+#include <string>
+#include <thread>
+
+#ifdef _WIN32
+#include "winsock2.h"
+#endif
+
+#include "model/defines.h"
+
+namespace Controller
+{
+
+namespace GRPCServer
+{
+
+/**
+ * @brief serve the metrics in the Prometheus text format over plain http
+ */
+class MetricsExporter
+{
+public:
+
+#ifdef _WIN32
+    typedef SOCKET Socket;
+#else
+    typedef int Socket;
+#endif
+
+    MetricsExporter();
+
+    ~MetricsExporter();
+
+    u8 start(const std::string &ip, u16 port);
+
+    void stop();
+
+private:
+
+    Socket m_fd;
+
+    std::jthread m_thread;
+
+    void serveLoop(std::stop_token token);
+
+    void handleClient(Socket fd);
+
+    void closeSocket(Socket fd);
+
+}; // end class MetricsExporter
+
+} // end namespace GRPCServer
+
+} // end namespace Controller
+
+#endif // _CONTROLLER_GRPCSERVER_METRICSEXPORTER_HPP_
@@ -0,0 +1,92 @@
+/*
+ * Flex Flow
+ * Copyright (c) 2026-present fdar0536
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include "spdlog/spdlog.h"
+
+#include "model/metrics/metrics.hpp"
+#include "model/utils.hpp"
+
+#include "metricsimpl.hpp"
+
+namespace Controller
+{
+
+namespace GRPCServer
+{
+
+grpc::Status MetricsImpl::GetMetrics(grpc::ServerContext *ctx,
+                                     const ff::Empty *req,
+                                     ff::MetricsRes *res)
+{
+    FF_DEBUG("{}:{} MetricsImpl::GetMetrics", LOG_FILE_PATH(__FILE__), __LINE__);
+
+    UNUSED(ctx);
+    UNUSED(req);
+    if (!res)
+    {
+        spdlog::error("{}:{} invalid input", LOG_FILE_PATH(__FILE__), __LINE__);
+        return grpc::Status(grpc::StatusCode::INTERNAL, "Invalid input");
+    }
+
+    auto families = Model::Metrics::registry().load();
+    for (auto it = families->counters.begin();
+         it != families->counters.end();
+         ++it)
+    {
+        ff::CounterValue *value = res->add_counters();
+        value->set_name(it->first.first);
+        value->set_labels(it->first.second);
+        value->set_value(it->second->value());
+    }
+
+    for (auto it = families->gauges.begin();
+         it != families->gauges.end();
+         ++it)
+    {
+        ff::GaugeValue *value = res->add_gauges();
+        value->set_name(it->first.first);
+        value->set_labels(it->first.second);
+        value->set_value(it->second->value());
+    }
+
+    for (auto it = families->histograms.begin();
+         it != families->histograms.end();
+         ++it)
+    {
+        ff::HistogramValue *value = res->add_histograms();
+        value->set_name(it->first.first);
+        value->set_labels(it->first.second);
+        value->set_count(it->second->count());
+        value->set_sumus(it->second->sum());
+        value->set_maxus(it->second->max());
+        value->set_p50us(it->second->percentile(0.5));
+        value->set_p90us(it->second->percentile(0.9));
+        value->set_p99us(it->second->percentile(0.99));
+    }
+
+    return grpc::Status::OK;
+}
+
+} // end namespace GRPCServer
+
+} // end namespace Controller
@@ -0,0 +1,62 @@
+/*
+ * Flex Flow
+ * Copyright (c) 2026-present fdar0536
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include "spdlog/spdlog.h"
+
+#include "model/metrics/metrics.hpp"
+#include "model/utils.hpp"
+
+#include "metricsinterceptor.hpp"
+
+namespace Controller
+{
+
+namespace GRPCServer
+{
+
+MetricsInterceptor::MetricsInterceptor(grpc::experimental::ServerRpcInfo *info) :
+    m_info(info),
+    m_start(std::chrono::steady_clock::now())
+{}
+
+void MetricsInterceptor::Intercept(grpc::experimental::InterceptorBatchMethods *methods)
+{
+    if (methods->QueryInterceptionHookPoint(
+            grpc::experimental::InterceptionHookPoints::PRE_SEND_STATUS))
+    {
+        std::string labels = Model::Metrics::label("method", m_info->method());
+        Model::Metrics::registry().histogram("ff_rpc_duration", labels)
+            ->record(Model::Metrics::elapsedUs(m_start));
+
+        if (!methods->GetSendStatus().ok())
+        {
+            Model::Metrics::registry().counter("ff_rpc_errors_total", labels)->add();
+        }
+    }
+
+    methods->Proceed();
+} // void MetricsInterceptor::Intercept(grpc::experimental::InterceptorBatchMethods *methods)
+
+} // end namespace GRPCServer
+
+} // end namespace Controller
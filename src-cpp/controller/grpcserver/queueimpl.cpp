@@ -37,12 +37,39 @@ namespace Controller
 namespace GRPCServer
 {
 
+static void addFinishedGeneration(grpc::ServerContext *ctx,
+                                  const u64 epoch,
+                                  const u64 version)
+{
+    ctx->AddTrailingMetadata("x-ff-finished-epoch", std::to_string(epoch));
+    ctx->AddTrailingMetadata("x-ff-finished-version", std::to_string(version));
+}
+
+// the client has this generation of the finished list already
+static bool isNotModified(grpc::ServerContext *ctx,
+                          const u64 epoch,
+                          const u64 version)
+{
+    auto &metadata = ctx->client_metadata();
+    auto epochIt = metadata.find("x-ff-if-epoch");
+    auto versionIt = metadata.find("x-ff-if-version");
+    if (epochIt == metadata.end() || versionIt == metadata.end())
+    {
+        return false;
+    }
+
+    return std::string(epochIt->second.data(), epochIt->second.length()) ==
+               std::to_string(epoch) &&
+           std::string(versionIt->second.data(), versionIt->second.length()) ==
+               std::to_string(version);
+}
+
 grpc::Status
 QueueImpl::ListPending(grpc::ServerContext *ctx,
                        const ff::QueueReq *req,
                        grpc::ServerWriter<ff::ListTaskRes> *writer)
 {
-    spdlog::debug("{}:{} QueueImpl::ListPending", LOG_FILE_PATH(__FILE__), __LINE__);
+    FF_DEBUG("{}:{} QueueImpl::ListPending", LOG_FILE_PATH(__FILE__), __LINE__);
     
     UNUSED(ctx);
     if (!req || !writer)
@@ -83,11 +110,10 @@ QueueImpl::ListFinished(grpc::ServerContext *ctx,
                         const ff::QueueReq *req,
                         grpc::ServerWriter<ff::ListTaskRes> *writer)
 {
-    spdlog::debug("{}:{} QueueImpl::ListFinished",
+    FF_DEBUG("{}:{} QueueImpl::ListFinished",
         LOG_FILE_PATH(__FILE__), __LINE__);
     
-    UNUSED(ctx);
-    if (!req || !writer)
+    if (!ctx || !req || !writer)
     {
         spdlog::error("{}:{} Invalid input", LOG_FILE_PATH(__FILE__), __LINE__);
         return grpc::Status(grpc::StatusCode::INTERNAL, "Invalid input");
@@ -100,6 +126,16 @@ QueueImpl::ListFinished(grpc::ServerContext *ctx,
         return grpc::Status(grpc::StatusCode::NOT_FOUND, "Fail to get queue");
     }
 
+    // read it before listing, so a change in between is never hidden
+    u64 epoch(0), version(0);
+    queue->finishedGeneration(epoch, version);
+    addFinishedGeneration(ctx, epoch, version);
+    if (isNotModified(ctx, epoch, version))
+    {
+        ctx->AddTrailingMetadata("x-ff-not-modified", "1");
+        return grpc::Status::OK;
+    }
+
     std::vector<int> out;
     u8 code = queue->listFinished(out);
     if (code)
@@ -122,7 +158,7 @@ QueueImpl::ListFinished(grpc::ServerContext *ctx,
 static void
 buildTaskDetailsRes(Model::Proc::Task &task, ff::TaskDetailsRes *res)
 {
-    spdlog::debug("{}:{} buildTaskDetailsRes", LOG_FILE_PATH(__FILE__), __LINE__);
+    FF_DEBUG("{}:{} buildTaskDetailsRes", LOG_FILE_PATH(__FILE__), __LINE__);
     if (!res)
     {
         spdlog::error("{}:{} invalid input", LOG_FILE_PATH(__FILE__), __LINE__);
@@ -138,6 +174,25 @@ buildTaskDetailsRes(Model::Proc::Task &task, ff::TaskDetailsRes *res)
 
     res->set_exitcode(task.exitCode);
     res->set_id(task.ID);
+    res->set_cpus(task.cpus);
+    res->set_memorymb(task.memoryMB);
+    res->set_priority(task.priority);
+    res->set_suspendedms(task.suspendedMs);
+    res->set_enqueuetime(task.enqueueTime);
+    res->set_starttime(task.startTime);
+    res->set_endtime(task.endTime);
+    res->set_walltimeoutsec(task.wallTimeoutSec);
+    res->set_cputimeoutsec(task.cpuTimeoutSec);
+    res->set_istimedout(task.isTimedOut);
+    res->set_cpuusageus(task.cpuUsageUs);
+    res->set_memorypeakbytes(task.memoryPeakBytes);
+    res->set_ioreadbytes(task.ioReadBytes);
+    res->set_iowritebytes(task.ioWriteBytes);
+    res->set_usertimeus(task.userTimeUs);
+    res->set_systemtimeus(task.systemTimeUs);
+    res->set_maxrsskb(task.maxRssKB);
+    res->set_majorfaults(task.majorFaults);
+    res->set_minorfaults(task.minorFaults);
 }
 
 grpc::Status
@@ -145,7 +200,7 @@ QueueImpl::PendingDetails(grpc::ServerContext *ctx,
                           const ff::TaskDetailsReq *req,
                           ff::TaskDetailsRes *res)
 {
-    spdlog::debug("{}:{} QueueImpl::PendingDetails",
+    FF_DEBUG("{}:{} QueueImpl::PendingDetails",
         LOG_FILE_PATH(__FILE__), __LINE__);
 
     UNUSED(ctx);
@@ -181,11 +236,10 @@ QueueImpl::FinishedDetails(grpc::ServerContext *ctx,
                            const ff::TaskDetailsReq *req,
                            ff::TaskDetailsRes *res)
 {
-    spdlog::debug("{}:{} QueueImpl::FinishedDetails",
+    FF_DEBUG("{}:{} QueueImpl::FinishedDetails",
         LOG_FILE_PATH(__FILE__), __LINE__);
 
-    UNUSED(ctx);
-    if (!req || !res)
+    if (!ctx || !req || !res)
     {
         spdlog::error("{}:{} invalid input", LOG_FILE_PATH(__FILE__), __LINE__);
         return grpc::Status(grpc::StatusCode::INTERNAL, "Invalid input");
@@ -199,6 +253,10 @@ QueueImpl::FinishedDetails(grpc::ServerContext *ctx,
             "Fail to get queue");
     }
 
+    u64 epoch(0), version(0);
+    queue->finishedGeneration(epoch, version);
+    addFinishedGeneration(ctx, epoch, version);
+
     Model::Proc::Task out;
     u8 code = queue->finishedDetails(req->id(), out);
     if (code)
@@ -217,7 +275,7 @@ QueueImpl::ClearPending(grpc::ServerContext *ctx,
                         const ff::QueueReq *req,
                         ff::Empty *res)
 {
-    spdlog::debug("{}:{} QueueImpl::ClearPending", LOG_FILE_PATH(__FILE__), __LINE__);
+    FF_DEBUG("{}:{} QueueImpl::ClearPending", LOG_FILE_PATH(__FILE__), __LINE__);
 
     UNUSED(ctx);
     UNUSED(res);
@@ -249,7 +307,7 @@ QueueImpl::ClearFinished(grpc::ServerContext *ctx,
                          const ff::QueueReq *req,
                          ff::Empty *res)
 {
-    spdlog::debug("{}:{} QueueImpl::ClearFinished",
+    FF_DEBUG("{}:{} QueueImpl::ClearFinished",
         LOG_FILE_PATH(__FILE__), __LINE__);
 
     UNUSED(ctx);
@@ -284,7 +342,7 @@ QueueImpl::CurrentTask(grpc::ServerContext *ctx,
                        const ff::QueueReq *req,
                        ff::TaskDetailsRes *res)
 {
-    spdlog::debug("{}:{} QueueImpl::CurrentTask", LOG_FILE_PATH(__FILE__), __LINE__);
+    FF_DEBUG("{}:{} QueueImpl::CurrentTask", LOG_FILE_PATH(__FILE__), __LINE__);
     UNUSED(ctx);
     if (!req || !res)
     {
@@ -318,7 +376,7 @@ QueueImpl::AddTask(grpc::ServerContext *ctx,
                    const ff::AddTaskReq *req,
                    ff::ListTaskRes *res)
 {
-    spdlog::debug("{}:{} QueueImpl::AddTask", LOG_FILE_PATH(__FILE__), __LINE__);
+    FF_DEBUG("{}:{} QueueImpl::AddTask", LOG_FILE_PATH(__FILE__), __LINE__);
     UNUSED(ctx);
     if (!req || !res)
     {
@@ -342,6 +400,18 @@ QueueImpl::AddTask(grpc::ServerContext *ctx,
         in.args.push_back(*it);
     }
 
+    in.cpus = req->cpus() ? req->cpus() : 1;
+    in.memoryMB = req->memorymb();
+    in.priority = req->priority();
+    in.wallTimeoutSec = req->walltimeoutsec();
+    in.cpuTimeoutSec = req->cputimeoutsec();
+    auto timeouts = config.queueTimeouts.find(req->name());
+    if (timeouts != config.queueTimeouts.end())
+    {
+        if (!in.wallTimeoutSec) in.wallTimeoutSec = timeouts->second.wallSec;
+        if (!in.cpuTimeoutSec) in.cpuTimeoutSec = timeouts->second.cpuSec;
+    }
+
     u8 code = queue->addTask(in);
     if (code)
     {
@@ -358,7 +428,7 @@ QueueImpl::RemoveTask(grpc::ServerContext *ctx,
                       const ff::TaskDetailsReq *req,
                       ff::Empty *res)
 {
-    spdlog::debug("{}:{} QueueImpl::RemoveTask", LOG_FILE_PATH(__FILE__), __LINE__);
+    FF_DEBUG("{}:{} QueueImpl::RemoveTask", LOG_FILE_PATH(__FILE__), __LINE__);
 
     UNUSED(ctx);
     UNUSED(res);
@@ -385,12 +455,44 @@ QueueImpl::RemoveTask(grpc::ServerContext *ctx,
     return grpc::Status::OK;
 }
 
+grpc::Status
+QueueImpl::Reprioritize(grpc::ServerContext *ctx,
+                        const ff::ReprioritizeReq *req,
+                        ff::Empty *res)
+{
+    FF_DEBUG("{}:{} QueueImpl::Reprioritize", LOG_FILE_PATH(__FILE__), __LINE__);
+
+    UNUSED(ctx);
+    UNUSED(res);
+    if (!req)
+    {
+        spdlog::error("{}:{} invalid input", LOG_FILE_PATH(__FILE__), __LINE__);
+        return grpc::Status(grpc::StatusCode::INTERNAL, "Invalid input");
+    }
+
+    auto queue = queueList->getQueue(req->name());
+    if (!queue)
+    {
+        spdlog::error("{}:{} Fail to get queue", LOG_FILE_PATH(__FILE__), __LINE__);
+        return grpc::Status(grpc::StatusCode::NOT_FOUND, "Fail to get queue");
+    }
+
+    u8 code = queue->reprioritize(req->id(), req->priority());
+    if (code)
+    {
+        spdlog::error("{}:{} Fail to reprioritize task", LOG_FILE_PATH(__FILE__), __LINE__);
+        return Model::ErrMsg::toGRPCStatus(code, "Fail to reprioritize task");
+    }
+
+    return grpc::Status::OK;
+}
+
 grpc::Status
 QueueImpl::IsRunning(grpc::ServerContext *ctx,
                      const ff::QueueReq *req,
                      ff::IsRunningRes *res)
 {
-    spdlog::debug("{}:{} QueueImpl::IsRunning", LOG_FILE_PATH(__FILE__), __LINE__);
+    FF_DEBUG("{}:{} QueueImpl::IsRunning", LOG_FILE_PATH(__FILE__), __LINE__);
 
     UNUSED(ctx);
     if (!req || !res)
@@ -415,7 +517,7 @@ QueueImpl::ReadCurrentOutput(grpc::ServerContext *ctx,
                              const ff::QueueReq *req,
                              grpc::ServerWriter<ff::Msg> *writer)
 {
-    spdlog::debug("{}:{} QueueImpl::ReadCurrentOutput",
+    FF_DEBUG("{}:{} QueueImpl::ReadCurrentOutput",
         LOG_FILE_PATH(__FILE__), __LINE__);
 
     UNUSED(ctx);
@@ -450,7 +552,7 @@ QueueImpl::Start(grpc::ServerContext *ctx,
                 const ff::QueueReq *req,
                 ff::Empty *res)
 {
-    spdlog::debug("{}:{} QueueImpl::Start", LOG_FILE_PATH(__FILE__), __LINE__);
+    FF_DEBUG("{}:{} QueueImpl::Start", LOG_FILE_PATH(__FILE__), __LINE__);
 
     UNUSED(ctx);
     UNUSED(res);
@@ -482,7 +584,7 @@ QueueImpl::Stop(grpc::ServerContext *ctx,
                 const ff::QueueReq *req,
                 ff::Empty *res)
 {
-    spdlog::debug("{}:{} QueueImpl::Stop", LOG_FILE_PATH(__FILE__), __LINE__);
+    FF_DEBUG("{}:{} QueueImpl::Stop", LOG_FILE_PATH(__FILE__), __LINE__);
 
     UNUSED(ctx);
     UNUSED(res);
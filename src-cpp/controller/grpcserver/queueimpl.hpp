@@ -81,6 +81,11 @@ public:
                const ff::TaskDetailsReq *req,
                ff::Empty *res) override;
 
+    grpc::Status
+    Reprioritize(grpc::ServerContext *ctx,
+                 const ff::ReprioritizeReq *req,
+                 ff::Empty *res) override;
+
     grpc::Status
     IsRunning(grpc::ServerContext *ctx,
               const ff::QueueReq *req,
@@ -41,7 +41,7 @@ QueueListImpl::Create(grpc::ServerContext *ctx,
                       const ff::QueueReq *req,
                       ff::Empty *res)
 {
-    spdlog::debug("{}:{} QueueListImpl::Create", LOG_FILE_PATH(__FILE__), __LINE__);
+    FF_DEBUG("{}:{} QueueListImpl::Create", LOG_FILE_PATH(__FILE__), __LINE__);
 
     UNUSED(ctx);
     UNUSED(res);
@@ -77,7 +77,7 @@ QueueListImpl::Rename(grpc::ServerContext *ctx,
                       const ff::RenameQueueReq *req,
                       ff::Empty *res)
 {
-    spdlog::debug("{}:{} QueueListImpl::Rename", LOG_FILE_PATH(__FILE__), __LINE__);
+    FF_DEBUG("{}:{} QueueListImpl::Rename", LOG_FILE_PATH(__FILE__), __LINE__);
 
     UNUSED(ctx);
     UNUSED(res);
@@ -111,7 +111,7 @@ QueueListImpl::Delete(grpc::ServerContext *ctx,
                       const ff::QueueReq *req,
                       ff::Empty *res)
 {
-    spdlog::debug("{}:{} QueueListImpl::Delete", LOG_FILE_PATH(__FILE__), __LINE__);
+    FF_DEBUG("{}:{} QueueListImpl::Delete", LOG_FILE_PATH(__FILE__), __LINE__);
 
     UNUSED(ctx);
     UNUSED(res);
@@ -146,7 +146,7 @@ QueueListImpl::List(grpc::ServerContext *ctx,
                     const ff::Empty *req,
                     grpc::ServerWriter<::ff::ListQueueRes> *writer)
 {
-    spdlog::debug("{}:{} QueueListImpl::List", LOG_FILE_PATH(__FILE__), __LINE__);
+    FF_DEBUG("{}:{} QueueListImpl::List", LOG_FILE_PATH(__FILE__), __LINE__);
 
     UNUSED(ctx);
     UNUSED(req);
@@ -181,7 +181,7 @@ QueueListImpl::GetQueue(grpc::ServerContext *ctx,
                         const ff::QueueReq *req,
                         ff::Empty *res)
 {
-    spdlog::debug("{}:{} QueueListImpl::GetQueue",
+    FF_DEBUG("{}:{} QueueListImpl::GetQueue",
         LOG_FILE_PATH(__FILE__), __LINE__);
 
     UNUSED(ctx);
@@ -21,6 +21,10 @@
  * SOFTWARE.
  */
 
+#ifndef _WIN32
+#include "sys/stat.h"
+#endif
+
 #include "spdlog/spdlog.h"
 #include "grpcpp/server_builder.h"
 #include "grpcpp/server.h"
@@ -30,6 +34,7 @@
 #include "model/utils.hpp"
 
 #include "authinterceptor.hpp"
+#include "metricsinterceptor.hpp"
 #include "server.hpp"
 
 namespace Controller
@@ -49,6 +54,34 @@ public:
     }
 };
 
+class MetricsInterceptorFactory :
+    public grpc::experimental::ServerInterceptorFactoryInterface
+{
+public:
+    grpc::experimental::Interceptor
+    *CreateServerInterceptor(grpc::experimental::ServerRpcInfo *info) override
+    {
+        return new MetricsInterceptor(info);
+    }
+};
+
+// accept "unix:path", "unix:/abs/path" and "unix:///abs/path"
+static bool unixSocketPath(const std::string &addr, std::string &out)
+{
+    if (addr.rfind("unix:", 0))
+    {
+        return false;
+    }
+
+    out = addr.substr(5);
+    if (out.rfind("//", 0) == 0)
+    {
+        out = out.substr(2);
+    }
+
+    return true;
+}
+
 Server::Server()
 {}
 
@@ -69,22 +102,75 @@ uint_fast8_t Server::start()
                                  grpc::InsecureServerCredentials(),
                                  &actualPort);
 
+        for (auto it = GRPCServer::config.extraListenAddresses.begin();
+             it != GRPCServer::config.extraListenAddresses.end();
+             ++it)
+        {
+            builder.AddListeningPort(*it, grpc::InsecureServerCredentials());
+        }
+
+        // clients send keepalive pings, see Connect::GRPC::ChannelOptions
+        builder.AddChannelArgument(GRPC_ARG_KEEPALIVE_PERMIT_WITHOUT_CALLS, 1);
+        builder.AddChannelArgument(
+            GRPC_ARG_HTTP2_MIN_RECV_PING_INTERVAL_WITHOUT_DATA_MS, 10000);
+
         builder.RegisterService(&m_accessImpl);
         builder.RegisterService(&m_queueImpl);
         builder.RegisterService(&m_queueListImpl);
+        builder.RegisterService(&m_metricsImpl);
+        builder.RegisterService(&m_workerImpl);
 
         std::vector<std::unique_ptr<grpc::experimental::ServerInterceptorFactoryInterface>>
             creators;
-        creators.reserve(1);
+        creators.reserve(2);
+
+        // first one, so rejected rpcs are measured as well
+        creators.push_back(std::make_unique<MetricsInterceptorFactory>());
         creators.push_back(std::make_unique<AuthInterceptorFactory>());
         builder.experimental()
             .SetInterceptorCreators(std::move(creators));
-        
+
+        // unix sockets get the process umask, they are changed to
+        // "unix socket mode" below, the umask is process wide and
+        // other threads are running, so it is not changed here
         auto server = builder.BuildAndStart();
+        if (!server)
+        {
+            spdlog::error("{}:{} Fail to start server",
+                LOG_FILE_PATH(__FILE__), __LINE__);
+            return 1;
+        }
+
         spdlog::info("{}:{} Server is listening on {}",
             LOG_FILE_PATH(__FILE__), __LINE__,
             listenAddr);
 
+        for (auto it = GRPCServer::config.extraListenAddresses.begin();
+             it != GRPCServer::config.extraListenAddresses.end();
+             ++it)
+        {
+            spdlog::info("{}:{} Server is listening on {}",
+                LOG_FILE_PATH(__FILE__), __LINE__, *it);
+
+#ifndef _WIN32
+            std::string path;
+            if (unixSocketPath(*it, path) &&
+                chmod(path.c_str(), static_cast<mode_t>(GRPCServer::config.unixSocketMode)))
+            {
+                spdlog::warn("{}:{} Fail to change mode of {}",
+                    LOG_FILE_PATH(__FILE__), __LINE__, path);
+            }
+#endif
+        }
+
+        if (GRPCServer::config.metricsPort &&
+            m_metricsExporter.start(GRPCServer::config.metricsIP,
+                                    GRPCServer::config.metricsPort))
+        {
+            spdlog::warn("{}:{} Fail to start metrics exporter",
+                LOG_FILE_PATH(__FILE__), __LINE__);
+        }
+
         auto serveFn = [&]()
         {
             server->Wait();
@@ -95,8 +181,11 @@ uint_fast8_t Server::start()
         std::unique_lock<std::mutex> lock(m_cvMutex);
         m_cv.wait(lock, [this]{ return m_done; });
 
-        server->Shutdown();
+        // worker streams never end by themselves, cancel them after a while
+        server->Shutdown(std::chrono::system_clock::now() +
+                         std::chrono::seconds(5));
         m_thread = std::jthread();
+        m_metricsExporter.stop();
     }
     catch (...)
     {
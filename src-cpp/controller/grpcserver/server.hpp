@@ -24,12 +24,17 @@
 #ifndef _CONTROLLER_GRPCSERVER_SERVER_HPP_
 #define _CONTROLLER_GRPCSERVER_SERVER_HPP_
 
+#include <condition_variable>
+#include <mutex>
 #include <thread>
 
 #include "model/defines.h"
 #include "accessimpl.hpp"
+#include "metricsexporter.hpp"
+#include "metricsimpl.hpp"
 #include "queueimpl.hpp"
 #include "queuelistimpl.hpp"
+#include "workerimpl.hpp"
 
 namespace Controller
 {
@@ -64,6 +69,12 @@ private:
     QueueImpl m_queueImpl;
 
     QueueListImpl m_queueListImpl;
+
+    MetricsImpl m_metricsImpl;
+
+    WorkerImpl m_workerImpl;
+
+    MetricsExporter m_metricsExporter;
 };
 
 } // end namespace GRPCServer
@@ -39,8 +39,11 @@ namespace Utils
 // this function is assisted by Google Gemini
 static std::string getCleanIP(const std::string& peer)
 {
-    spdlog::debug("{}:{} Utils::getCleanIP", LOG_FILE_PATH(__FILE__), __LINE__);
-    spdlog::debug("{}:{} peer: {}", LOG_FILE_PATH(__FILE__), __LINE__, peer);
+    FF_DEBUG("{}:{} Utils::getCleanIP", LOG_FILE_PATH(__FILE__), __LINE__);
+    FF_DEBUG("{}:{} peer: {}", LOG_FILE_PATH(__FILE__), __LINE__, peer);
+
+    // see isLocalPeer, they are not tracked by ip
+    if (peer.rfind("unix:", 0) == 0) return "unix";
 
     // format: <ipv4 or ipv6>:<address>:<port>
     // 1. find first colon and skip protocol (ipv4: or ipv6:)
@@ -68,7 +71,7 @@ static std::string getCleanIP(const std::string& peer)
 // this function is assisted by Google Gemini
 std::string getIPFromContext(grpc::ServerContextBase *ctx)
 {
-    spdlog::debug("{}:{} Utils::getIPFromContext",
+    FF_DEBUG("{}:{} Utils::getIPFromContext",
         LOG_FILE_PATH(__FILE__), __LINE__);
 
     auto metadata = ctx->client_metadata();
@@ -89,9 +92,17 @@ std::string getIPFromContext(grpc::ServerContextBase *ctx)
     return getCleanIP(ctx->peer());
 }
 
+bool isLocalPeer(grpc::ServerContextBase *ctx)
+{
+    auto metadata = ctx->client_metadata();
+    return ctx->peer().rfind("unix:", 0) == 0 &&
+           metadata.find("x-forwarded-for") == metadata.end() &&
+           metadata.find("x-real-ip") == metadata.end();
+}
+
 u8 getTokenFromContext(grpc::ServerContextBase *ctx, std::string &out)
 {
-    spdlog::debug("{}:{} Utils::getTokenFromContext",
+    FF_DEBUG("{}:{} Utils::getTokenFromContext",
         LOG_FILE_PATH(__FILE__), __LINE__);
 
     auto metadata = ctx->client_metadata();
@@ -40,6 +40,12 @@ namespace Utils
 
 std::string getIPFromContext(grpc::ServerContextBase *);
 
+/**
+ * @brief a client on a unix socket which is not forwarded by a proxy,
+ * the socket file mode controls who can connect
+ */
+bool isLocalPeer(grpc::ServerContextBase *);
+
 u8 getTokenFromContext(grpc::ServerContextBase *, std::string &);
 
 } // end namespace Utils
@@ -0,0 +1,175 @@
+/*
+ * Flex Flow
+ * Copyright (c) 2026-present fdar0536
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+#include "spdlog/spdlog.h"
+
+#include "model/dao/ileasequeue.hpp"
+#include "model/errmsg.hpp"
+#include "model/utils.hpp"
+
+#include "init.hpp"
+
+#include "workerimpl.hpp"
+
+namespace Controller
+{
+
+namespace GRPCServer
+{
+
+static void buildLeaseRes(Model::Proc::Task &task, ff::LeaseRes &res)
+{
+    res.set_hastask(true);
+    ff::TaskDetailsRes *details = res.mutable_task();
+    details->set_workdir(task.workDir);
+    details->set_execname(task.execName);
+    for (auto it = task.args.begin(); it != task.args.end(); ++it)
+    {
+        details->add_args(*it);
+    }
+
+    details->set_id(task.ID);
+    details->set_cpus(task.cpus);
+    details->set_memorymb(task.memoryMB);
+    details->set_priority(task.priority);
+    details->set_walltimeoutsec(task.wallTimeoutSec);
+    details->set_cputimeoutsec(task.cpuTimeoutSec);
+}
+
+grpc::Status
+WorkerImpl::Lease(grpc::ServerContext *ctx,
+                  grpc::ServerReaderWriter<ff::LeaseRes, ff::WorkerReq> *stream)
+{
+    FF_DEBUG("{}:{} WorkerImpl::Lease", LOG_FILE_PATH(__FILE__), __LINE__);
+
+    if (!ctx || !stream)
+    {
+        spdlog::error("{}:{} Invalid input", LOG_FILE_PATH(__FILE__), __LINE__);
+        return grpc::Status(grpc::StatusCode::INTERNAL, "Invalid input");
+    }
+
+    ff::WorkerReq req;
+    if (!stream->Read(&req) || !req.has_hello())
+    {
+        spdlog::error("{}:{} worker must say hello first",
+            LOG_FILE_PATH(__FILE__), __LINE__);
+        return grpc::Status(grpc::StatusCode::INVALID_ARGUMENT,
+            "Worker must say hello first");
+    }
+
+    // keep the queue alive until the stream ends
+    auto queue = queueList->getQueue(req.hello().queue());
+    if (!queue)
+    {
+        spdlog::error("{}:{} Fail to get queue", LOG_FILE_PATH(__FILE__), __LINE__);
+        return grpc::Status(grpc::StatusCode::NOT_FOUND, "Fail to get queue");
+    }
+
+    auto leaseQueue = dynamic_cast<Model::DAO::ILeaseQueue *>(queue.get());
+    if (!leaseQueue)
+    {
+        spdlog::error("{}:{} Queue cannot be leased",
+            LOG_FILE_PATH(__FILE__), __LINE__);
+        return grpc::Status(grpc::StatusCode::UNIMPLEMENTED,
+            "Queue cannot be leased");
+    }
+
+    // the peer makes two workers with the same name different
+    std::string worker = req.hello().name() + "@" + ctx->peer();
+    spdlog::info("{}:{} worker {} joins queue {}",
+        LOG_FILE_PATH(__FILE__), __LINE__, worker, req.hello().queue());
+
+    u32 leaseMs = config.workerLeaseMs;
+    grpc::Status status = grpc::Status::OK;
+    while (stream->Read(&req))
+    {
+        ff::LeaseRes res;
+        res.set_leasems(leaseMs);
+
+        u8 code(0);
+        switch (req.body_case())
+        {
+        case ff::WorkerReq::kReady:
+        {
+            Model::Proc::Task task;
+            code = leaseQueue->leaseTask(worker, leaseMs, task);
+            if (code == ErrCode_OK)
+            {
+                buildLeaseRes(task, res);
+            }
+            else if (code != ErrCode_NOT_FOUND)
+            {
+                status = Model::ErrMsg::toGRPCStatus(code, "Fail to lease task");
+            }
+
+            break;
+        }
+        case ff::WorkerReq::kHeartbeat:
+        {
+            res.set_islost(static_cast<bool>(
+                leaseQueue->renewLease(worker, req.heartbeat().id(), leaseMs)));
+            break;
+        }
+        case ff::WorkerReq::kOutput:
+        {
+            std::vector<std::string> output(req.output().msg().begin(),
+                                            req.output().msg().end());
+            UNUSED(leaseQueue->appendLeaseOutput(worker,
+                                                 req.output().id(),
+                                                 output));
+
+            // no reply, the heartbeat after it tells the worker
+            // whether the lease is still there
+            continue;
+        }
+        case ff::WorkerReq::kResult:
+        {
+            res.set_islost(static_cast<bool>(
+                leaseQueue->finishLease(worker,
+                                        req.result().id(),
+                                        req.result().exitcode(),
+                                        req.result().istimedout(),
+                                        req.result().isfailed())));
+            break;
+        }
+        default:
+        {
+            status = grpc::Status(grpc::StatusCode::INVALID_ARGUMENT,
+                "Unexpected message");
+            break;
+        }
+        }
+
+        if (!status.ok() || !stream->Write(res))
+        {
+            break;
+        }
+    }
+
+    leaseQueue->releaseLeases(worker);
+    spdlog::info("{}:{} worker {} leaves", LOG_FILE_PATH(__FILE__), __LINE__, worker);
+    return status;
+}
+
+} // end namespace GRPCServer
+
+} // end namespace Controller
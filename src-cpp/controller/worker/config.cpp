@@ -0,0 +1,166 @@
+/*
+ * Flex Flow
+ * Copyright (c) 2026-present fdar0536
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+#include "spdlog/spdlog.h"
+#include "yaml-cpp/yaml.h"
+#include "CLI/CLI.hpp"
+
+#include "model/utils.hpp"
+
+#include "config.hpp"
+
+namespace Controller
+{
+
+namespace Worker
+{
+
+u8 Config::parse(Config *in, int argc, char **argv)
+{
+    FF_DEBUG("{}:{} Config::parse", LOG_FILE_PATH(__FILE__), __LINE__);
+
+    if (!in || !argv)
+    {
+        spdlog::error("{}:{} input is nullptr", LOG_FILE_PATH(__FILE__), __LINE__);
+        return 1;
+    }
+
+    std::string configFile("");
+
+    CLI::App app("Flex Flow Worker");
+    app.set_help_flag();
+
+    app.add_option("-c,--config-file", configFile,
+        "path to config file")->default_str("config.yaml");
+    app.add_flag("-v,--version","print version info");
+    app.add_flag("-h,--help","print help info");
+
+    CLI11_PARSE(app, argc, argv);
+
+    if (app.count("-v"))
+    {
+        printVersion();
+        return 2;
+    }
+
+    if (app.count("-h"))
+    {
+        fmt::println("{}", app.help());
+        return 2;
+    }
+
+    // unlike the server, there is no default queue to work for
+    if (configFile.empty())
+    {
+        spdlog::error("{}:{} no config file", LOG_FILE_PATH(__FILE__), __LINE__);
+        return 1;
+    }
+
+    if (Model::Utils::verifyFile(configFile))
+    {
+        spdlog::error("{}:{} Fail to verify config file", LOG_FILE_PATH(__FILE__), __LINE__);
+        return 1;
+    }
+
+    if (parse(in, configFile))
+    {
+        spdlog::error("{}:{} fail to parse config file", LOG_FILE_PATH(__FILE__), __LINE__);
+        return 1;
+    }
+
+    return 0;
+}
+
+u8 Config::parse(Config *obj, const std::string &path)
+{
+    FF_DEBUG("{}:{} Config::parse", LOG_FILE_PATH(__FILE__), __LINE__);
+
+    if (!obj)
+    {
+        spdlog::warn("{}:{} input is nullptr", LOG_FILE_PATH(__FILE__), __LINE__);
+        return 1;
+    }
+
+    try
+    {
+        YAML::Node config = YAML::LoadFile(path);
+
+        obj->server.host = config["host"].as<std::string>();
+        obj->server.port = config["port"].as<u16>();
+        obj->server.username = config["username"].as<std::string>();
+        obj->server.password = config["password"].as<std::string>();
+        obj->server.totpKey = config["totp key"].as<std::string>();
+        obj->queue = config["queue"].as<std::string>();
+
+        u8 level(0);
+        level = config["log level"].as<u8>();
+        obj->logLevel = static_cast<spdlog::level::level_enum>(level);
+
+        // optional
+        if (config["name"])
+        {
+            obj->name = config["name"].as<std::string>();
+        }
+
+        if (config["poll interval ms"])
+        {
+            obj->pollIntervalMs = config["poll interval ms"].as<u32>();
+            if (!obj->pollIntervalMs)
+            {
+                spdlog::error("{}:{} poll interval ms must not be 0",
+                    LOG_FILE_PATH(__FILE__), __LINE__);
+                return 1;
+            }
+        }
+
+        if (config["log path"])
+        {
+            obj->logPath = config["log path"].as<std::string>();
+            Model::Utils::convertPath(obj->logPath);
+            if (Model::Utils::verifyDir(obj->logPath))
+            {
+                spdlog::error("{}:{} fail to verify log path",
+                    LOG_FILE_PATH(__FILE__), __LINE__);
+                return 1;
+            }
+        }
+    }
+    catch (...)
+    {
+        spdlog::error("{}:{} fail to parse config file", LOG_FILE_PATH(__FILE__), __LINE__);
+        return 1;
+    }
+
+    return 0;
+}
+
+void Config::printVersion()
+{
+    fmt::println("FFWORKER version info:");
+    fmt::println("branch:  " FF_BRANCH);
+    fmt::println("commit:  " FF_COMMIT);
+    fmt::println("version: " FF_VERSION);
+}
+
+} // end namespace Worker
+
+} // end namespace Controller
@@ -0,0 +1,74 @@
+/*
+ * Flex Flow
+ * Copyright (c) 2026-present fdar0536
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+#ifndef _CONTROLLER_WORKER_CONFIG_HPP_
+#define _CONTROLLER_WORKER_CONFIG_HPP_
+
+#include <string>
+
+#include "spdlog/common.h"
+
+#include "controller/global/global.hpp"
+#include "model/defines.h"
+
+namespace Controller
+{
+
+namespace Worker
+{
+
+class Config
+{
+public:
+
+    /**
+     * @return u8 2 if only the version or help is printed
+     */
+    static u8 parse(Config *in, int argc, char **argv);
+
+    static u8 parse(Config *, const std::string &);
+
+    // the server which owns the queue
+    Global::RemoteServer server;
+
+    std::string queue;
+
+    // shown in the server log
+    std::string name = "worker";
+
+    // how long to wait when there is nothing to run or the server is gone
+    u32 pollIntervalMs = 5000;
+
+    std::string logPath = "";
+
+    i32 logLevel = static_cast<i32>(spdlog::level::level_enum::info);
+
+private:
+
+    static void printVersion();
+};
+
+} // end namespace Worker
+
+} // end namespace Controller
+
+#endif // _CONTROLLER_WORKER_CONFIG_HPP_
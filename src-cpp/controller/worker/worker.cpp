@@ -0,0 +1,363 @@
+/*
+ * Flex Flow
+ * Copyright (c) 2026-present fdar0536
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+#include "spdlog/spdlog.h"
+
+#include "model/auth/crypto.hpp"
+#include "model/utils.hpp"
+
+#ifdef _WIN32
+#include "model/proc/winproc.hpp"
+#elif (defined __linux__)
+#include "model/proc/linuxproc.hpp"
+#else
+#include "model/proc/macproc.hpp"
+#endif
+
+#include "worker.hpp"
+
+namespace Controller
+{
+
+namespace Worker
+{
+
+// the smallest heartbeat interval
+static constexpr u32 MIN_HEARTBEAT_MS = 100;
+
+static Model::Proc::IProc *newProc()
+{
+#ifdef _WIN32
+    return new (std::nothrow) Model::Proc::WinProc();
+#elif defined(__linux__)
+    return new (std::nothrow) Model::Proc::LinuxProc();
+#else
+    return new (std::nothrow) Model::Proc::MacProc();
+#endif
+}
+
+// the output has no reply, so the stream stays in lockstep
+static bool sendOutput(grpc::ClientReaderWriter<ff::WorkerReq, ff::LeaseRes> &stream,
+                       Model::Proc::IProc &proc,
+                       const i32 id)
+{
+    std::vector<std::string> output;
+    proc.readCurrentOutput(output);
+    if (output.empty())
+    {
+        return true;
+    }
+
+    ff::WorkerReq req;
+    ff::WorkerOutput *body = req.mutable_output();
+    body->set_id(id);
+    for (auto it = output.begin(); it != output.end(); ++it)
+    {
+        body->add_msg(*it);
+    }
+
+    return stream.Write(req);
+}
+
+u8 Agent::init(const Config &config)
+{
+    FF_DEBUG("{}:{} Agent::init", LOG_FILE_PATH(__FILE__), __LINE__);
+
+    m_config = config;
+    std::vector<u8> totpKey;
+    Model::Auth::Crypto::decodeBase32(m_config.server.totpKey, totpKey);
+    if (totpKey.empty())
+    {
+        spdlog::error("{}:{} Invalid totp key", LOG_FILE_PATH(__FILE__), __LINE__);
+        return 1;
+    }
+
+    return 0;
+}
+
+void Agent::run()
+{
+    FF_DEBUG("{}:{} Agent::run", LOG_FILE_PATH(__FILE__), __LINE__);
+
+    while (1)
+    {
+        // the channel reconnects by itself, so login only once
+        if (!m_token && connect())
+        {
+            spdlog::warn("{}:{} Fail to connect to {}:{}, retry later",
+                LOG_FILE_PATH(__FILE__), __LINE__,
+                m_config.server.host, m_config.server.port);
+        }
+        else if (session())
+        {
+            spdlog::warn("{}:{} Lost the server, retry later",
+                LOG_FILE_PATH(__FILE__), __LINE__);
+        }
+
+        if (wait(m_config.pollIntervalMs))
+        {
+            break;
+        }
+    }
+}
+
+void Agent::stop()
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_stop = true;
+    if (m_ctx)
+    {
+        m_ctx->TryCancel();
+    }
+
+    m_cv.notify_all();
+}
+
+// private member functions
+u8 Agent::connect()
+{
+    FF_DEBUG("{}:{} Agent::connect", LOG_FILE_PATH(__FILE__), __LINE__);
+
+    std::vector<u8> totpKey;
+    Model::Auth::Crypto::decodeBase32(m_config.server.totpKey, totpKey);
+
+    Model::Connect::GRPC::ChannelOptions options;
+    options.otpProvider = [totpKey]()
+    {
+        return Model::Auth::Crypto::generateTotp(totpKey);
+    };
+
+    auto token = Model::Connect::GRPC::connect(m_config.server.host,
+        m_config.server.port, m_config.server.username,
+        m_config.server.password, options.otpProvider(), options);
+    if (token == nullptr)
+    {
+        return 1;
+    }
+
+    m_stub = ff::Worker::NewStub(token->channel);
+    if (!m_stub)
+    {
+        spdlog::error("{}:{} Fail to allocate memory", LOG_FILE_PATH(__FILE__), __LINE__);
+        return 1;
+    }
+
+    m_token = token;
+    return 0;
+}
+
+u8 Agent::session()
+{
+    FF_DEBUG("{}:{} Agent::session", LOG_FILE_PATH(__FILE__), __LINE__);
+
+    // no deadline, the stream lives as long as the worker
+    std::string used = Model::Connect::GRPC::currentToken(*m_token);
+    grpc::ClientContext ctx;
+    ctx.AddMetadata("x-auth-token", used);
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        if (m_stop)
+        {
+            return 0;
+        }
+
+        m_ctx = &ctx;
+    }
+
+    auto stream = m_stub->Lease(&ctx);
+    ff::WorkerReq req;
+    req.mutable_hello()->set_name(m_config.name);
+    req.mutable_hello()->set_queue(m_config.queue);
+
+    u8 ret(0);
+    if (!stream->Write(req))
+    {
+        ret = 1;
+    }
+
+    ff::LeaseRes res;
+    while (!ret)
+    {
+        req.Clear();
+        req.mutable_ready();
+        if (!stream->Write(req) || !stream->Read(&res))
+        {
+            ret = 1;
+            break;
+        }
+
+        if (res.hastask())
+        {
+            ret = runTask(*stream, res);
+        }
+        else if (wait(m_config.pollIntervalMs))
+        {
+            break;
+        }
+    }
+
+    stream->WritesDone();
+    grpc::Status status = stream->Finish();
+    bool stopped(false);
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_ctx = nullptr;
+        stopped = m_stop;
+    }
+
+    if (stopped)
+    {
+        return 0;
+    }
+
+    if (status.error_code() == grpc::StatusCode::UNAUTHENTICATED &&
+        Model::Connect::GRPC::refresh(*m_token, used))
+    {
+        spdlog::error("{}:{} Fail to login again", LOG_FILE_PATH(__FILE__), __LINE__);
+    }
+    else if (!status.ok())
+    {
+        spdlog::error("{}:{} gRPC error code {}: {}",
+            LOG_FILE_PATH(__FILE__), __LINE__,
+            static_cast<i32>(status.error_code()), status.error_message());
+    }
+
+    return ret;
+}
+
+u8 Agent::runTask(Stream &stream, const ff::LeaseRes &lease)
+{
+    FF_DEBUG("{}:{} Agent::runTask", LOG_FILE_PATH(__FILE__), __LINE__);
+
+    Model::Proc::Task task;
+    task.workDir = lease.task().workdir();
+    task.execName = lease.task().execname();
+    task.args.assign(lease.task().args().begin(), lease.task().args().end());
+    task.ID = lease.task().id();
+    task.wallTimeoutSec = lease.task().walltimeoutsec();
+    task.cpuTimeoutSec = lease.task().cputimeoutsec();
+    spdlog::info("{}:{} run task {}", LOG_FILE_PATH(__FILE__), __LINE__, task.ID);
+
+    std::unique_ptr<Model::Proc::IProc> proc(newProc());
+    i32 exitCode(-1);
+    bool isTimedOut(false);
+    bool isFailed(true);
+    ff::WorkerReq req;
+    ff::LeaseRes res;
+    if (!proc)
+    {
+        spdlog::error("{}:{} Fail to allocate memory", LOG_FILE_PATH(__FILE__), __LINE__);
+    }
+    else if (proc->start(task))
+    {
+        spdlog::error("{}:{} Fail to start process", LOG_FILE_PATH(__FILE__), __LINE__);
+    }
+    else
+    {
+        // three heartbeats in a lease, so a late one does not lose it
+        u32 interval = lease.leasems() / 3;
+        if (interval < MIN_HEARTBEAT_MS) interval = MIN_HEARTBEAT_MS;
+
+        auto nextBeat = std::chrono::steady_clock::now() +
+                        std::chrono::milliseconds(interval);
+        while (proc->isRunning())
+        {
+            if (wait(MIN_HEARTBEAT_MS))
+            {
+                // the server gives the task to others when the stream ends
+                proc->stop();
+                return 0;
+            }
+
+            auto now = std::chrono::steady_clock::now();
+            if (now < nextBeat)
+            {
+                continue;
+            }
+
+            nextBeat = now + std::chrono::milliseconds(interval);
+            req.Clear();
+            req.mutable_heartbeat()->set_id(task.ID);
+            if (!sendOutput(stream, *proc, task.ID) ||
+                !stream.Write(req) || !stream.Read(&res))
+            {
+                proc->stop();
+                return 1;
+            }
+
+            if (res.islost())
+            {
+                spdlog::warn("{}:{} lease of task {} is lost, stop it",
+                    LOG_FILE_PATH(__FILE__), __LINE__, task.ID);
+                proc->stop();
+                return 0;
+            }
+        }
+
+        if (!sendOutput(stream, *proc, task.ID))
+        {
+            return 1;
+        }
+
+        if (proc->exitCode(exitCode))
+        {
+            spdlog::error("{}:{} Fail to get exit code",
+                LOG_FILE_PATH(__FILE__), __LINE__);
+            exitCode = -1;
+        }
+        else
+        {
+            isFailed = false;
+        }
+
+        isTimedOut = proc->isTimedOut();
+    }
+
+    req.Clear();
+    req.mutable_result()->set_id(task.ID);
+    req.mutable_result()->set_exitcode(exitCode);
+    req.mutable_result()->set_istimedout(isTimedOut);
+    req.mutable_result()->set_isfailed(isFailed);
+    if (!stream.Write(req) || !stream.Read(&res))
+    {
+        return 1;
+    }
+
+    if (res.islost())
+    {
+        spdlog::warn("{}:{} lease of task {} is lost, the result is dropped",
+            LOG_FILE_PATH(__FILE__), __LINE__, task.ID);
+    }
+
+    return 0;
+}
+
+bool Agent::wait(const u32 ms)
+{
+    std::unique_lock<std::mutex> lock(m_mutex);
+    return m_cv.wait_for(lock, std::chrono::milliseconds(ms),
+                         [this]{ return m_stop; });
+}
+
+} // end namespace Worker
+
+} // end namespace Controller
@@ -0,0 +1,101 @@
+/*
+ * Flex Flow
+ * Copyright (c) 2026-present fdar0536
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+#ifndef _CONTROLLER_WORKER_WORKER_HPP_
+#define _CONTROLLER_WORKER_WORKER_HPP_
+
+#include <condition_variable>
+#include <memory>
+#include <mutex>
+
+#include "worker.grpc.pb.h"
+
+#include "model/connect/grpc/connect.hpp"
+#include "model/proc/iproc.hpp"
+
+#include "config.hpp"
+
+namespace Controller
+{
+
+namespace Worker
+{
+
+/**
+ * @brief lease tasks from a queue of the server and run them here
+ *
+ * The stream is lockstep: every Ready, Heartbeat and Result is answered
+ * once by the server. If the worker goes away, its lease expires and
+ * the server gives the task to someone else.
+ */
+class Agent
+{
+public:
+
+    u8 init(const Config &config);
+
+    /**
+     * @brief serve until stop() is called
+     */
+    void run();
+
+    void stop();
+
+private:
+
+    typedef grpc::ClientReaderWriter<ff::WorkerReq, ff::LeaseRes> Stream;
+
+    Config m_config;
+
+    std::shared_ptr<Model::Connect::GRPC::Token> m_token;
+
+    std::unique_ptr<ff::Worker::Stub> m_stub;
+
+    std::mutex m_mutex;
+
+    std::condition_variable m_cv;
+
+    bool m_stop = false;
+
+    // the running stream, cancelled by stop()
+    grpc::ClientContext *m_ctx = nullptr;
+
+    u8 connect();
+
+    /**
+     * @return u8 1 if the stream is broken
+     */
+    u8 session();
+
+    u8 runTask(Stream &stream, const ff::LeaseRes &lease);
+
+    /**
+     * @return bool true if stop() is called
+     */
+    bool wait(const u32 ms);
+};
+
+} // end namespace Worker
+
+} // end namespace Controller
+
+#endif // _CONTROLLER_WORKER_WORKER_HPP_
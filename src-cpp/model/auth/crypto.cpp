@@ -48,10 +48,10 @@ static const std::string alphabet = "ABCDEFGHIJKLMNOPQRSTUVWXYZ234567";
 
 void decodeBase32(const std::string &base32, std::vector<u8> &out)
 {
-    spdlog::debug("{}:{} Model::Auth::Utils::decodeBase32",
+    FF_DEBUG("{}:{} Model::Auth::Utils::decodeBase32",
                   LOG_FILE_PATH(__FILE__), __LINE__);
-    spdlog::debug("base32: {}", base32);
-    spdlog::debug("out.size(): {}", out.size());
+    FF_DEBUG("base32.size(): {}", base32.size());
+    FF_DEBUG("out.size(): {}", out.size());
 
     out.clear();
     out.reserve(32); // 256 bits
@@ -74,9 +74,9 @@ void decodeBase32(const std::string &base32, std::vector<u8> &out)
 
 void encodeBase32(const std::vector<u8> &in, std::string &out)
 {
-    spdlog::debug("{}:{} Model::Auth::Utils::encodeBase32",
+    FF_DEBUG("{}:{} Model::Auth::Utils::encodeBase32",
                   LOG_FILE_PATH(__FILE__), __LINE__);
-    spdlog::debug("in.size(): {}", in.size());
+    FF_DEBUG("in.size(): {}", in.size());
 
     out.clear();
     out.reserve(((in.size() + 4) / 5) << 3);
@@ -106,19 +106,19 @@ void encodeBase32(const std::vector<u8> &in, std::string &out)
 
 void decodeBase64(const std::string &base64, std::vector<u8> &out)
 {
-    spdlog::debug("{}:{} Model::Auth::Utils::decodeBase64",
+    FF_DEBUG("{}:{} Model::Auth::Utils::decodeBase64",
                   LOG_FILE_PATH(__FILE__), __LINE__);
-    spdlog::debug("base64: {}", base64);
-    spdlog::debug("out.size(): {}", out.size());
+    FF_DEBUG("base64.size(): {}", base64.size());
+    FF_DEBUG("out.size(): {}", out.size());
 
     out.clear();
-    out.reserve(base64.size());
+    out.resize(base64.size());
 
     std::unique_ptr<BIO, decltype(&BIO_free_all)> b64(BIO_new(BIO_f_base64()), BIO_free_all);
     std::unique_ptr<BIO, decltype(&BIO_free)> bmem(BIO_new_mem_buf(base64.data(), static_cast<int>(base64.size())), BIO_free);
     
     BIO_set_flags(b64.get(), BIO_FLAGS_BASE64_NO_NL);
-    BIO_push(b64.get(), bmem.get());
+    BIO_push(b64.get(), bmem.release()); // b64 owns the chain now
     
     int decoded_size = BIO_read(b64.get(), out.data(), static_cast<int>(out.size()));
     
@@ -134,9 +134,9 @@ void decodeBase64(const std::string &base64, std::vector<u8> &out)
 
 void encodeBase64(const std::vector<u8> &in, std::string &out)
 {
-    spdlog::debug("{}:{} Model::Auth::Utils::encodeBase64",
+    FF_DEBUG("{}:{} Model::Auth::Utils::encodeBase64",
         LOG_FILE_PATH(__FILE__), __LINE__);
-    spdlog::debug("in.size(): {}", in.size());
+    FF_DEBUG("in.size(): {}", in.size());
 
     out.clear();
 
@@ -145,21 +145,22 @@ void encodeBase64(const std::vector<u8> &in, std::string &out)
     
     BIO_set_flags(b64.get(), BIO_FLAGS_BASE64_NO_NL);
     
-    BIO_push(b64.get(), bmem.get());
+    BIO *mem = bmem.release(); // b64 owns the chain now
+    BIO_push(b64.get(), mem);
     
     BIO_write(b64.get(), in.data(), static_cast<int>(in.size()));
     BIO_flush(b64.get());
     
     BUF_MEM *bptr;
-    BIO_get_mem_ptr(b64.get(), &bptr);
+    BIO_get_mem_ptr(mem, &bptr);
     out = std::string(bptr->data, bptr->length);
 }
 
 std::string generateTotp(const std::vector<u8> &key, u64 time_step)
 {
-    spdlog::debug("{}:{} Model::Auth::Utils::generateTotp",
+    FF_DEBUG("{}:{} Model::Auth::Utils::generateTotp",
                   LOG_FILE_PATH(__FILE__), __LINE__);
-    spdlog::debug("secret.size(): {}", key.size());
+    FF_DEBUG("secret.size(): {}", key.size());
 
     u64 counter = std::time(nullptr) / time_step;
     
@@ -192,9 +193,9 @@ std::string generateTotp(const std::vector<u8> &key, u64 time_step)
 
 std::string sha512(const std::string &input)
 {
-    spdlog::debug("{}:{} Model::Auth::Utils::sha512",
+    FF_DEBUG("{}:{} Model::Auth::Utils::sha512",
                   LOG_FILE_PATH(__FILE__), __LINE__);
-    spdlog::debug("input: {}", input);
+    FF_DEBUG("input.size(): {}", input.size());
 
     // initialize
     EVP_MD_CTX* context = EVP_MD_CTX_new();
@@ -220,14 +221,34 @@ std::string sha512(const std::string &input)
     return ss.str();
 }
 
+u8 hmacSha256(const std::vector<u8> &key,
+              const std::string &data,
+              std::vector<u8> &out)
+{
+    FF_DEBUG("{}:{} Model::Auth::Utils::hmacSha256",
+                  LOG_FILE_PATH(__FILE__), __LINE__);
+
+    out.resize(32);
+    unsigned int length = 0;
+    if (!HMAC(EVP_sha256(), key.data(), static_cast<int>(key.size()),
+              reinterpret_cast<const unsigned char *>(data.data()),
+              data.size(), out.data(), &length) || length != out.size())
+    {
+        spdlog::error("{}:{} HMAC failed", LOG_FILE_PATH(__FILE__), __LINE__);
+        out.clear();
+        return 1;
+    }
+
+    return 0;
+}
+
 u8 argon2id(const std::string& password, 
             const std::vector<uint8_t>& salt, 
             std::vector<uint8_t>& out_hash)
 {
-    spdlog::debug("{}:{} Model::Auth::Utils::argon2id",
+    FF_DEBUG("{}:{} Model::Auth::Utils::argon2id",
                   LOG_FILE_PATH(__FILE__), __LINE__);
-    spdlog::debug("password: {}", password);
-    spdlog::debug("salt.size(): {}", salt.size());
+    FF_DEBUG("salt.size(): {}", salt.size());
 
     out_hash.clear();
     out_hash.resize(32);
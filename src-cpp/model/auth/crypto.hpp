@@ -52,6 +52,13 @@ std::string generateTotp(const std::vector<u8> &key,
 
 std::string sha512(const std::string &input);
 
+/**
+ * @brief HMAC-SHA256 of data, out is resized to 32 bytes
+ */
+u8 hmacSha256(const std::vector<u8> &key,
+              const std::string &data,
+              std::vector<u8> &out);
+
 u8 argon2id(const std::string& password, 
             const std::vector<uint8_t>& salt, 
             std::vector<uint8_t>& out_hash);
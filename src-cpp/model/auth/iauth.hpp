@@ -44,6 +44,10 @@ public:
 
     virtual ~IAuth() {}
 
+    /**
+     * @return u8 0 on success, 1 if failed, 2 if the server is too busy
+     * to verify the password now
+     */
     virtual u8 login(const std::string &username,
                      const std::string &password,
                      const std::string &otp,
@@ -55,6 +59,12 @@ public:
 
     virtual u8 cannotAccess(const std::string &ip, const std::string &token) = 0;
 
+    /**
+     * @brief check the token only, for local peers which are not
+     * tracked by ip, nothing counts towards a ban
+     */
+    virtual u8 cannotAccessByToken(const std::string &token) = 0;
+
     virtual void addBannedIp(const std::string &ip) = 0;
 
     virtual void removeBannedIp(const std::string &ip) = 0;
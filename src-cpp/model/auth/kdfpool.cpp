@@ -0,0 +1,160 @@
+/*
+ * Flex Flow
+ * Copyright (c) 2026-present fdar0536
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include "spdlog/spdlog.h"
+
+#include "model/utils.hpp"
+
+#include "crypto.hpp"
+#include "kdfpool.hpp"
+
+namespace Model
+{
+
+namespace Auth
+{
+
+KdfPool::KdfPool() :
+    m_rejected(Metrics::registry().counter("ff_kdf_rejected_total")),
+    m_wait(Metrics::registry().histogram("ff_kdf_wait"))
+{}
+
+KdfPool::~KdfPool()
+{
+    stop();
+}
+
+u8 KdfPool::start(size_t workers, size_t queueSize)
+{
+    FF_DEBUG("{}:{} KdfPool::start", LOG_FILE_PATH(__FILE__), __LINE__);
+    FF_DEBUG("{}:{} workers: {}, queue size: {}",
+        LOG_FILE_PATH(__FILE__), __LINE__, workers, queueSize);
+
+    if (!workers)
+    {
+        spdlog::error("{}:{} workers must be greater than 0",
+            LOG_FILE_PATH(__FILE__), __LINE__);
+        return 1;
+    }
+
+    std::unique_lock<std::mutex> lock(m_mutex);
+    if (!m_workers.empty())
+    {
+        spdlog::error("{}:{} kdf pool is already started",
+            LOG_FILE_PATH(__FILE__), __LINE__);
+        return 1;
+    }
+
+    m_queueSize = queueSize;
+    m_stop = false;
+    m_workers.reserve(workers);
+    for (size_t i = 0; i < workers; ++i)
+    {
+        m_workers.emplace_back([this]() { workerLoop(); });
+    }
+
+    return 0;
+}
+
+void KdfPool::stop()
+{
+    FF_DEBUG("{}:{} KdfPool::stop", LOG_FILE_PATH(__FILE__), __LINE__);
+
+    std::vector<std::jthread> workers;
+    {
+        std::unique_lock<std::mutex> lock(m_mutex);
+        m_stop = true;
+        workers.swap(m_workers);
+    }
+
+    m_cond.notify_all();
+    workers.clear(); // join
+}
+
+u8 KdfPool::argon2id(const std::string &password,
+                     const std::vector<u8> &salt,
+                     std::vector<u8> &out)
+{
+    FF_DEBUG("{}:{} KdfPool::argon2id", LOG_FILE_PATH(__FILE__), __LINE__);
+
+    auto enqueueTime = std::chrono::steady_clock::now();
+    std::packaged_task<u8()> task([&, enqueueTime]() -> u8
+    {
+        m_wait->record(Metrics::elapsedUs(enqueueTime));
+        return Crypto::argon2id(password, salt, out);
+    });
+
+    std::future<u8> res = task.get_future();
+    {
+        std::unique_lock<std::mutex> lock(m_mutex);
+        if (m_workers.empty() || m_stop)
+        {
+            lock.unlock();
+            task();
+            return res.get() ? 1 : 0;
+        }
+
+        if (m_jobs.size() >= m_idle + m_queueSize)
+        {
+            m_rejected->add();
+            spdlog::warn("{}:{} kdf queue is full",
+                LOG_FILE_PATH(__FILE__), __LINE__);
+            return 2;
+        }
+
+        m_jobs.push_back(std::move(task));
+    }
+
+    m_cond.notify_one();
+    return res.get() ? 1 : 0;
+}
+
+// private member functions
+void KdfPool::workerLoop()
+{
+    FF_DEBUG("{}:{} KdfPool::workerLoop", LOG_FILE_PATH(__FILE__), __LINE__);
+
+    while (1)
+    {
+        std::packaged_task<u8()> task;
+        {
+            std::unique_lock<std::mutex> lock(m_mutex);
+            ++m_idle;
+            m_cond.wait(lock, [this]() { return m_stop || !m_jobs.empty(); });
+            --m_idle;
+            if (m_jobs.empty())
+            {
+                return; // stopped and drained
+            }
+
+            task = std::move(m_jobs.front());
+            m_jobs.pop_front();
+        }
+
+        task();
+    }
+}
+
+} // end namespace Auth
+
+} // end namespace Model
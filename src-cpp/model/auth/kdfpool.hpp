@@ -0,0 +1,110 @@
+/*
+ * Flex Flow
+ * Copyright (c) 2026-present fdar0536
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#ifndef _MODEL_AUTH_KDFPOOL_HPP_
+#define _MODEL_AUTH_KDFPOOL_HPP_
+
+#include <condition_variable>
+#include <deque>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "model/defines.h"
+#include "model/metrics/metrics.hpp"
+
+namespace Model
+{
+
+namespace Auth
+{
+
+/**
+ * @brief a few threads which run the password KDF
+ *
+ * argon2id takes 64 MB for every call, so at most "workers" hashes run at
+ * once and at most "queueSize" more may wait, 0 means a call only runs
+ * if a worker is idle. Any call beyond that is rejected right away
+ * instead of piling up on the gRPC threads.
+ */
+class KdfPool
+{
+public:
+
+    KdfPool();
+
+    ~KdfPool();
+
+    /**
+     * @return u8 0 on success, 1 if it is started or the input is invalid
+     */
+    u8 start(size_t workers, size_t queueSize);
+
+    /**
+     * @brief finish the queued jobs and join the workers
+     */
+    void stop();
+
+    /**
+     * @brief run Crypto::argon2id on the pool, it runs inline if the pool
+     * is not started
+     * @return u8 0 on success, 1 if argon2id failed,
+     * 2 if the queue is full
+     */
+    u8 argon2id(const std::string &password,
+                const std::vector<u8> &salt,
+                std::vector<u8> &out);
+
+private:
+
+    std::mutex m_mutex;
+
+    std::condition_variable m_cond;
+
+    std::deque<std::packaged_task<u8()>> m_jobs;
+
+    std::vector<std::jthread> m_workers;
+
+    size_t m_queueSize = 0;
+
+    // workers waiting for a job, the jobs they are about to take do not wait
+    size_t m_idle = 0;
+
+    bool m_stop = false;
+
+    std::shared_ptr<Metrics::Counter> m_rejected;
+
+    std::shared_ptr<Metrics::Histogram> m_wait;
+
+    void workerLoop();
+
+}; // end class KdfPool
+
+} // end namespace Auth
+
+} // end namespace Model
+
+#endif // _MODEL_AUTH_KDFPOOL_HPP_
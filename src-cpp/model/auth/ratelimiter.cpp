@@ -0,0 +1,251 @@
+/*
+ * Flex Flow
+ * Copyright (c) 2026-present fdar0536
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include <cmath>
+#include <mutex>
+
+#include "spdlog/spdlog.h"
+
+#include "model/utils.hpp"
+
+#include "ratelimiter.hpp"
+
+namespace Model
+{
+
+namespace Auth
+{
+
+static constexpr u64 millis = 1000;
+
+// a refill time this far ahead of now is a race with another thread,
+// beyond it the clock has wrapped while the bucket was idle
+static constexpr u32 maxAheadMs = 60000;
+
+static u64 pack(u32 time, u64 tokens)
+{
+    return (static_cast<u64>(time) << 32) | tokens;
+}
+
+RateLimiter::RateLimiter() :
+    m_epoch(std::chrono::steady_clock::now())
+{}
+
+RateLimiter::~RateLimiter()
+{}
+
+u8 RateLimiter::setLimit(f64 rate, u32 burst)
+{
+    FF_DEBUG("{}:{} RateLimiter::setLimit", LOG_FILE_PATH(__FILE__), __LINE__);
+    FF_DEBUG("{}:{} rate: {}, burst: {}",
+        LOG_FILE_PATH(__FILE__), __LINE__, rate, burst);
+
+    if (rate < 0 || (rate > 0 && !burst))
+    {
+        spdlog::error("{}:{} invalid rate limit", LOG_FILE_PATH(__FILE__), __LINE__);
+        return 1;
+    }
+
+    // tokens must fit into the lower 32 bits
+    u64 capacity = static_cast<u64>(burst) * millis;
+    if (capacity > UINT32_MAX)
+    {
+        spdlog::error("{}:{} burst is too large", LOG_FILE_PATH(__FILE__), __LINE__);
+        return 1;
+    }
+
+    m_rate = rate; // tokens per second == milli tokens per ms
+    m_capacity = capacity;
+    return 0;
+}
+
+void RateLimiter::setCost(const std::string &method, u32 cost)
+{
+    FF_DEBUG("{}:{} RateLimiter::setCost", LOG_FILE_PATH(__FILE__), __LINE__);
+    FF_DEBUG("{}:{} method: {}, cost: {}",
+        LOG_FILE_PATH(__FILE__), __LINE__, method, cost);
+
+    m_costs[method] = cost;
+}
+
+bool RateLimiter::isEnabled() const
+{
+    return m_rate > 0;
+}
+
+u32 RateLimiter::costOf(const std::string &method) const
+{
+    auto it = m_costs.find(method);
+    return it == m_costs.end() ? 1 : it->second;
+}
+
+u64 RateLimiter::acquire(const std::string &key, u32 cost)
+{
+    FF_DEBUG("{}:{} RateLimiter::acquire", LOG_FILE_PATH(__FILE__), __LINE__);
+
+    if (!isEnabled() || !cost)
+    {
+        return 0;
+    }
+
+    u64 need = static_cast<u64>(cost) * millis;
+    if (need > m_capacity)
+    {
+        need = m_capacity;
+    }
+
+    u32 now = nowMs();
+    Shard &shard = shardOf(key);
+    {
+        std::shared_lock<std::shared_mutex> lock(shard.mutex);
+        auto it = shard.buckets.find(key);
+        if (it != shard.buckets.end())
+        {
+            return take(*it->second, now, need);
+        }
+    }
+
+    std::unique_lock<std::shared_mutex> lock(shard.mutex);
+    if (shard.buckets.size() >= MAX_KEYS_PER_SHARD &&
+        shard.buckets.find(key) == shard.buckets.end())
+    {
+        // full buckets are the same as new ones
+        for (auto it = shard.buckets.begin(); it != shard.buckets.end();)
+        {
+            u64 state = refill(it->second->load(std::memory_order_relaxed), now);
+            if ((state & UINT32_MAX) >= m_capacity)
+            {
+                it = shard.buckets.erase(it);
+                continue;
+            }
+
+            ++it;
+        }
+
+        if (shard.buckets.size() >= MAX_KEYS_PER_SHARD)
+        {
+            // the one refilled least recently, the hot buckets keep their state
+            auto oldest = shard.buckets.begin();
+            u32 oldestAge(0);
+            for (auto it = shard.buckets.begin(); it != shard.buckets.end(); ++it)
+            {
+                u32 last = static_cast<u32>(
+                    it->second->load(std::memory_order_relaxed) >> 32);
+                u32 age = now - last;
+                if (age > static_cast<u32>(0) - maxAheadMs) age = 0;
+                if (age >= oldestAge)
+                {
+                    oldest = it;
+                    oldestAge = age;
+                }
+            }
+
+            shard.buckets.erase(oldest);
+        }
+    }
+
+    auto &bucket = shard.buckets[key];
+    if (!bucket)
+    {
+        bucket = std::make_unique<std::atomic<u64>>(pack(now, m_capacity));
+    }
+
+    return take(*bucket, now, need);
+}
+
+// private member functions
+RateLimiter::Shard &RateLimiter::shardOf(const std::string &key)
+{
+    return m_shards[std::hash<std::string>{}(key) % SHARD_COUNT];
+}
+
+u32 RateLimiter::nowMs() const
+{
+    // wraps after about 49 days, elapsed time is computed modulo 2^32
+    return static_cast<u32>(
+        std::chrono::duration_cast<std::chrono::milliseconds>(
+            std::chrono::steady_clock::now() - m_epoch).count());
+}
+
+u64 RateLimiter::take(std::atomic<u64> &bucket, u32 now, u64 need) const
+{
+    u64 current = bucket.load(std::memory_order_relaxed);
+    while (1)
+    {
+        u64 next = refill(current, now);
+        u64 tokens = next & UINT32_MAX;
+        if (tokens < need)
+        {
+            u64 wait = static_cast<u64>(
+                std::ceil(static_cast<f64>(need - tokens) / m_rate));
+            return wait ? wait : 1;
+        }
+
+        // keep the refill time of next, it may be ahead of now
+        next = (next & ~static_cast<u64>(UINT32_MAX)) | (tokens - need);
+        if (bucket.compare_exchange_weak(current, next,
+                                         std::memory_order_relaxed))
+        {
+            return 0;
+        }
+    }
+}
+
+u64 RateLimiter::refill(u64 state, u32 now) const
+{
+    u32 last = static_cast<u32>(state >> 32);
+    u64 tokens = state & UINT32_MAX;
+
+    // unsigned, so it is right across the wrap of nowMs
+    u32 elapsed = now - last;
+    if (elapsed > static_cast<u32>(0) - maxAheadMs)
+    {
+        // another thread has stored a newer time already
+        return state;
+    }
+
+    u64 gained = static_cast<u64>(static_cast<f64>(elapsed) * m_rate);
+    if (tokens + gained >= m_capacity)
+    {
+        return pack(now, m_capacity);
+    }
+
+    if (!gained)
+    {
+        return state;
+    }
+
+    // only move the refill time by what is credited, so frequent callers
+    // do not lose the fractions
+    u32 used = static_cast<u32>(static_cast<f64>(gained) / m_rate);
+    if (used > elapsed)
+    {
+        used = elapsed;
+    }
+
+    return pack(last + used, tokens + gained);
+}
+
+} // end namespace Auth
+
+} // end namespace Model
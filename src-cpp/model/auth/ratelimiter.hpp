@@ -0,0 +1,120 @@
+/*
+ * Flex Flow
+ * Copyright (c) 2026-present fdar0536
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#ifndef _MODEL_AUTH_RATELIMITER_HPP_
+#define _MODEL_AUTH_RATELIMITER_HPP_
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <memory>
+#include <shared_mutex>
+#include <string>
+#include <unordered_map>
+
+#include "model/defines.h"
+
+namespace Model
+{
+
+namespace Auth
+{
+
+/**
+ * @brief token buckets keyed by client
+ *
+ * A bucket is one atomic word, the time of its last refill in ms and its
+ * tokens in 1/1000, and it is updated by compare-and-swap. The map of
+ * buckets is sharded, looking up an existing bucket only takes the shared
+ * lock of its shard. Idle buckets are full, so they are dropped whenever a
+ * shard is full.
+ */
+class RateLimiter
+{
+public:
+
+    static constexpr size_t SHARD_COUNT = 16;
+
+    static constexpr size_t MAX_KEYS_PER_SHARD = 4096;
+
+    RateLimiter();
+
+    ~RateLimiter();
+
+    /**
+     * @brief must be called before the server is started
+     * @param rate tokens per second, 0 disables the limiter
+     * @param burst size of the buckets
+     */
+    u8 setLimit(f64 rate, u32 burst);
+
+    /**
+     * @brief must be called before the server is started
+     * @param method "/package.ServiceName/MethodName"
+     */
+    void setCost(const std::string &method, u32 cost);
+
+    bool isEnabled() const;
+
+    u32 costOf(const std::string &method) const;
+
+    /**
+     * @brief take cost tokens from the bucket of key
+     * @return u64 0 if it is allowed,
+     * otherwise how long to wait in ms before retrying
+     */
+    u64 acquire(const std::string &key, u32 cost);
+
+private:
+
+    typedef struct Shard
+    {
+        std::shared_mutex mutex;
+        std::unordered_map<std::string, std::unique_ptr<std::atomic<u64>>> buckets;
+    } Shard;
+
+    std::array<Shard, SHARD_COUNT> m_shards;
+
+    std::unordered_map<std::string, u32> m_costs;
+
+    f64 m_rate = 0; // milli tokens per ms
+
+    u64 m_capacity = 0; // in milli tokens
+
+    std::chrono::steady_clock::time_point m_epoch;
+
+    Shard &shardOf(const std::string &key);
+
+    u32 nowMs() const;
+
+    u64 take(std::atomic<u64> &bucket, u32 now, u64 need) const;
+
+    u64 refill(u64 state, u32 now) const;
+
+}; // end class RateLimiter
+
+} // end namespace Auth
+
+} // end namespace Model
+
+#endif // _MODEL_AUTH_RATELIMITER_HPP_
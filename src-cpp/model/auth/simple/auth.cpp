@@ -42,6 +42,25 @@ namespace Auth
 namespace Simple
 {
 
+// the shape of genToken, the hex of a sha512
+static bool isSessionToken(const std::string &token)
+{
+    if (token.size() != 128)
+    {
+        return false;
+    }
+
+    for (char c : token)
+    {
+        if (!((c >= '0' && c <= '9') || (c >= 'a' && c <= 'f')))
+        {
+            return false;
+        }
+    }
+
+    return true;
+}
+
 Auth::Auth()
 {}
 
@@ -53,11 +72,9 @@ u8 Auth::login(const std::string &username,
                const std::string &otp,
                std::string &token)
 {
-    spdlog::debug("{}:{} Model::Auth::Simple::Auth::login",
+    FF_DEBUG("{}:{} Model::Auth::Simple::Auth::login",
                   LOG_FILE_PATH(__FILE__), __LINE__);
-    spdlog::debug("username: {}", username);
-    spdlog::debug("password: {}", password);
-    spdlog::debug("otp: {}", otp);
+    FF_DEBUG("username: {}", username);
 
     if (unBanUser())
     {
@@ -96,11 +113,23 @@ u8 Auth::login(const std::string &username,
     }
 
     std::vector<u8> hash;
-    if (Crypto::argon2id(password, salt, hash))
+    switch (kdfPool.argon2id(password, salt, hash))
+    {
+    case 0:
+    {
+        break;
+    }
+    case 2:
+    {
+        spdlog::error("{}:{} too many logins", LOG_FILE_PATH(__FILE__), __LINE__);
+        return 2;
+    }
+    default:
     {
         spdlog::error("{}:{} argon2id failed", LOG_FILE_PATH(__FILE__), __LINE__);
         return 1;
     }
+    }
 
     if (hash != this->password)
     {
@@ -110,24 +139,40 @@ u8 Auth::login(const std::string &username,
         return 1;
     }
 
-    if (genToken())
+    u64 now = std::time(nullptr);
+    if (signedToken.isEnabled())
+    {
+        if (signedToken.issue(username, now + tokenTimeout, token))
+        {
+            spdlog::error("{}:{} fail to issue token",
+                LOG_FILE_PATH(__FILE__), __LINE__);
+            return 1;
+        }
+
+        std::unique_lock<std::mutex> lock(m_banMutex);
+        m_retry = 0;
+        return 0;
+    }
+
+    if (genToken(token))
     {
         spdlog::error("{}:{} genToken failed", LOG_FILE_PATH(__FILE__), __LINE__);
         return 1;
     }
 
-    token = m_currentToken;
+    // every login gets its own session, earlier ones stay valid
+    m_sessions.insert(token, username, now + tokenTimeout);
+    m_sessions.sweep(now);
+    std::unique_lock<std::mutex> lock(m_banMutex);
     m_retry = 0;
-    m_lastAccess = std::time(nullptr);
     return 0;
 }
 
 u8 Auth::logout(const std::string &username, const std::string &token)
 {
-    spdlog::debug("{}:{} Model::Auth::Simple::Auth::logout",
+    FF_DEBUG("{}:{} Model::Auth::Simple::Auth::logout",
         LOG_FILE_PATH(__FILE__), __LINE__);
-    spdlog::debug("username: {}", username);
-    spdlog::debug("token: {}", token);
+    FF_DEBUG("username: {}", username);
 
     if (username.empty() || token.empty())
     {
@@ -136,40 +181,51 @@ u8 Auth::logout(const std::string &username, const std::string &token)
         return 1;
     }
 
+    if (username != this->username)
     {
-        std::unique_lock<std::mutex> lock(m_mutex);
-
-        if (username != this->username)
-        {
-            spdlog::error("{}:{} username is invalid",
-                LOG_FILE_PATH(__FILE__), __LINE__);
-            return 1;
-        }
-
-        if (m_currentToken.empty())
-        {
-            spdlog::warn("{}:{} token is empty", LOG_FILE_PATH(__FILE__), __LINE__);
-            return 0; // already logout
-        }
+        spdlog::error("{}:{} username is invalid",
+            LOG_FILE_PATH(__FILE__), __LINE__);
+        return 1;
+    }
 
-        if (token != m_currentToken)
+    if (signedToken.isEnabled())
+    {
+        // signed tokens are stateless, they are valid until they expire
+        if (signedToken.verify(token, username, std::time(nullptr)) == 1)
         {
             spdlog::error("{}:{} token is invalid",
                 LOG_FILE_PATH(__FILE__), __LINE__);
             return 1;
         }
 
-        m_currentToken = "";
+        return 0;
     }
 
-    return 0;
+    switch (m_sessions.erase(token, username))
+    {
+    case 0:
+    {
+        return 0;
+    }
+    case 1:
+    {
+        spdlog::warn("{}:{} session is not found", LOG_FILE_PATH(__FILE__), __LINE__);
+        return 0; // already logout or expired
+    }
+    default:
+    {
+        spdlog::error("{}:{} token is invalid",
+            LOG_FILE_PATH(__FILE__), __LINE__);
+        return 1;
+    }
+    }
 }
 
 u8 Auth::cannotAccess(const std::string &ip)
 {
-    spdlog::debug("{}:{} Model::Auth::Simple::Auth::cannotAccess",
+    FF_DEBUG("{}:{} Model::Auth::Simple::Auth::cannotAccess",
                   LOG_FILE_PATH(__FILE__), __LINE__);
-    spdlog::debug("ip: {}", ip);
+    FF_DEBUG("ip: {}", ip);
 
     if (ip.empty())
     {
@@ -177,28 +233,10 @@ u8 Auth::cannotAccess(const std::string &ip)
         return 1;
     }
 
-    std::unique_lock<std::mutex> lock(m_mutex);
-
-    auto it = m_ipBanList.find(ip);
-    if (it != m_ipBanList.end())
+    if (ipBans.isBanned(ip, std::time(nullptr), banTime))
     {
-        // check it is unbanned or not
-        if (it->second.isNotBaned)
-        {
-            return 0;
-        }
-
-        // isNotBanned == false
-        u64 now = std::time(nullptr);
-        if ((now - it->second.lastAccess) <= banTime)
-        {
-            it->second.lastAccess = now;
-            spdlog::error("{}:{} ip is banned",
-                LOG_FILE_PATH(__FILE__), __LINE__);        
-            return 1;
-        }
-        
-        m_ipBanList.erase(it);
+        spdlog::error("{}:{} ip is banned", LOG_FILE_PATH(__FILE__), __LINE__);
+        return 1;
     }
 
     return 0;
@@ -206,10 +244,9 @@ u8 Auth::cannotAccess(const std::string &ip)
 
 u8 Auth::cannotAccess(const std::string &ip, const std::string &token)
 {
-    spdlog::debug("{}:{} Model::Auth::Simple::Auth::cannotAccess",
+    FF_DEBUG("{}:{} Model::Auth::Simple::Auth::cannotAccess",
         LOG_FILE_PATH(__FILE__), __LINE__);
-    spdlog::debug("ip: {}", ip);
-    spdlog::debug("token: {}", token);
+    FF_DEBUG("ip: {}", ip);
 
     if (cannotAccess(ip))
     {
@@ -218,93 +255,82 @@ u8 Auth::cannotAccess(const std::string &ip, const std::string &token)
         return 1;
     }
 
-    if (m_currentToken.empty())
+    switch (verifyToken(token))
     {
-        addBannedIp(ip);
-        spdlog::error("{}:{} client is not login and access the server",
+    case 0:
+    {
+        break;
+    }
+    case 2:
+    {
+        spdlog::error("{}:{} token is expired",
             LOG_FILE_PATH(__FILE__), __LINE__);
         return 1;
     }
-
-    if (token != m_currentToken)
+    default:
     {
+        // every call in flight after a restart carries the old session,
+        // so only a malformed one or a bad mac counts towards a ban
+        if (!signedToken.isEnabled() && isSessionToken(token))
+        {
+            spdlog::error("{}:{} token is unknown",
+                LOG_FILE_PATH(__FILE__), __LINE__);
+            return 1;
+        }
+
         addBannedIp(ip);
         spdlog::error("{}:{} token is invalid",
             LOG_FILE_PATH(__FILE__), __LINE__);
         return 1;
     }
-
-    u64 now = std::time(nullptr);
-    if ((now - m_lastAccess) > tokenTimeout)
-    {
-        // token expired
-        m_currentToken = "";
-        return 1;
     }
 
     // reset failed time
-    auto it = m_ipBanList.find(ip);
-    if (it != m_ipBanList.end())
-    {
-        m_ipBanList.erase(it);
-    }
-
+    removeBannedIp(ip);
     return 0;
 }
 
-void Auth::addBannedIp(const std::string &ip)
+u8 Auth::cannotAccessByToken(const std::string &token)
 {
-    spdlog::debug("{}:{} Model::Auth::Simple::Auth::addBannedIp",
+    FF_DEBUG("{}:{} Model::Auth::Simple::Auth::cannotAccessByToken",
         LOG_FILE_PATH(__FILE__), __LINE__);
-    spdlog::debug("ip: {}", ip);
 
-    std::unique_lock<std::mutex> lock(m_mutex);
-
-    auto it = m_ipBanList.find(ip);
-    if (it != m_ipBanList.end())
+    if (verifyToken(token))
     {
-        if (it->second.isNotBaned == false)
-        {
-            it->second.lastAccess = std::time(nullptr);
-            return;
-        }
+        spdlog::error("{}:{} token is invalid or expired",
+            LOG_FILE_PATH(__FILE__), __LINE__);
+        return 1;
+    }
 
-        ++it->second.retry;
-        if (it->second.retry > maxRetry)
-        {
-            it->second.isNotBaned = false;
-            it->second.lastAccess = std::time(nullptr);
-        }
+    return 0;
+}
 
-        return;
-    }
+void Auth::addBannedIp(const std::string &ip)
+{
+    FF_DEBUG("{}:{} Model::Auth::Simple::Auth::addBannedIp",
+        LOG_FILE_PATH(__FILE__), __LINE__);
+    FF_DEBUG("ip: {}", ip);
 
-    m_ipBanList[ip].retry = 1;
+    ipBans.fail(ip, std::time(nullptr), banTime, maxRetry);
 }
 
 void Auth::removeBannedIp(const std::string &ip)
 {
-    spdlog::debug("{}:{} Model::Auth::Simple::Auth::removeBannedIp",
+    FF_DEBUG("{}:{} Model::Auth::Simple::Auth::removeBannedIp",
         LOG_FILE_PATH(__FILE__), __LINE__);
-    spdlog::debug("ip: {}", ip);
-
-    std::unique_lock<std::mutex> lock(m_mutex);
+    FF_DEBUG("ip: {}", ip);
 
-    auto it = m_ipBanList.find(ip);
-    if (it != m_ipBanList.end())
-    {
-        m_ipBanList.erase(it);
-    }
+    ipBans.erase(ip);
 }
 
 // private member functions
-u8 Auth::genToken()
+u8 Auth::genToken(std::string &out)
 {
-    spdlog::debug("{}:{} Model::Auth::Simple::Auth::genToken",
+    FF_DEBUG("{}:{} Model::Auth::Simple::Auth::genToken",
                   LOG_FILE_PATH(__FILE__), __LINE__);
     
-    std::vector<u8> out = std::vector<u8>(16);
-    if (RAND_bytes(out.data(), out.size()) != 1)
+    std::vector<u8> buf = std::vector<u8>(16);
+    if (RAND_bytes(buf.data(), buf.size()) != 1)
     {
         spdlog::error("{}:{} OpenSSL RAND_bytes failed",
             LOG_FILE_PATH(__FILE__), __LINE__);
@@ -313,22 +339,33 @@ u8 Auth::genToken()
 
     std::stringstream ss;
     ss << std::hex << std::setfill('0');
-    for (u8 b : out)
+    for (u8 b : buf)
     {
         ss << std::setw(2) << (int)b;
     }
 
-    std::unique_lock<std::mutex> lock(m_mutex);
-    m_currentToken = username + ss.str();
-    m_currentToken = Crypto::sha512(m_currentToken);
+    out = Crypto::sha512(username + ss.str());
     return 0;
 }
 
+u8 Auth::verifyToken(const std::string &token)
+{
+    u64 now = std::time(nullptr);
+    if (signedToken.isEnabled())
+    {
+        return signedToken.verify(token, username, now);
+    }
+
+    m_sessions.sweep(now);
+    return m_sessions.find(token, now);
+}
+
 void Auth::banUser()
 {
-    spdlog::debug("{}:{} Model::Auth::Simple::Auth::banUser",
+    FF_DEBUG("{}:{} Model::Auth::Simple::Auth::banUser",
         LOG_FILE_PATH(__FILE__), __LINE__);
     
+    std::unique_lock<std::mutex> lock(m_banMutex);
     ++m_retry;
     if (m_retry > maxRetry)
     {
@@ -339,9 +376,10 @@ void Auth::banUser()
 
 u8 Auth::unBanUser()
 {
-    spdlog::debug("{}:{} Model::Auth::Simple::Auth::unBanUser",
+    FF_DEBUG("{}:{} Model::Auth::Simple::Auth::unBanUser",
         LOG_FILE_PATH(__FILE__), __LINE__);
     
+    std::unique_lock<std::mutex> lock(m_banMutex);
     if (m_baned)
     {
         u64 now = std::time(nullptr);
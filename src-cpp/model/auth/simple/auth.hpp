@@ -24,12 +24,17 @@
 #ifndef _MODEL_AUTH_SIMPLE_AUTH_HPP_
 #define _MODEL_AUTH_SIMPLE_AUTH_HPP_
 
-#include <unordered_map>
+#include <mutex>
 #include <vector>
 
 #include "model/auth/iauth.hpp"
+#include "model/auth/kdfpool.hpp"
 #include "model/defines.h"
 
+#include "bantable.hpp"
+#include "sessiontable.hpp"
+#include "signedtoken.hpp"
+
 namespace Model
 {
 
@@ -39,13 +44,6 @@ namespace Auth
 namespace Simple
 {
 
-typedef struct IPData
-{
-    u8 retry = 0;
-    u64 lastAccess = 0;
-    bool isNotBaned = true;
-} IPData;
-
 class Auth : public IAuth
 {
 
@@ -66,6 +64,8 @@ public:
 
     virtual u8 cannotAccess(const std::string &ip, const std::string &token) override;
 
+    virtual u8 cannotAccessByToken(const std::string &token) override;
+
     virtual void addBannedIp(const std::string &ip) override;
 
     virtual void removeBannedIp(const std::string &ip) override;
@@ -84,21 +84,32 @@ public:
 
     u64 tokenTimeout = 86400; // 24hr
 
+    // issue stateless tokens instead of sessions when its key is set
+    SignedToken signedToken;
+
+    // runs the password hash of login
+    KdfPool kdfPool;
+
+    // failed attempts and bans by client ip
+    BanTable ipBans;
+
 private:
 
+    // guards m_retry, m_lastAccess and m_baned, logins run concurrently
+    std::mutex m_banMutex;
+
+    // 0 if the token is valid, 1 if it is invalid, 2 if it is expired
+    u8 verifyToken(const std::string &token);
+
     u64 m_retry = 0;
 
     u64 m_lastAccess = 0;
 
     bool m_baned = false;
 
-    std::unordered_map<std::string, IPData> m_ipBanList;
-
-    std::string m_currentToken = "";
-
-    std::mutex m_mutex;
+    SessionTable m_sessions;
 
-    u8 genToken();
+    u8 genToken(std::string &out);
 
     void banUser();
 
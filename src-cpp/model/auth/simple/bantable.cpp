@@ -0,0 +1,181 @@
+/*
+ * Flex Flow
+ * Copyright (c) 2026-present fdar0536
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include "spdlog/spdlog.h"
+
+#include "model/utils.hpp"
+
+#include "bantable.hpp"
+
+namespace Model
+{
+
+namespace Auth
+{
+
+namespace Simple
+{
+
+static constexpr size_t defaultCapacity = 65536;
+
+BanTable::BanTable() :
+    m_shardCapacity(defaultCapacity / SHARD_COUNT),
+    m_evicted(Metrics::registry().counter("ff_auth_ban_evicted_total"))
+{}
+
+BanTable::~BanTable()
+{}
+
+void BanTable::setCapacity(size_t capacity)
+{
+    FF_DEBUG("{}:{} Model::Auth::Simple::BanTable::setCapacity",
+        LOG_FILE_PATH(__FILE__), __LINE__);
+    FF_DEBUG("capacity: {}", capacity);
+
+    if (!capacity)
+    {
+        capacity = defaultCapacity;
+    }
+
+    m_shardCapacity = (capacity + SHARD_COUNT - 1) / SHARD_COUNT;
+}
+
+u8 BanTable::isBanned(const std::string &ip, const u64 now, const u64 ttl)
+{
+    FF_DEBUG("{}:{} Model::Auth::Simple::BanTable::isBanned",
+        LOG_FILE_PATH(__FILE__), __LINE__);
+
+    Shard &shard = shardOf(ip);
+    std::unique_lock<std::mutex> lock(shard.mutex);
+    expire(shard, now, ttl);
+
+    auto it = shard.index.find(ip);
+    if (it == shard.index.end() || !it->second->banned)
+    {
+        return 0;
+    }
+
+    // expired entries are evicted above, so it is still banned
+    it->second->lastAccess = now;
+    shard.lru.splice(shard.lru.begin(), shard.lru, it->second);
+    return 1;
+}
+
+void BanTable::fail(const std::string &ip,
+                    const u64 now,
+                    const u64 ttl,
+                    const u8 maxRetry)
+{
+    FF_DEBUG("{}:{} Model::Auth::Simple::BanTable::fail",
+        LOG_FILE_PATH(__FILE__), __LINE__);
+
+    Shard &shard = shardOf(ip);
+    std::unique_lock<std::mutex> lock(shard.mutex);
+    expire(shard, now, ttl);
+
+    auto it = shard.index.find(ip);
+    if (it == shard.index.end())
+    {
+        if (shard.index.size() >= m_shardCapacity)
+        {
+            shard.index.erase(shard.lru.back().ip);
+            shard.lru.pop_back();
+            m_evicted->add();
+        }
+
+        shard.lru.push_front(Entry());
+        shard.lru.front().ip = ip;
+        it = shard.index.emplace(ip, shard.lru.begin()).first;
+    }
+    else
+    {
+        shard.lru.splice(shard.lru.begin(), shard.lru, it->second);
+    }
+
+    Entry &entry = *it->second;
+    entry.lastAccess = now;
+    if (entry.banned)
+    {
+        return;
+    }
+
+    ++entry.retry;
+    if (entry.retry > maxRetry)
+    {
+        entry.banned = true;
+    }
+}
+
+void BanTable::erase(const std::string &ip)
+{
+    FF_DEBUG("{}:{} Model::Auth::Simple::BanTable::erase",
+        LOG_FILE_PATH(__FILE__), __LINE__);
+
+    Shard &shard = shardOf(ip);
+    std::unique_lock<std::mutex> lock(shard.mutex);
+    auto it = shard.index.find(ip);
+    if (it != shard.index.end())
+    {
+        shard.lru.erase(it->second);
+        shard.index.erase(it);
+    }
+}
+
+size_t BanTable::size() const
+{
+    size_t out(0);
+    for (auto it = m_shards.begin(); it != m_shards.end(); ++it)
+    {
+        std::unique_lock<std::mutex> lock(it->mutex);
+        out += it->index.size();
+    }
+
+    return out;
+}
+
+// private member functions
+BanTable::Shard &BanTable::shardOf(const std::string &ip)
+{
+    return m_shards[std::hash<std::string>{}(ip) % SHARD_COUNT];
+}
+
+void BanTable::expire(Shard &shard, const u64 now, const u64 ttl)
+{
+    for (size_t i = 0; i < EXPIRE_BATCH && !shard.lru.empty(); ++i)
+    {
+        const Entry &entry = shard.lru.back();
+        if (now - entry.lastAccess <= ttl)
+        {
+            return;
+        }
+
+        shard.index.erase(entry.ip);
+        shard.lru.pop_back();
+    }
+}
+
+} // end namespace Simple
+
+} // end namespace Auth
+
+} // end namespace Model
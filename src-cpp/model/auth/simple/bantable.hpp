@@ -0,0 +1,124 @@
+/*
+ * Flex Flow
+ * Copyright (c) 2026-present fdar0536
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#ifndef _MODEL_AUTH_SIMPLE_BANTABLE_HPP_
+#define _MODEL_AUTH_SIMPLE_BANTABLE_HPP_
+
+#include <array>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+
+#include "model/defines.h"
+#include "model/metrics/metrics.hpp"
+
+namespace Model
+{
+
+namespace Auth
+{
+
+namespace Simple
+{
+
+/**
+ * @brief failed attempts and bans by client ip, with a fixed capacity
+ *
+ * Every shard is an LRU list. An entry moves to the front whenever its
+ * last access is updated, so the back of the list is always the entry
+ * which expires first. Each call evicts a few expired entries from the
+ * back, and a full shard drops its least recently used entry.
+ */
+class BanTable
+{
+public:
+
+    static constexpr size_t SHARD_COUNT = 16;
+
+    static constexpr size_t EXPIRE_BATCH = 8;
+
+    BanTable();
+
+    ~BanTable();
+
+    /**
+     * @brief the total count of ips to track, 0 means the default 65536
+     */
+    void setCapacity(size_t capacity);
+
+    /**
+     * @param ttl how long a ban or failed attempts are kept in seconds
+     * @return u8 1 if the ip is banned, its ban is extended
+     */
+    u8 isBanned(const std::string &ip, const u64 now, const u64 ttl);
+
+    /**
+     * @brief record a failed attempt, the ip is banned after maxRetry
+     */
+    void fail(const std::string &ip,
+              const u64 now,
+              const u64 ttl,
+              const u8 maxRetry);
+
+    void erase(const std::string &ip);
+
+    size_t size() const;
+
+private:
+
+    typedef struct Entry
+    {
+        std::string ip;
+        u8 retry = 0;
+        u64 lastAccess = 0;
+        bool banned = false;
+    } Entry;
+
+    typedef struct Shard
+    {
+        mutable std::mutex mutex;
+        std::list<Entry> lru; // most recent first
+        std::unordered_map<std::string, std::list<Entry>::iterator> index;
+    } Shard;
+
+    std::array<Shard, SHARD_COUNT> m_shards;
+
+    size_t m_shardCapacity;
+
+    std::shared_ptr<Metrics::Counter> m_evicted;
+
+    Shard &shardOf(const std::string &ip);
+
+    void expire(Shard &shard, const u64 now, const u64 ttl);
+
+}; // end class BanTable
+
+} // end namespace Simple
+
+} // end namespace Auth
+
+} // end namespace Model
+
+#endif // _MODEL_AUTH_SIMPLE_BANTABLE_HPP_
@@ -0,0 +1,193 @@
+/*
+ * Flex Flow
+ * Copyright (c) 2026-present fdar0536
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include <ctime>
+
+#include "spdlog/spdlog.h"
+
+#include "model/utils.hpp"
+
+#include "sessiontable.hpp"
+
+namespace Model
+{
+
+namespace Auth
+{
+
+namespace Simple
+{
+
+SessionTable::SessionTable() :
+    m_lastSweepSlot(static_cast<u64>(std::time(nullptr)) / WHEEL_SLOT_SECONDS)
+{}
+
+SessionTable::~SessionTable()
+{}
+
+void SessionTable::insert(const std::string &token,
+                          const std::string &username,
+                          const u64 expireAt)
+{
+    FF_DEBUG("{}:{} Model::Auth::Simple::SessionTable::insert",
+        LOG_FILE_PATH(__FILE__), __LINE__);
+
+    {
+        Shard &shard = shardOf(token);
+        std::unique_lock<std::shared_mutex> lock(shard.mutex);
+        Session &session = shard.sessions[token];
+        session.username = username;
+        session.expireAt = expireAt;
+    }
+
+    std::unique_lock<std::mutex> lock(m_wheelMutex);
+    m_wheel[(expireAt / WHEEL_SLOT_SECONDS) % WHEEL_SIZE].push_back(token);
+}
+
+u8 SessionTable::find(const std::string &token, const u64 now) const
+{
+    const Shard &shard = shardOf(token);
+    std::shared_lock<std::shared_mutex> lock(shard.mutex);
+    auto it = shard.sessions.find(token);
+    if (it == shard.sessions.end())
+    {
+        return 1;
+    }
+
+    if (it->second.expireAt <= now)
+    {
+        return 2;
+    }
+
+    return 0;
+}
+
+u8 SessionTable::erase(const std::string &token, const std::string &username)
+{
+    FF_DEBUG("{}:{} Model::Auth::Simple::SessionTable::erase",
+        LOG_FILE_PATH(__FILE__), __LINE__);
+
+    // the wheel entry is dropped by the next sweep
+    Shard &shard = shardOf(token);
+    std::unique_lock<std::shared_mutex> lock(shard.mutex);
+    auto it = shard.sessions.find(token);
+    if (it == shard.sessions.end())
+    {
+        return 1;
+    }
+
+    if (it->second.username != username)
+    {
+        return 2;
+    }
+
+    shard.sessions.erase(it);
+    return 0;
+}
+
+size_t SessionTable::sweep(const u64 now)
+{
+    u64 currentSlot = now / WHEEL_SLOT_SECONDS;
+    if (currentSlot <= m_lastSweepSlot.load(std::memory_order_relaxed))
+    {
+        return 0;
+    }
+
+    std::unique_lock<std::mutex> wheelLock(m_wheelMutex, std::try_to_lock);
+    if (!wheelLock.owns_lock())
+    {
+        return 0;
+    }
+
+    FF_DEBUG("{}:{} Model::Auth::Simple::SessionTable::sweep",
+        LOG_FILE_PATH(__FILE__), __LINE__);
+
+    u64 slot = m_lastSweepSlot.load(std::memory_order_relaxed);
+    if (currentSlot - slot > WHEEL_SIZE)
+    {
+        // every slot is due, visit each one once
+        slot = currentSlot - WHEEL_SIZE;
+    }
+
+    size_t evicted(0);
+    for (++slot; slot <= currentSlot; ++slot)
+    {
+        std::vector<std::string> &tokens = m_wheel[slot % WHEEL_SIZE];
+        std::vector<std::string> remain;
+        for (auto it = tokens.begin(); it != tokens.end(); ++it)
+        {
+            Shard &shard = shardOf(*it);
+            std::unique_lock<std::shared_mutex> lock(shard.mutex);
+            auto session = shard.sessions.find(*it);
+            if (session == shard.sessions.end())
+            {
+                // already logged out
+                continue;
+            }
+
+            if (session->second.expireAt <= now)
+            {
+                shard.sessions.erase(session);
+                ++evicted;
+                continue;
+            }
+
+            // expires in a later round of the wheel
+            remain.push_back(std::move(*it));
+        }
+
+        tokens.swap(remain);
+    }
+
+    m_lastSweepSlot.store(currentSlot, std::memory_order_relaxed);
+    return evicted;
+}
+
+size_t SessionTable::size() const
+{
+    size_t out(0);
+    for (auto it = m_shards.begin(); it != m_shards.end(); ++it)
+    {
+        std::shared_lock<std::shared_mutex> lock(it->mutex);
+        out += it->sessions.size();
+    }
+
+    return out;
+}
+
+// private member functions
+SessionTable::Shard &SessionTable::shardOf(const std::string &token)
+{
+    return m_shards[std::hash<std::string>{}(token) % SHARD_COUNT];
+}
+
+const SessionTable::Shard &SessionTable::shardOf(const std::string &token) const
+{
+    return m_shards[std::hash<std::string>{}(token) % SHARD_COUNT];
+}
+
+} // end namespace Simple
+
+} // end namespace Auth
+
+} // end namespace Model
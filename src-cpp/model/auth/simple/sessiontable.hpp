@@ -0,0 +1,130 @@
+/*
+ * Flex Flow
+ * Copyright (c) 2026-present fdar0536
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#ifndef _MODEL_AUTH_SIMPLE_SESSIONTABLE_HPP_
+#define _MODEL_AUTH_SIMPLE_SESSIONTABLE_HPP_
+
+#include <array>
+#include <atomic>
+#include <mutex>
+#include <shared_mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "model/defines.h"
+
+namespace Model
+{
+
+namespace Auth
+{
+
+namespace Simple
+{
+
+/**
+ * @brief logged in sessions, keyed by token
+ *
+ * Tokens are spread over shards, so validating a token only takes the
+ * shared lock of one shard. Expired sessions are rejected right away and
+ * evicted by sweep(), which walks a timer wheel of one minute slots.
+ */
+class SessionTable
+{
+public:
+
+    static constexpr size_t SHARD_COUNT = 16;
+
+    static constexpr size_t WHEEL_SIZE = 64;
+
+    static constexpr u64 WHEEL_SLOT_SECONDS = 60;
+
+    SessionTable();
+
+    ~SessionTable();
+
+    /**
+     * @param expireAt unix time in seconds
+     */
+    void insert(const std::string &token,
+                const std::string &username,
+                const u64 expireAt);
+
+    /**
+     * @return u8 0 if the session is valid, 1 if it is not found,
+     * 2 if it is expired
+     */
+    u8 find(const std::string &token, const u64 now) const;
+
+    /**
+     * @return u8 0 if the session is removed, 1 if it is not found,
+     * 2 if it belongs to another user
+     */
+    u8 erase(const std::string &token, const std::string &username);
+
+    /**
+     * @brief evict the sessions in the wheel slots which are due,
+     * it returns immediately if another thread is sweeping or nothing is due
+     * @return size_t count of evicted sessions
+     */
+    size_t sweep(const u64 now);
+
+    size_t size() const;
+
+private:
+
+    typedef struct Session
+    {
+        std::string username;
+        u64 expireAt = 0;
+    } Session;
+
+    typedef struct Shard
+    {
+        mutable std::shared_mutex mutex;
+        std::unordered_map<std::string, Session> sessions;
+    } Shard;
+
+    std::array<Shard, SHARD_COUNT> m_shards;
+
+    // tokens by the slot of their expiry
+    std::array<std::vector<std::string>, WHEEL_SIZE> m_wheel;
+
+    std::mutex m_wheelMutex;
+
+    std::atomic<u64> m_lastSweepSlot;
+
+    Shard &shardOf(const std::string &token);
+
+    const Shard &shardOf(const std::string &token) const;
+
+}; // end class SessionTable
+
+} // end namespace Simple
+
+} // end namespace Auth
+
+} // end namespace Model
+
+#endif // _MODEL_AUTH_SIMPLE_SESSIONTABLE_HPP_
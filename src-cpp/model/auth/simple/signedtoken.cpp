@@ -0,0 +1,211 @@
+/*
+ * Flex Flow
+ * Copyright (c) 2026-present fdar0536
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include <charconv>
+
+#include "openssl/crypto.h"
+#include "openssl/rand.h"
+#include "spdlog/spdlog.h"
+
+#include "model/utils.hpp"
+#include "model/auth/crypto.hpp"
+
+#include "signedtoken.hpp"
+
+namespace Model
+{
+
+namespace Auth
+{
+
+namespace Simple
+{
+
+static const std::string prefix = "s1.";
+
+static void toHex(const u8 *data, size_t size, std::string &out)
+{
+    static const char digits[] = "0123456789abcdef";
+    for (size_t i = 0; i < size; ++i)
+    {
+        out.push_back(digits[data[i] >> 4]);
+        out.push_back(digits[data[i] & 0x0F]);
+    }
+}
+
+static i32 fromHexDigit(char c)
+{
+    if (c >= '0' && c <= '9') return c - '0';
+    if (c >= 'a' && c <= 'f') return c - 'a' + 10;
+    return -1;
+}
+
+static u8 fromHex(const std::string &hex, std::vector<u8> &out)
+{
+    if (hex.size() % 2)
+    {
+        return 1;
+    }
+
+    out.clear();
+    out.reserve(hex.size() / 2);
+    for (size_t i = 0; i < hex.size(); i += 2)
+    {
+        i32 high = fromHexDigit(hex[i]);
+        i32 low = fromHexDigit(hex[i + 1]);
+        if (high < 0 || low < 0)
+        {
+            return 1;
+        }
+
+        out.push_back(static_cast<u8>((high << 4) | low));
+    }
+
+    return 0;
+}
+
+u8 SignedToken::setKey(const std::vector<u8> &key)
+{
+    FF_DEBUG("{}:{} SignedToken::setKey", LOG_FILE_PATH(__FILE__), __LINE__);
+
+    if (key.size() < MIN_KEY_SIZE)
+    {
+        spdlog::error("{}:{} token key is too short",
+            LOG_FILE_PATH(__FILE__), __LINE__);
+        return 1;
+    }
+
+    m_key = key;
+    return 0;
+}
+
+bool SignedToken::isEnabled() const
+{
+    return !m_key.empty();
+}
+
+u8 SignedToken::issue(const std::string &username,
+                      const u64 expireAt,
+                      std::string &out) const
+{
+    FF_DEBUG("{}:{} SignedToken::issue", LOG_FILE_PATH(__FILE__), __LINE__);
+
+    if (!isEnabled())
+    {
+        spdlog::error("{}:{} token key is not set",
+            LOG_FILE_PATH(__FILE__), __LINE__);
+        return 1;
+    }
+
+    u8 nonce[16];
+    if (RAND_bytes(nonce, sizeof(nonce)) != 1)
+    {
+        spdlog::error("{}:{} OpenSSL RAND_bytes failed",
+            LOG_FILE_PATH(__FILE__), __LINE__);
+        return 1;
+    }
+
+    std::string payload = prefix + std::to_string(expireAt) + ".";
+    toHex(reinterpret_cast<const u8 *>(username.data()),
+          username.size(), payload);
+    payload.push_back('.');
+    toHex(nonce, sizeof(nonce), payload);
+
+    std::vector<u8> mac;
+    if (Crypto::hmacSha256(m_key, payload, mac))
+    {
+        return 1;
+    }
+
+    out = std::move(payload);
+    out.push_back('.');
+    toHex(mac.data(), mac.size(), out);
+    return 0;
+}
+
+u8 SignedToken::verify(const std::string &token,
+                       const std::string &username,
+                       const u64 now) const
+{
+    FF_DEBUG("{}:{} SignedToken::verify", LOG_FILE_PATH(__FILE__), __LINE__);
+
+    if (!isEnabled() || !isSignedToken(token))
+    {
+        return 1;
+    }
+
+    size_t macPos = token.rfind('.');
+    std::string payload = token.substr(0, macPos);
+    std::vector<u8> mac;
+    std::vector<u8> expected;
+    if (fromHex(token.substr(macPos + 1), mac) ||
+        Crypto::hmacSha256(m_key, payload, expected) ||
+        mac.size() != expected.size() ||
+        CRYPTO_memcmp(mac.data(), expected.data(), mac.size()))
+    {
+        return 1;
+    }
+
+    // the mac is valid, so the payload is made by issue()
+    size_t expirePos = prefix.size();
+    size_t userPos = payload.find('.', expirePos);
+    size_t noncePos = payload.find('.', userPos + 1);
+    if (userPos == std::string::npos || noncePos == std::string::npos)
+    {
+        return 1;
+    }
+
+    u64 expireAt(0);
+    auto res = std::from_chars(payload.data() + expirePos,
+                               payload.data() + userPos,
+                               expireAt);
+    if (res.ec != std::errc() || res.ptr != payload.data() + userPos)
+    {
+        return 1;
+    }
+
+    std::vector<u8> user;
+    if (fromHex(payload.substr(userPos + 1, noncePos - userPos - 1), user) ||
+        std::string(user.begin(), user.end()) != username)
+    {
+        return 1;
+    }
+
+    if (now >= expireAt)
+    {
+        return 2;
+    }
+
+    return 0;
+}
+
+bool SignedToken::isSignedToken(const std::string &token)
+{
+    return token.compare(0, prefix.size(), prefix) == 0;
+}
+
+} // end namespace Simple
+
+} // end namespace Auth
+
+} // end namespace Model
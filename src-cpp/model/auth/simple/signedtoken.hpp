@@ -0,0 +1,91 @@
+/*
+ * Flex Flow
+ * Copyright (c) 2026-present fdar0536
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#ifndef _MODEL_AUTH_SIMPLE_SIGNEDTOKEN_HPP_
+#define _MODEL_AUTH_SIMPLE_SIGNEDTOKEN_HPP_
+
+#include <string>
+#include <vector>
+
+#include "model/defines.h"
+
+namespace Model
+{
+
+namespace Auth
+{
+
+namespace Simple
+{
+
+/**
+ * @brief stateless tokens signed with HMAC-SHA256
+ *
+ * A token looks like s1.<expire at>.<hex username>.<hex nonce>.<hex mac>,
+ * the mac covers everything before it. Any server which has the same key
+ * can verify the token without shared state, but a token cannot be revoked
+ * before it expires.
+ */
+class SignedToken
+{
+public:
+
+    static constexpr size_t MIN_KEY_SIZE = 32;
+
+    /**
+     * @return u8 0 on success, 1 if the key is too short
+     */
+    u8 setKey(const std::vector<u8> &key);
+
+    bool isEnabled() const;
+
+    /**
+     * @param expireAt unix time in seconds
+     */
+    u8 issue(const std::string &username,
+             const u64 expireAt,
+             std::string &out) const;
+
+    /**
+     * @return u8 0 if the token is valid, 1 if it is invalid,
+     * 2 if it is expired
+     */
+    u8 verify(const std::string &token,
+              const std::string &username,
+              const u64 now) const;
+
+    static bool isSignedToken(const std::string &token);
+
+private:
+
+    std::vector<u8> m_key;
+
+}; // end class SignedToken
+
+} // end namespace Simple
+
+} // end namespace Auth
+
+} // end namespace Model
+
+#endif // _MODEL_AUTH_SIMPLE_SIGNEDTOKEN_HPP_
@@ -21,7 +21,11 @@
  * SOFTWARE.
  */
 
+#include <algorithm>
 #include <memory>
+
+#include "grpcpp/create_channel.h"
+#include "grpcpp/support/channel_arguments.h"
 #include "spdlog/spdlog.h"
 
 #include "model/utils.hpp"
@@ -39,23 +43,140 @@ namespace Connect
 namespace GRPC
 {
 
+// calls which can be sent twice without harm
+static const char *retryableMethods =
+    "{\"service\":\"ff.Access\",\"method\":\"Info\"},"
+    "{\"service\":\"ff.Access\",\"method\":\"Login\"},"
+    "{\"service\":\"ff.Queue\",\"method\":\"ListPending\"},"
+    "{\"service\":\"ff.Queue\",\"method\":\"ListFinished\"},"
+    "{\"service\":\"ff.Queue\",\"method\":\"PendingDetails\"},"
+    "{\"service\":\"ff.Queue\",\"method\":\"FinishedDetails\"},"
+    "{\"service\":\"ff.Queue\",\"method\":\"CurrentTask\"},"
+    "{\"service\":\"ff.Queue\",\"method\":\"IsRunning\"},"
+    "{\"service\":\"ff.Queue\",\"method\":\"ReadCurrentOutput\"},"
+    "{\"service\":\"ff.QueueList\",\"method\":\"List\"},"
+    "{\"service\":\"ff.QueueList\",\"method\":\"GetQueue\"}";
+
+static u8 buildChannelArgs(const ChannelOptions &options,
+                           grpc::ChannelArguments &args)
+{
+    FF_DEBUG("{}:{} Model::Connect::GRPC::buildChannelArgs",
+        LOG_FILE_PATH(__FILE__), __LINE__);
+
+    if (options.keepaliveTimeMs)
+    {
+        args.SetInt(GRPC_ARG_KEEPALIVE_TIME_MS,
+                    static_cast<int>(options.keepaliveTimeMs));
+        args.SetInt(GRPC_ARG_KEEPALIVE_TIMEOUT_MS,
+                    static_cast<int>(options.keepaliveTimeoutMs));
+        args.SetInt(GRPC_ARG_KEEPALIVE_PERMIT_WITHOUT_CALLS, 1);
+    }
+
+    args.SetMaxReceiveMessageSize(options.maxMessageSize);
+    args.SetMaxSendMessageSize(options.maxMessageSize);
+
+    if (options.compression == "gzip")
+    {
+        args.SetCompressionAlgorithm(GRPC_COMPRESS_GZIP);
+    }
+    else if (options.compression == "deflate")
+    {
+        args.SetCompressionAlgorithm(GRPC_COMPRESS_DEFLATE);
+    }
+    else if (options.compression != "none")
+    {
+        spdlog::error("{}:{} Invalid compression: {}",
+            LOG_FILE_PATH(__FILE__), __LINE__, options.compression);
+        return 1;
+    }
+
+    if (options.maxAttempts > 1)
+    {
+        args.SetInt(GRPC_ARG_ENABLE_RETRIES, 1);
+        args.SetServiceConfigJSON(fmt::format(
+            "{{\"methodConfig\":[{{\"name\":[{}],"
+            "\"retryPolicy\":{{\"maxAttempts\":{},"
+            "\"initialBackoff\":\"{:.3f}s\",\"maxBackoff\":\"{:.3f}s\","
+            "\"backoffMultiplier\":{},"
+            "\"retryableStatusCodes\":[\"UNAVAILABLE\",\"RESOURCE_EXHAUSTED\"]}}}}]}}",
+            retryableMethods,
+            options.maxAttempts,
+            options.initialBackoffMs / 1000.0,
+            options.maxBackoffMs / 1000.0,
+            options.backoffMultiplier));
+    }
+    else
+    {
+        args.SetInt(GRPC_ARG_ENABLE_RETRIES, 0);
+    }
+
+    return 0;
+}
+
+// call it with token.mutex locked
+static u8 login(Token &token, const std::string &otp)
+{
+    FF_DEBUG("{}:{} Model::Connect::GRPC::login",
+        LOG_FILE_PATH(__FILE__), __LINE__);
+
+    try
+    {
+        // get "access" node
+        auto stub = ff::Access::NewStub(token.channel);
+        if (stub == nullptr)
+        {
+            spdlog::error("{}:{} Fail to create access' stub",
+                LOG_FILE_PATH(__FILE__), __LINE__);
+            return 1;
+        }
+
+        // login target server
+        ff::LoginReq req;
+        req.set_username(token.username);
+        req.set_password(token.password);
+        req.set_otp(otp);
+
+        ff::LoginRes res;
+        grpc::ClientContext ctx;
+        DAO::GRPC::Utils::setupCtx(ctx, "", token.options.callTimeoutMs);
+        grpc::Status status = stub->Login(&ctx, req, &res);
+        if (!status.ok())
+        {
+            DAO::GRPC::Utils::buildErrMsg(
+                LOG_FILE_PATH(__FILE__), __LINE__, status);
+            return 1;
+        }
+
+        token.token = res.token();
+    }
+    catch (...)
+    {
+        spdlog::error("{}:{} Fail to login", LOG_FILE_PATH(__FILE__), __LINE__);
+        return 1;
+    }
+
+    return 0;
+}
+
 std::shared_ptr<Token> connect(
     const std::string &target,
     const u16 port,
     const std::string username,
     const std::string password,
-    const std::string otp)
+    const std::string otp,
+    const ChannelOptions &options)
 {
-    spdlog::debug("{}:{} Model::Connect::GRPC::connect",
+    FF_DEBUG("{}:{} Model::Connect::GRPC::connect",
         LOG_FILE_PATH(__FILE__), __LINE__);
 
     auto channel = std::shared_ptr<grpc::ChannelInterface>();
 
     std::string ip = target;
-    ip += ":";
-    ip += std::to_string(port);
-    std::unique_ptr<ff::Access::Stub> stub;
-
+    if (target.rfind("unix:", 0))
+    {
+        ip += ":";
+        ip += std::to_string(port);
+    }
     Token *token = new (std::nothrow) Token;
     if (!token)
     {
@@ -65,49 +186,26 @@ std::shared_ptr<Token> connect(
     }
 
     auto ret = std::shared_ptr<Token>(token);
+    ret->username = username;
+    ret->password = password;
+    ret->options = options;
 
     try
     {
         // connect to server
-        channel = grpc::CreateChannel(ip, 
-            grpc::InsecureChannelCredentials());
-
-        if (channel == nullptr)
-        {
-            spdlog::error("{}:{} Fail to create channel",
-                LOG_FILE_PATH(__FILE__), __LINE__);
-            return nullptr;
-        }
-
-        // get "access" node
-        stub = ff::Access::NewStub(channel);
-        if (stub == nullptr)
+        grpc::ChannelArguments args;
+        if (buildChannelArgs(options, args))
         {
-            spdlog::error("{}:{} Fail to create access' stub",
-                LOG_FILE_PATH(__FILE__), __LINE__);
             return nullptr;
         }
 
-        // login target server
-        ff::LoginReq req;
-        req.set_username(username);
-        req.set_password(password);
-        req.set_otp(otp);
+        channel = grpc::CreateCustomChannel(ip,
+            grpc::InsecureChannelCredentials(), args);
 
-        ff::LoginRes res;
-        grpc::ClientContext ctx;
-        DAO::GRPC::Utils::setupCtx(ctx);
-        grpc::Status status = stub->Login(&ctx, req, &res);
-
-        if (status.ok())
-        {
-            ret->token = res.token();
-            ret->channel = channel;
-        }
-        else
+        if (channel == nullptr)
         {
-            DAO::GRPC::Utils::buildErrMsg(
-                LOG_FILE_PATH(__FILE__), __LINE__, status);
+            spdlog::error("{}:{} Fail to create channel",
+                LOG_FILE_PATH(__FILE__), __LINE__);
             return nullptr;
         }
     }
@@ -118,9 +216,51 @@ std::shared_ptr<Token> connect(
         return nullptr;
     }
 
+    ret->channel = channel;
+    std::unique_lock<std::mutex> lock(ret->mutex);
+    if (login(*ret, otp))
+    {
+        return nullptr;
+    }
+
+    // only refresh() needs it, do not keep it for the whole process
+    if (!options.otpProvider)
+    {
+        std::fill(ret->password.begin(), ret->password.end(), '\0');
+        ret->password.clear();
+        ret->password.shrink_to_fit();
+    }
+
     return ret;
 }
 
+std::string currentToken(Token &token)
+{
+    std::unique_lock<std::mutex> lock(token.mutex);
+    return token.token;
+}
+
+u8 refresh(Token &token, const std::string &stale)
+{
+    FF_DEBUG("{}:{} Model::Connect::GRPC::refresh",
+        LOG_FILE_PATH(__FILE__), __LINE__);
+
+    std::unique_lock<std::mutex> lock(token.mutex);
+    if (token.token != stale)
+    {
+        return 0; // refreshed by another call
+    }
+
+    if (!token.options.otpProvider)
+    {
+        spdlog::error("{}:{} token is rejected and there is no otp provider",
+            LOG_FILE_PATH(__FILE__), __LINE__);
+        return 1;
+    }
+
+    return login(token, token.options.otpProvider());
+}
+
 } // end namespace GRPC
 
 } // end namespace Connect
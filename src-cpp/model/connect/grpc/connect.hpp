@@ -24,6 +24,9 @@
 #ifndef _MODEL_CONNECT_GRPC_CONNECT_HPP_
 #define _MODEL_CONNECT_GRPC_CONNECT_HPP_
 
+#include <functional>
+#include <mutex>
+
 #include "access.grpc.pb.h"
 
 #include "model/defines.h"
@@ -37,18 +40,67 @@ namespace Connect
 namespace GRPC
 {
 
+typedef struct ChannelOptions
+{
+    // 0 disables keepalive pings
+    u32 keepaliveTimeMs = 30000;
+
+    u32 keepaliveTimeoutMs = 10000;
+
+    // in bytes, -1 means unlimited
+    i32 maxMessageSize = 16 * 1024 * 1024;
+
+    // none, deflate or gzip
+    std::string compression = "none";
+
+    // read-only calls are retried on UNAVAILABLE and RESOURCE_EXHAUSTED,
+    // 1 disables retries
+    u32 maxAttempts = 3;
+
+    u32 initialBackoffMs = 200;
+
+    u32 maxBackoffMs = 5000;
+
+    f64 backoffMultiplier = 2;
+
+    // deadline of every call, 0 means FF_CLIENT_TIMEOUT seconds
+    u64 callTimeoutMs = 0;
+
+    // optional, returns a fresh otp to login again when the token is rejected
+    std::function<std::string()> otpProvider;
+} ChannelOptions;
+
 typedef struct Token
 {
-    std::string token;
+    std::string token; // use currentToken() after connect() returns
     std::shared_ptr<grpc::ChannelInterface> channel;
+    std::string username;
+    std::string password; // empty after connect() without an otp provider
+    ChannelOptions options;
+    std::mutex mutex;
 } Token;
 
+/**
+ * @brief login to the server
+ * @param target ip or host name, or a "unix:" path, port is ignored for it
+ */
 std::shared_ptr<Token> connect(
     const std::string &target,
     const u16 port,
     const std::string username,
     const std::string password,
-    const std::string otp);
+    const std::string otp,
+    const ChannelOptions &options = ChannelOptions());
+
+std::string currentToken(Token &token);
+
+/**
+ * @brief login again on the same channel
+ * @param stale the token which is rejected, nothing is done if another
+ * caller has replaced it already
+ * @return u8 0 on success, 1 if failed or there is no otp provider
+ */
+u8 refresh(Token &token, const std::string &stale);
 
 } // end namespace GRPC
 
@@ -38,7 +38,7 @@ namespace SQLite
 
 std::shared_ptr<Token> connect(std::string &target)
 {
-    spdlog::debug("{}:{} Model::Connect::SQLite::connect",
+    FF_DEBUG("{}:{} Model::Connect::SQLite::connect",
         LOG_FILE_PATH(__FILE__), __LINE__);
 
     if (target.empty())
@@ -0,0 +1,448 @@
+/*
+ * Flex Flow
+ * Copyright (c) 2026-present fdar0536
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include <algorithm>
+
+#include "spdlog/spdlog.h"
+
+#include "model/utils.hpp"
+#include "model/errmsg.hpp"
+
+#include "queue.hpp"
+
+namespace Model
+{
+
+namespace DAO
+{
+
+namespace Federation
+{
+
+Queue::Queue() :
+    m_next(0)
+{}
+
+Queue::~Queue()
+{}
+
+u8 Queue::init(const std::vector<std::shared_ptr<IQueue>> &members)
+{
+    FF_DEBUG("{}:{} Queue::init", LOG_FILE_PATH(__FILE__), __LINE__);
+
+    if (members.empty() || members.size() > MAX_MEMBERS)
+    {
+        spdlog::error("{}:{} Invalid member count: {}",
+            LOG_FILE_PATH(__FILE__), __LINE__, members.size());
+        return ErrCode_INVALID_ARGUMENT;
+    }
+
+    m_members = members;
+    {
+        std::lock_guard<std::mutex> lock(m_loadMutex);
+        m_loads.assign(members.size(), MemberLoad());
+    }
+
+    return ErrCode_OK;
+}
+
+u8 Queue::listPending(std::vector<int> &out)
+{
+    FF_DEBUG("{}:{} Queue::listPending", LOG_FILE_PATH(__FILE__), __LINE__);
+
+    return listTasks(&IQueue::listPending, out);
+}
+
+u8 Queue::listFinished(std::vector<int> &out)
+{
+    FF_DEBUG("{}:{} Queue::listFinished", LOG_FILE_PATH(__FILE__), __LINE__);
+
+    return listTasks(&IQueue::listFinished, out);
+}
+
+u8 Queue::pendingDetails(const int id, Proc::Task &out)
+{
+    FF_DEBUG("{}:{} Queue::pendingDetails", LOG_FILE_PATH(__FILE__), __LINE__);
+
+    IQueue *queue(nullptr);
+    i32 localID(0);
+    u8 code = toLocalID(id, queue, localID);
+    if (code)
+    {
+        return code;
+    }
+
+    code = queue->pendingDetails(localID, out);
+    if (code)
+    {
+        return code;
+    }
+
+    out.ID = id;
+    return ErrCode_OK;
+}
+
+u8 Queue::finishedDetails(const int id, Proc::Task &out)
+{
+    FF_DEBUG("{}:{} Queue::finishedDetails", LOG_FILE_PATH(__FILE__), __LINE__);
+
+    IQueue *queue(nullptr);
+    i32 localID(0);
+    u8 code = toLocalID(id, queue, localID);
+    if (code)
+    {
+        return code;
+    }
+
+    code = queue->finishedDetails(localID, out);
+    if (code)
+    {
+        return code;
+    }
+
+    out.ID = id;
+    return ErrCode_OK;
+}
+
+u8 Queue::clearPending()
+{
+    FF_DEBUG("{}:{} Queue::clearPending", LOG_FILE_PATH(__FILE__), __LINE__);
+
+    u8 ret(ErrCode_OK);
+    for (auto it = m_members.begin(); it != m_members.end(); ++it)
+    {
+        if (*it == nullptr) continue;
+
+        u8 code = (*it)->clearPending();
+        if (code) ret = code;
+    }
+
+    return ret;
+}
+
+u8 Queue::clearFinished()
+{
+    FF_DEBUG("{}:{} Queue::clearFinished", LOG_FILE_PATH(__FILE__), __LINE__);
+
+    u8 ret(ErrCode_OK);
+    for (auto it = m_members.begin(); it != m_members.end(); ++it)
+    {
+        if (*it == nullptr) continue;
+
+        u8 code = (*it)->clearFinished();
+        if (code) ret = code;
+    }
+
+    return ret;
+}
+
+u8 Queue::currentTask(Proc::Task &out)
+{
+    FF_DEBUG("{}:{} Queue::currentTask", LOG_FILE_PATH(__FILE__), __LINE__);
+
+    for (size_t i = 0; i < m_members.size(); ++i)
+    {
+        if (m_members[i] == nullptr || !m_members[i]->isRunning())
+        {
+            continue;
+        }
+
+        if (!m_members[i]->currentTask(out))
+        {
+            if (out.ID < 0 || out.ID > MAX_LOCAL_ID)
+            {
+                spdlog::warn("{}:{} id {} of member {} cannot be federated",
+                    LOG_FILE_PATH(__FILE__), __LINE__, out.ID, i);
+                continue;
+            }
+
+            out.ID = toGlobalID(out.ID, i);
+            return ErrCode_OK;
+        }
+    }
+
+    spdlog::error("{}:{} Queue is not running.", LOG_FILE_PATH(__FILE__), __LINE__);
+    return ErrCode_INVALID_ARGUMENT;
+}
+
+u8 Queue::addTask(Proc::Task &in)
+{
+    FF_DEBUG("{}:{} Queue::addTask", LOG_FILE_PATH(__FILE__), __LINE__);
+
+    // (load, member), the running task counts as one more pending task
+    std::vector<std::pair<size_t, size_t>> candidates;
+    candidates.reserve(m_members.size());
+
+    size_t first = m_next.fetch_add(1, std::memory_order_relaxed) % m_members.size();
+    std::vector<int> pending;
+    for (size_t n = 0; n < m_members.size(); ++n)
+    {
+        size_t i = (first + n) % m_members.size();
+        if (m_members[i] == nullptr)
+        {
+            continue;
+        }
+
+        size_t load(0);
+        if (!cachedLoad(i, load))
+        {
+            if (m_members[i]->listPending(pending))
+            {
+                spdlog::warn("{}:{} member {} does not respond, skip it",
+                    LOG_FILE_PATH(__FILE__), __LINE__, i);
+                continue;
+            }
+
+            load = pending.size() + (m_members[i]->isRunning() ? 1 : 0);
+            storeLoad(i, load);
+        }
+
+        candidates.push_back(std::make_pair(load, i));
+    }
+
+    // stable, so the rotation above breaks the ties
+    std::stable_sort(candidates.begin(), candidates.end(),
+        [](const std::pair<size_t, size_t> &a, const std::pair<size_t, size_t> &b)
+        {
+            return a.first < b.first;
+        });
+
+    for (auto it = candidates.begin(); it != candidates.end(); ++it)
+    {
+        Proc::Task task = in;
+        if (m_members[it->second]->addTask(task))
+        {
+            spdlog::warn("{}:{} Fail to add task to member {}, try the next one",
+                LOG_FILE_PATH(__FILE__), __LINE__, it->second);
+            continue;
+        }
+
+        if (task.ID < 0 || task.ID > MAX_LOCAL_ID)
+        {
+            spdlog::warn("{}:{} id {} of member {} cannot be federated, try the next one",
+                LOG_FILE_PATH(__FILE__), __LINE__, task.ID, it->second);
+            m_members[it->second]->removeTask(task.ID);
+            continue;
+        }
+
+        bumpLoad(it->second);
+        in.ID = toGlobalID(task.ID, it->second);
+        return ErrCode_OK;
+    }
+
+    spdlog::error("{}:{} No member can accept the task",
+        LOG_FILE_PATH(__FILE__), __LINE__);
+    return ErrCode_OS_ERROR;
+}
+
+u8 Queue::removeTask(const i32 in)
+{
+    FF_DEBUG("{}:{} Queue::removeTask", LOG_FILE_PATH(__FILE__), __LINE__);
+
+    IQueue *queue(nullptr);
+    i32 localID(0);
+    u8 code = toLocalID(in, queue, localID);
+    if (code)
+    {
+        return code;
+    }
+
+    return queue->removeTask(localID);
+}
+
+u8 Queue::reprioritize(const i32 id, const i32 priority)
+{
+    FF_DEBUG("{}:{} Queue::reprioritize", LOG_FILE_PATH(__FILE__), __LINE__);
+
+    IQueue *queue(nullptr);
+    i32 localID(0);
+    u8 code = toLocalID(id, queue, localID);
+    if (code)
+    {
+        return code;
+    }
+
+    return queue->reprioritize(localID, priority);
+}
+
+bool Queue::isRunning() const
+{
+    FF_DEBUG("{}:{} Queue::isRunning", LOG_FILE_PATH(__FILE__), __LINE__);
+
+    for (auto it = m_members.begin(); it != m_members.end(); ++it)
+    {
+        if (*it != nullptr && (*it)->isRunning())
+        {
+            return true;
+        }
+    }
+
+    return false;
+}
+
+void Queue::readCurrentOutput(std::vector<std::string> &out)
+{
+    FF_DEBUG("{}:{} Queue::readCurrentOutput", LOG_FILE_PATH(__FILE__), __LINE__);
+
+    out.clear();
+    std::vector<std::string> buffer;
+    for (auto it = m_members.begin(); it != m_members.end(); ++it)
+    {
+        if (*it == nullptr) continue;
+
+        (*it)->readCurrentOutput(buffer);
+        out.insert(out.end(),
+                   std::make_move_iterator(buffer.begin()),
+                   std::make_move_iterator(buffer.end()));
+    }
+}
+
+u8 Queue::start()
+{
+    FF_DEBUG("{}:{} Queue::start", LOG_FILE_PATH(__FILE__), __LINE__);
+
+    u8 ret(ErrCode_OK);
+    for (auto it = m_members.begin(); it != m_members.end(); ++it)
+    {
+        if (*it == nullptr) continue;
+
+        u8 code = (*it)->start();
+        if (code) ret = code;
+    }
+
+    return ret;
+}
+
+void Queue::stop()
+{
+    FF_DEBUG("{}:{} Queue::stop", LOG_FILE_PATH(__FILE__), __LINE__);
+
+    for (auto it = m_members.begin(); it != m_members.end(); ++it)
+    {
+        if (*it != nullptr) (*it)->stop();
+    }
+}
+
+void Queue::finishedGeneration(u64 &epoch, u64 &version) const
+{
+    epoch = 0;
+    version = 0;
+}
+
+i32 Queue::toGlobalID(const i32 localID, const size_t member)
+{
+    return localID * static_cast<i32>(MAX_MEMBERS) + static_cast<i32>(member);
+}
+
+// private member functions
+u8 Queue::toLocalID(const i32 globalID, IQueue *&queue, i32 &localID) const
+{
+    if (globalID < 0)
+    {
+        spdlog::error("{}:{} Invalid id: {}", LOG_FILE_PATH(__FILE__), __LINE__, globalID);
+        return ErrCode_INVALID_ARGUMENT;
+    }
+
+    size_t member = static_cast<size_t>(globalID) % MAX_MEMBERS;
+    if (member >= m_members.size() || m_members[member] == nullptr)
+    {
+        spdlog::error("{}:{} No member owns id: {}",
+            LOG_FILE_PATH(__FILE__), __LINE__, globalID);
+        return ErrCode_NOT_FOUND;
+    }
+
+    queue = m_members[member].get();
+    localID = globalID / static_cast<i32>(MAX_MEMBERS);
+    return ErrCode_OK;
+}
+
+u8 Queue::listTasks(u8 (IQueue::*list)(std::vector<int> &), std::vector<int> &out)
+{
+    out.clear();
+
+    std::vector<int> buffer;
+    bool isAnyListed(false);
+    for (size_t i = 0; i < m_members.size(); ++i)
+    {
+        if (m_members[i] == nullptr) continue;
+
+        if ((m_members[i].get()->*list)(buffer))
+        {
+            spdlog::warn("{}:{} member {} does not respond, skip it",
+                LOG_FILE_PATH(__FILE__), __LINE__, i);
+            continue;
+        }
+
+        isAnyListed = true;
+        out.reserve(out.size() + buffer.size());
+        for (auto it = buffer.begin(); it != buffer.end(); ++it)
+        {
+            if (*it < 0 || *it > MAX_LOCAL_ID)
+            {
+                spdlog::warn("{}:{} id {} of member {} cannot be federated",
+                    LOG_FILE_PATH(__FILE__), __LINE__, *it, i);
+                continue;
+            }
+
+            out.push_back(toGlobalID(*it, i));
+        }
+    }
+
+    return isAnyListed ? ErrCode_OK : ErrCode_OS_ERROR;
+}
+
+bool Queue::cachedLoad(const size_t member, size_t &pending)
+{
+    std::lock_guard<std::mutex> lock(m_loadMutex);
+    if (member >= m_loads.size() ||
+        m_loads[member].expiry <= std::chrono::steady_clock::now())
+    {
+        return false;
+    }
+
+    pending = m_loads[member].pending;
+    return true;
+}
+
+void Queue::storeLoad(const size_t member, const size_t pending)
+{
+    std::lock_guard<std::mutex> lock(m_loadMutex);
+    if (member >= m_loads.size()) return;
+
+    m_loads[member].pending = pending;
+    m_loads[member].expiry = std::chrono::steady_clock::now() + LOAD_TTL;
+}
+
+void Queue::bumpLoad(const size_t member)
+{
+    std::lock_guard<std::mutex> lock(m_loadMutex);
+    if (member >= m_loads.size()) return;
+
+    ++m_loads[member].pending;
+}
+
+} // end namespace Federation
+
+} // end namespace DAO
+
+} // end namespace Model
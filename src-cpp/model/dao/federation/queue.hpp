@@ -0,0 +1,159 @@
+/*
+ * Flex Flow
+ * Copyright (c) 2026-present fdar0536
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#ifndef _MODEL_DAO_FEDERATION_QUEUE_HPP_
+#define _MODEL_DAO_FEDERATION_QUEUE_HPP_
+
+#include <atomic>
+#include <chrono>
+#include <limits>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+#include "model/dao/iqueue.hpp"
+
+namespace Model
+{
+
+namespace DAO
+{
+
+namespace Federation
+{
+
+/**
+ * @brief one queue name on several member servers
+ *
+ * The ID of a task is its ID on the member times MAX_MEMBERS plus the index
+ * of the member, so every ID can be routed back to the member which owns it.
+ * Members which do not respond are skipped by the list calls, local IDs
+ * above MAX_LOCAL_ID cannot be federated and are skipped as well.
+ */
+class Queue : public IQueue
+{
+
+public:
+
+    static constexpr size_t MAX_MEMBERS = 16;
+
+    static constexpr i32 MAX_LOCAL_ID =
+        std::numeric_limits<i32>::max() / static_cast<i32>(MAX_MEMBERS);
+
+    // how long addTask trusts the pending count it listed from a member
+    static constexpr std::chrono::milliseconds LOAD_TTL{1000};
+
+    Queue();
+
+    ~Queue();
+
+    /**
+     * @param members indexed by member, nullptr for the members which
+     * do not have this queue
+     */
+    u8 init(const std::vector<std::shared_ptr<IQueue>> &members);
+
+    u8 listPending(std::vector<int> &out) override;
+
+    u8 listFinished(std::vector<int> &out) override;
+
+    u8 pendingDetails(const int id,
+                      Proc::Task &out) override;
+
+    u8 finishedDetails(const int id,
+                       Proc::Task &out) override;
+
+    u8 clearPending() override;
+
+    u8 clearFinished() override;
+
+    /**
+     * @brief the current task of the first member which is running one
+     */
+    u8 currentTask(Proc::Task &out) override;
+
+    /**
+     * @brief add the task to the member with the fewest pending tasks
+     *
+     * The pending counts are cached for LOAD_TTL and bumped on every add,
+     * so a burst of adds does not list every member once per task.
+     */
+    u8 addTask(Proc::Task &in) override;
+
+    u8 removeTask(const i32 in) override;
+
+    u8 reprioritize(const i32 id, const i32 priority) override;
+
+    bool isRunning() const override;
+
+    void readCurrentOutput(std::vector<std::string> &out) override;
+
+    u8 start() override;
+
+    void stop() override;
+
+    /**
+     * @brief always 0, the generations of the members are only known
+     * after listing them, so clients must not cache the federated lists
+     */
+    void finishedGeneration(u64 &epoch, u64 &version) const override;
+
+    static i32 toGlobalID(const i32 localID, const size_t member);
+
+private:
+
+    std::vector<std::shared_ptr<IQueue>> m_members;
+
+    // rotates the first candidate of addTask, so ties are spread
+    std::atomic<size_t> m_next;
+
+    struct MemberLoad
+    {
+        size_t pending = 0;
+        std::chrono::steady_clock::time_point expiry;
+    };
+
+    // indexed by member, guarded by m_loadMutex
+    std::vector<MemberLoad> m_loads;
+
+    std::mutex m_loadMutex;
+
+    bool cachedLoad(const size_t member, size_t &pending);
+
+    void storeLoad(const size_t member, const size_t pending);
+
+    void bumpLoad(const size_t member);
+
+    u8 toLocalID(const i32 globalID, IQueue *&queue, i32 &localID) const;
+
+    u8 listTasks(u8 (IQueue::*list)(std::vector<int> &), std::vector<int> &out);
+
+}; // end class Queue
+
+} // end namespace Federation
+
+} // end namespace DAO
+
+} // end namespace Model
+
+#endif // _MODEL_DAO_FEDERATION_QUEUE_HPP_
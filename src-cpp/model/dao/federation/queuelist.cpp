@@ -0,0 +1,277 @@
+/*
+ * Flex Flow
+ * Copyright (c) 2026-present fdar0536
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include <set>
+
+#include "spdlog/spdlog.h"
+
+#include "model/utils.hpp"
+#include "model/errmsg.hpp"
+
+#include "queue.hpp"
+
+#include "queuelist.hpp"
+
+namespace Model
+{
+
+namespace DAO
+{
+
+namespace Federation
+{
+
+QueueList::QueueList()
+{}
+
+QueueList::~QueueList()
+{}
+
+u8 QueueList::init(const std::vector<std::shared_ptr<IQueueList>> &members)
+{
+    FF_DEBUG("{}:{} QueueList::init", LOG_FILE_PATH(__FILE__), __LINE__);
+
+    if (members.empty() || members.size() > Queue::MAX_MEMBERS)
+    {
+        spdlog::error("{}:{} Invalid member count: {}",
+            LOG_FILE_PATH(__FILE__), __LINE__, members.size());
+        return ErrCode_INVALID_ARGUMENT;
+    }
+
+    for (auto it = members.begin(); it != members.end(); ++it)
+    {
+        if (*it == nullptr)
+        {
+            spdlog::error("{}:{} member is nullptr", LOG_FILE_PATH(__FILE__), __LINE__);
+            return ErrCode_INVALID_ARGUMENT;
+        }
+    }
+
+    m_members = members;
+    return ErrCode_OK;
+}
+
+u8 QueueList::createQueue(const std::string &name)
+{
+    FF_DEBUG("{}:{} QueueList::createQueue", LOG_FILE_PATH(__FILE__), __LINE__);
+    FF_DEBUG("{}:{} name: {}", LOG_FILE_PATH(__FILE__), __LINE__, name);
+
+    bool isCreated(false);
+    u8 ret(ErrCode_OK);
+    for (size_t i = 0; i < m_members.size(); ++i)
+    {
+        if (m_members[i]->getQueue(name) != nullptr)
+        {
+            continue;
+        }
+
+        u8 code = m_members[i]->createQueue(name);
+        if (code)
+        {
+            spdlog::error("{}:{} Fail to create {} on member {}",
+                LOG_FILE_PATH(__FILE__), __LINE__, name, i);
+            ret = code;
+            continue;
+        }
+
+        isCreated = true;
+    }
+
+    forget(name);
+    if (ret)
+    {
+        return ret;
+    }
+
+    if (!isCreated)
+    {
+        spdlog::error("{}:{} {} is already exists", LOG_FILE_PATH(__FILE__), __LINE__, name);
+        return ErrCode_ALREADY_EXISTS;
+    }
+
+    return ErrCode_OK;
+}
+
+u8 QueueList::listQueue(std::vector<std::string> &out)
+{
+    FF_DEBUG("{}:{} QueueList::listQueue", LOG_FILE_PATH(__FILE__), __LINE__);
+
+    out.clear();
+    std::set<std::string> names;
+    std::vector<std::string> buffer;
+    bool isAnyListed(false);
+    for (size_t i = 0; i < m_members.size(); ++i)
+    {
+        if (m_members[i]->listQueue(buffer))
+        {
+            spdlog::warn("{}:{} member {} does not respond, skip it",
+                LOG_FILE_PATH(__FILE__), __LINE__, i);
+            continue;
+        }
+
+        isAnyListed = true;
+        names.insert(buffer.begin(), buffer.end());
+    }
+
+    if (!isAnyListed)
+    {
+        spdlog::error("{}:{} No member responds", LOG_FILE_PATH(__FILE__), __LINE__);
+        return ErrCode_OS_ERROR;
+    }
+
+    out.assign(names.begin(), names.end());
+    return ErrCode_OK;
+}
+
+u8 QueueList::deleteQueue(const std::string &name)
+{
+    FF_DEBUG("{}:{} QueueList::deleteQueue", LOG_FILE_PATH(__FILE__), __LINE__);
+    FF_DEBUG("{}:{} name: {}", LOG_FILE_PATH(__FILE__), __LINE__, name);
+
+    bool isFound(false);
+    u8 ret(ErrCode_OK);
+    for (size_t i = 0; i < m_members.size(); ++i)
+    {
+        if (m_members[i]->getQueue(name) == nullptr)
+        {
+            continue;
+        }
+
+        isFound = true;
+        u8 code = m_members[i]->deleteQueue(name);
+        if (code)
+        {
+            spdlog::error("{}:{} Fail to delete {} on member {}",
+                LOG_FILE_PATH(__FILE__), __LINE__, name, i);
+            ret = code;
+        }
+    }
+
+    forget(name);
+    if (!isFound)
+    {
+        spdlog::error("{}:{} {} is not found", LOG_FILE_PATH(__FILE__), __LINE__, name);
+        return ErrCode_NOT_FOUND;
+    }
+
+    return ret;
+}
+
+u8 QueueList::renameQueue(const std::string &oldName,
+                          const std::string &newName)
+{
+    FF_DEBUG("{}:{} QueueList::renameQueue", LOG_FILE_PATH(__FILE__), __LINE__);
+    FF_DEBUG("{}:{} oldName: {}", LOG_FILE_PATH(__FILE__), __LINE__, oldName);
+    FF_DEBUG("{}:{} newName: {}", LOG_FILE_PATH(__FILE__), __LINE__, newName);
+
+    bool isFound(false);
+    u8 ret(ErrCode_OK);
+    for (size_t i = 0; i < m_members.size(); ++i)
+    {
+        if (m_members[i]->getQueue(oldName) == nullptr)
+        {
+            continue;
+        }
+
+        isFound = true;
+        u8 code = m_members[i]->renameQueue(oldName, newName);
+        if (code)
+        {
+            spdlog::error("{}:{} Fail to rename {} on member {}",
+                LOG_FILE_PATH(__FILE__), __LINE__, oldName, i);
+            ret = code;
+        }
+    }
+
+    forget(oldName);
+    forget(newName);
+    if (!isFound)
+    {
+        spdlog::error("{}:{} {} is not found", LOG_FILE_PATH(__FILE__), __LINE__, oldName);
+        return ErrCode_NOT_FOUND;
+    }
+
+    return ret;
+}
+
+std::shared_ptr<IQueue> QueueList::getQueue(const std::string &name)
+{
+    FF_DEBUG("{}:{} QueueList::getQueue", LOG_FILE_PATH(__FILE__), __LINE__);
+    FF_DEBUG("{}:{} name: {}", LOG_FILE_PATH(__FILE__), __LINE__, name);
+
+    {
+        auto queueList = m_queueList.load();
+        auto it = queueList->find(name);
+        if (it != queueList->end()) return it->second;
+    }
+
+    std::vector<std::shared_ptr<IQueue>> members;
+    members.reserve(m_members.size());
+    bool isFound(false);
+    for (auto it = m_members.begin(); it != m_members.end(); ++it)
+    {
+        members.push_back((*it)->getQueue(name));
+        if (members.back() != nullptr) isFound = true;
+    }
+
+    if (!isFound) return nullptr;
+
+    Queue *queue = new (std::nothrow) Queue;
+    if (!queue)
+    {
+        spdlog::error("{}:{} Fail to allocate memory", LOG_FILE_PATH(__FILE__), __LINE__);
+        return nullptr;
+    }
+
+    if (queue->init(members))
+    {
+        spdlog::error("{}:{} Fail to initialize queue", LOG_FILE_PATH(__FILE__), __LINE__);
+        delete queue;
+        return nullptr;
+    }
+
+    std::shared_ptr<IQueue> out(queue);
+    m_queueList.update([&](QueueMap &map) -> u8
+    {
+        auto ret = map.emplace(name, out);
+        out = ret.first->second; // keep the one which is published first
+        return 0;
+    });
+
+    return out;
+}
+
+// private member functions
+void QueueList::forget(const std::string &name)
+{
+    m_queueList.update([&](QueueMap &map) -> u8
+    {
+        return map.erase(name) ? 0 : 1;
+    });
+}
+
+} // end namespace Federation
+
+} // end namespace DAO
+
+} // end namespace Model
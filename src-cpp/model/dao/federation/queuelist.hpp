@@ -0,0 +1,98 @@
+/*
+ * Flex Flow
+ * Copyright (c) 2026-present fdar0536
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#ifndef _MODEL_DAO_FEDERATION_QUEUELIST_HPP_
+#define _MODEL_DAO_FEDERATION_QUEUELIST_HPP_
+
+#include <unordered_map>
+
+#include "model/dao/iqueuelist.hpp"
+#include "model/snapshot.hpp"
+
+namespace Model
+{
+
+namespace DAO
+{
+
+namespace Federation
+{
+
+/**
+ * @brief present the queues of several servers under one namespace
+ *
+ * A queue exists if any member has it, and it is made of the queues
+ * with the same name on every member, see Federation::Queue.
+ */
+class QueueList : public IQueueList
+{
+public:
+
+    QueueList();
+
+    ~QueueList();
+
+    /**
+     * @param members at most Queue::MAX_MEMBERS, usually GRPC::QueueList
+     */
+    u8 init(const std::vector<std::shared_ptr<IQueueList>> &members);
+
+    /**
+     * @brief create the queue on the members which do not have it
+     */
+    u8 createQueue(const std::string &name) override;
+
+    /**
+     * @brief union of the queues of all members which respond
+     */
+    u8 listQueue(std::vector<std::string> &out) override;
+
+    u8 deleteQueue(const std::string &name) override;
+
+    u8 renameQueue(const std::string &oldName,
+                   const std::string &newName) override;
+
+    std::shared_ptr<IQueue> getQueue(const std::string &name) override;
+
+private:
+
+    typedef std::unordered_map<std::string,
+    std::shared_ptr<IQueue>> QueueMap;
+
+    std::vector<std::shared_ptr<IQueueList>> m_members;
+
+    // federated queues built so far, dropped when they are changed
+    // through this list
+    Snapshot<QueueMap> m_queueList;
+
+    void forget(const std::string &name);
+
+}; // end class QueueList
+
+} // end namespace Federation
+
+} // end namespace DAO
+
+} // end namespace Model
+
+#endif // _MODEL_DAO_FEDERATION_QUEUELIST_HPP_
@@ -0,0 +1,224 @@
+/*
+ * Flex Flow
+ * Copyright (c) 2026-present fdar0536
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#ifndef _MODEL_DAO_GRPC_ASYNCCALL_HPP_
+#define _MODEL_DAO_GRPC_ASYNCCALL_HPP_
+
+#include <functional>
+#include <future>
+#include <memory>
+
+#include "grpcpp/grpcpp.h"
+#include "grpcpp/support/client_callback.h"
+
+#include "model/utils.hpp"
+#include "model/connect/grpc/connect.hpp"
+#include "model/dao/iasyncqueue.hpp"
+
+#include "utils.hpp"
+
+namespace Model
+{
+
+namespace DAO
+{
+
+namespace GRPC
+{
+
+namespace Async
+{
+
+typedef std::function<void(grpc::Status)> Done;
+
+/**
+ * @brief a future which already holds value
+ */
+template <typename T>
+std::future<T> ready(T value)
+{
+    std::promise<T> promise;
+    promise.set_value(std::move(value));
+    return promise.get_future();
+}
+
+template <typename Req, typename Res, typename P>
+struct UnaryCall
+{
+    grpc::ClientContext ctx;
+    Req req;
+    Res res;
+    std::promise<P> promise;
+};
+
+/**
+ * @brief start a unary call on a callback stub
+ * @param start void(grpc::ClientContext *, const Req *, Res *, Done),
+ * it calls the method of stub->async()
+ * @param convert void(Res &, T &), fill the output of a successful call
+ */
+template <typename T, typename Req, typename Res, typename Start, typename Convert>
+std::future<AsyncResult<T>> unary(Connect::GRPC::Token &token,
+                                  Req req,
+                                  Start &&start,
+                                  Convert &&convert)
+{
+    auto call = std::make_shared<UnaryCall<Req, Res, AsyncResult<T>>>();
+    call->req = std::move(req);
+    Utils::setupCtx(call->ctx,
+                    Connect::GRPC::currentToken(token),
+                    token.options.callTimeoutMs);
+
+    auto future = call->promise.get_future();
+    start(&call->ctx, &call->req, &call->res,
+        [call, convert](grpc::Status status)
+        {
+            AsyncResult<T> out;
+            if (status.ok())
+            {
+                convert(call->res, out.value);
+            }
+            else
+            {
+                Utils::buildErrMsg(LOG_FILE_PATH(__FILE__), __LINE__, status);
+                out.code = ErrCode_OS_ERROR;
+            }
+
+            call->promise.set_value(std::move(out));
+        });
+
+    return future;
+}
+
+/**
+ * @brief same as unary(), for the calls which only return an error code
+ */
+template <typename Req, typename Res, typename Start>
+std::future<u8> unaryCode(Connect::GRPC::Token &token, Req req, Start &&start)
+{
+    auto call = std::make_shared<UnaryCall<Req, Res, u8>>();
+    call->req = std::move(req);
+    Utils::setupCtx(call->ctx,
+                    Connect::GRPC::currentToken(token),
+                    token.options.callTimeoutMs);
+
+    auto future = call->promise.get_future();
+    start(&call->ctx, &call->req, &call->res,
+        [call](grpc::Status status)
+        {
+            if (status.ok())
+            {
+                call->promise.set_value(ErrCode_OK);
+                return;
+            }
+
+            Utils::buildErrMsg(LOG_FILE_PATH(__FILE__), __LINE__, status);
+            call->promise.set_value(ErrCode_OS_ERROR);
+        });
+
+    return future;
+}
+
+/**
+ * @brief collect a server stream into T, it deletes itself when done
+ */
+template <typename Req, typename Res, typename T>
+class StreamCall : public grpc::ClientReadReactor<Res>
+{
+public:
+
+    typedef std::function<void(Res &, T &)> Append;
+
+    StreamCall(Connect::GRPC::Token &token, Req req, Append append) :
+        m_req(std::move(req)),
+        m_append(std::move(append))
+    {
+        Utils::setupCtx(m_ctx,
+                        Connect::GRPC::currentToken(token),
+                        token.options.callTimeoutMs);
+    }
+
+    /**
+     * @param start void(grpc::ClientContext *, const Req *,
+     * grpc::ClientReadReactor<Res> *), it calls the method of stub->async()
+     */
+    template <typename Start>
+    std::future<AsyncResult<T>> run(Start &&start)
+    {
+        auto future = m_promise.get_future();
+        start(&m_ctx, &m_req, this);
+        this->StartRead(&m_res);
+        this->StartCall();
+        return future;
+    }
+
+    void OnReadDone(bool ok) override
+    {
+        if (!ok)
+        {
+            return; // OnDone follows
+        }
+
+        m_append(m_res, m_out.value);
+        this->StartRead(&m_res);
+    }
+
+    void OnDone(const grpc::Status &status) override
+    {
+        if (!status.ok())
+        {
+            grpc::Status copy = status;
+            Utils::buildErrMsg(LOG_FILE_PATH(__FILE__), __LINE__, copy);
+            m_out.code = ErrCode_OS_ERROR;
+            m_out.value = T();
+        }
+
+        m_promise.set_value(std::move(m_out));
+        delete this;
+    }
+
+private:
+
+    grpc::ClientContext m_ctx;
+
+    Req m_req;
+
+    Res m_res;
+
+    Append m_append;
+
+    AsyncResult<T> m_out;
+
+    std::promise<AsyncResult<T>> m_promise;
+
+}; // end class StreamCall
+
+} // end namespace Async
+
+} // end namespace GRPC
+
+} // end namespace DAO
+
+} // end namespace Model
+
+#endif // _MODEL_DAO_GRPC_ASYNCCALL_HPP_
@@ -0,0 +1,404 @@
+/*
+ * Flex Flow
+ * Copyright (c) 2026-present fdar0536
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include "spdlog/spdlog.h"
+
+#include "model/utils.hpp"
+#include "model/errmsg.hpp"
+
+#include "asynccall.hpp"
+#include "queue.hpp"
+
+#include "asyncqueue.hpp"
+
+namespace Model
+{
+
+namespace DAO
+{
+
+namespace GRPC
+{
+
+AsyncQueue::AsyncQueue() :
+    m_stub(nullptr),
+    m_queueName("")
+{}
+
+AsyncQueue::~AsyncQueue()
+{}
+
+u8
+AsyncQueue::init(std::shared_ptr<Connect::GRPC::Token> &token,
+                 const std::string &name)
+{
+    FF_DEBUG("{}:{} AsyncQueue::init", LOG_FILE_PATH(__FILE__), __LINE__);
+
+    if (token == nullptr)
+    {
+        spdlog::error(
+            "{}:{} token is nullptr",
+            LOG_FILE_PATH(__FILE__), __LINE__);
+        return ErrCode_INVALID_ARGUMENT;
+    }
+
+    if (name.empty())
+    {
+        spdlog::error("{}:{} name is empty", LOG_FILE_PATH(__FILE__), __LINE__);
+        return ErrCode_INVALID_ARGUMENT;
+    }
+
+    try
+    {
+        m_stub = ff::Queue::NewStub(token->channel);
+        if (m_stub == nullptr)
+        {
+            spdlog::error("{}:{} Fail to get stub",
+                LOG_FILE_PATH(__FILE__), __LINE__);
+            return ErrCode_OS_ERROR;
+        }
+    }
+    catch (...)
+    {
+        spdlog::error("{}:{} Fail to get stub",
+            LOG_FILE_PATH(__FILE__), __LINE__);
+        return ErrCode_OS_ERROR;
+    }
+
+    m_queueName = name;
+    m_token = token;
+    return ErrCode_OK;
+}
+
+std::future<AsyncResult<std::vector<int>>> AsyncQueue::listPending()
+{
+    FF_DEBUG("{}:{} AsyncQueue::listPending", LOG_FILE_PATH(__FILE__), __LINE__);
+
+    typedef Async::StreamCall<ff::QueueReq, ff::ListTaskRes, std::vector<int>> Call;
+    Call *call = new (std::nothrow) Call(*m_token, queueReq(),
+        [](ff::ListTaskRes &res, std::vector<int> &out)
+        {
+            out.push_back(res.id());
+        });
+    if (!call)
+    {
+        spdlog::error("{}:{} Fail to allocate memory",
+            LOG_FILE_PATH(__FILE__), __LINE__);
+        return Async::ready(AsyncResult<std::vector<int>>{ErrCode_OS_ERROR, {}});
+    }
+
+    auto async = m_stub->async();
+    return call->run([async](grpc::ClientContext *ctx,
+                             const ff::QueueReq *req,
+                             grpc::ClientReadReactor<ff::ListTaskRes> *reactor)
+    {
+        async->ListPending(ctx, req, reactor);
+    });
+}
+
+std::future<AsyncResult<std::vector<int>>> AsyncQueue::listFinished()
+{
+    FF_DEBUG("{}:{} AsyncQueue::listFinished", LOG_FILE_PATH(__FILE__), __LINE__);
+
+    typedef Async::StreamCall<ff::QueueReq, ff::ListTaskRes, std::vector<int>> Call;
+    Call *call = new (std::nothrow) Call(*m_token, queueReq(),
+        [](ff::ListTaskRes &res, std::vector<int> &out)
+        {
+            out.push_back(res.id());
+        });
+    if (!call)
+    {
+        spdlog::error("{}:{} Fail to allocate memory",
+            LOG_FILE_PATH(__FILE__), __LINE__);
+        return Async::ready(AsyncResult<std::vector<int>>{ErrCode_OS_ERROR, {}});
+    }
+
+    auto async = m_stub->async();
+    return call->run([async](grpc::ClientContext *ctx,
+                             const ff::QueueReq *req,
+                             grpc::ClientReadReactor<ff::ListTaskRes> *reactor)
+    {
+        async->ListFinished(ctx, req, reactor);
+    });
+}
+
+std::future<AsyncResult<Proc::Task>> AsyncQueue::pendingDetails(const int id)
+{
+    FF_DEBUG("{}:{} AsyncQueue::pendingDetails",
+        LOG_FILE_PATH(__FILE__), __LINE__);
+
+    return details(id, &ff::Queue::Stub::async_interface::PendingDetails);
+}
+
+std::future<AsyncResult<Proc::Task>> AsyncQueue::finishedDetails(const int id)
+{
+    FF_DEBUG("{}:{} AsyncQueue::finishedDetails",
+        LOG_FILE_PATH(__FILE__), __LINE__);
+
+    return details(id, &ff::Queue::Stub::async_interface::FinishedDetails);
+}
+
+std::future<u8> AsyncQueue::clearPending()
+{
+    FF_DEBUG("{}:{} AsyncQueue::clearPending",
+        LOG_FILE_PATH(__FILE__), __LINE__);
+
+    return simple(&ff::Queue::Stub::async_interface::ClearPending);
+}
+
+std::future<u8> AsyncQueue::clearFinished()
+{
+    FF_DEBUG("{}:{} AsyncQueue::clearFinished",
+        LOG_FILE_PATH(__FILE__), __LINE__);
+
+    return simple(&ff::Queue::Stub::async_interface::ClearFinished);
+}
+
+std::future<AsyncResult<Proc::Task>> AsyncQueue::currentTask()
+{
+    FF_DEBUG("{}:{} AsyncQueue::currentTask",
+        LOG_FILE_PATH(__FILE__), __LINE__);
+
+    auto async = m_stub->async();
+    return Async::unary<Proc::Task, ff::QueueReq, ff::TaskDetailsRes>(
+        *m_token, queueReq(),
+        [async](grpc::ClientContext *ctx,
+                const ff::QueueReq *req,
+                ff::TaskDetailsRes *res,
+                Async::Done done)
+        {
+            async->CurrentTask(ctx, req, res, std::move(done));
+        },
+        [](ff::TaskDetailsRes &res, Proc::Task &out)
+        {
+            Queue::buildTask(res, out);
+        });
+}
+
+std::future<AsyncResult<Proc::Task>> AsyncQueue::addTask(const Proc::Task &in)
+{
+    FF_DEBUG("{}:{} AsyncQueue::addTask",
+        LOG_FILE_PATH(__FILE__), __LINE__);
+
+    ff::AddTaskReq req;
+    req.set_name(m_queueName);
+    req.set_workdir(in.workDir);
+    req.set_execname(in.execName);
+    for (auto it = in.args.begin();
+         it != in.args.end();
+         ++it)
+    {
+        req.add_args(*it);
+    }
+
+    req.set_cpus(in.cpus);
+    req.set_memorymb(in.memoryMB);
+    req.set_priority(in.priority);
+    req.set_walltimeoutsec(in.wallTimeoutSec);
+    req.set_cputimeoutsec(in.cpuTimeoutSec);
+
+    auto async = m_stub->async();
+    return Async::unary<Proc::Task, ff::AddTaskReq, ff::ListTaskRes>(
+        *m_token, std::move(req),
+        [async](grpc::ClientContext *ctx,
+                const ff::AddTaskReq *req,
+                ff::ListTaskRes *res,
+                Async::Done done)
+        {
+            async->AddTask(ctx, req, res, std::move(done));
+        },
+        [in](ff::ListTaskRes &res, Proc::Task &out)
+        {
+            out = in;
+            out.ID = res.id();
+        });
+}
+
+std::future<u8> AsyncQueue::removeTask(const i32 id)
+{
+    FF_DEBUG("{}:{} AsyncQueue::removeTask",
+        LOG_FILE_PATH(__FILE__), __LINE__);
+
+    auto async = m_stub->async();
+    return Async::unaryCode<ff::TaskDetailsReq, ff::Empty>(
+        *m_token, taskReq(id),
+        [async](grpc::ClientContext *ctx,
+                const ff::TaskDetailsReq *req,
+                ff::Empty *res,
+                Async::Done done)
+        {
+            async->RemoveTask(ctx, req, res, std::move(done));
+        });
+}
+
+std::future<u8> AsyncQueue::reprioritize(const i32 id, const i32 priority)
+{
+    FF_DEBUG("{}:{} AsyncQueue::reprioritize",
+        LOG_FILE_PATH(__FILE__), __LINE__);
+
+    ff::ReprioritizeReq req;
+    req.set_name(m_queueName);
+    req.set_id(id);
+    req.set_priority(priority);
+
+    auto async = m_stub->async();
+    return Async::unaryCode<ff::ReprioritizeReq, ff::Empty>(
+        *m_token, req,
+        [async](grpc::ClientContext *ctx,
+                const ff::ReprioritizeReq *req,
+                ff::Empty *res,
+                Async::Done done)
+        {
+            async->Reprioritize(ctx, req, res, std::move(done));
+        });
+}
+
+std::future<AsyncResult<bool>> AsyncQueue::isRunning()
+{
+    FF_DEBUG("{}:{} AsyncQueue::isRunning",
+        LOG_FILE_PATH(__FILE__), __LINE__);
+
+    auto async = m_stub->async();
+    return Async::unary<bool, ff::QueueReq, ff::IsRunningRes>(
+        *m_token, queueReq(),
+        [async](grpc::ClientContext *ctx,
+                const ff::QueueReq *req,
+                ff::IsRunningRes *res,
+                Async::Done done)
+        {
+            async->IsRunning(ctx, req, res, std::move(done));
+        },
+        [](ff::IsRunningRes &res, bool &out)
+        {
+            out = res.isrunning();
+        });
+}
+
+std::future<AsyncResult<std::vector<std::string>>>
+AsyncQueue::readCurrentOutput()
+{
+    FF_DEBUG("{}:{} AsyncQueue::readCurrentOutput",
+        LOG_FILE_PATH(__FILE__), __LINE__);
+
+    typedef Async::StreamCall<ff::QueueReq, ff::Msg,
+                              std::vector<std::string>> Call;
+    Call *call = new (std::nothrow) Call(*m_token, queueReq(),
+        [](ff::Msg &res, std::vector<std::string> &out)
+        {
+            out.push_back(std::move(*res.mutable_msg()));
+        });
+    if (!call)
+    {
+        spdlog::error("{}:{} Fail to allocate memory",
+            LOG_FILE_PATH(__FILE__), __LINE__);
+        return Async::ready(
+            AsyncResult<std::vector<std::string>>{ErrCode_OS_ERROR, {}});
+    }
+
+    auto async = m_stub->async();
+    return call->run([async](grpc::ClientContext *ctx,
+                             const ff::QueueReq *req,
+                             grpc::ClientReadReactor<ff::Msg> *reactor)
+    {
+        async->ReadCurrentOutput(ctx, req, reactor);
+    });
+}
+
+std::future<u8> AsyncQueue::start()
+{
+    FF_DEBUG("{}:{} AsyncQueue::start", LOG_FILE_PATH(__FILE__), __LINE__);
+
+    return simple(&ff::Queue::Stub::async_interface::Start);
+}
+
+std::future<u8> AsyncQueue::stop()
+{
+    FF_DEBUG("{}:{} AsyncQueue::stop", LOG_FILE_PATH(__FILE__), __LINE__);
+
+    return simple(&ff::Queue::Stub::async_interface::Stop);
+}
+
+// private member functions
+ff::QueueReq AsyncQueue::queueReq() const
+{
+    ff::QueueReq req;
+    req.set_name(m_queueName);
+    return req;
+}
+
+ff::TaskDetailsReq AsyncQueue::taskReq(const int id) const
+{
+    ff::TaskDetailsReq req;
+    req.set_name(m_queueName);
+    req.set_id(id);
+    return req;
+}
+
+std::future<AsyncResult<Proc::Task>>
+AsyncQueue::details(const int id,
+                    void (ff::Queue::Stub::async_interface::*method)(
+                        grpc::ClientContext *,
+                        const ff::TaskDetailsReq *,
+                        ff::TaskDetailsRes *,
+                        std::function<void(grpc::Status)>))
+{
+    auto async = m_stub->async();
+    return Async::unary<Proc::Task, ff::TaskDetailsReq, ff::TaskDetailsRes>(
+        *m_token, taskReq(id),
+        [async, method](grpc::ClientContext *ctx,
+                        const ff::TaskDetailsReq *req,
+                        ff::TaskDetailsRes *res,
+                        Async::Done done)
+        {
+            (async->*method)(ctx, req, res, std::move(done));
+        },
+        [](ff::TaskDetailsRes &res, Proc::Task &out)
+        {
+            Queue::buildTask(res, out);
+        });
+}
+
+std::future<u8>
+AsyncQueue::simple(void (ff::Queue::Stub::async_interface::*method)(
+                       grpc::ClientContext *,
+                       const ff::QueueReq *,
+                       ff::Empty *,
+                       std::function<void(grpc::Status)>))
+{
+    auto async = m_stub->async();
+    return Async::unaryCode<ff::QueueReq, ff::Empty>(
+        *m_token, queueReq(),
+        [async, method](grpc::ClientContext *ctx,
+                        const ff::QueueReq *req,
+                        ff::Empty *res,
+                        Async::Done done)
+        {
+            (async->*method)(ctx, req, res, std::move(done));
+        });
+}
+
+} // end namespace GRPC
+
+} // end namespace DAO
+
+} // end namespace Model
@@ -0,0 +1,124 @@
+/*
+ * Flex Flow
+ * Copyright (c) 2026-present fdar0536
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#ifndef _MODEL_DAO_GRPC_ASYNCQUEUE_HPP_
+#define _MODEL_DAO_GRPC_ASYNCQUEUE_HPP_
+
+#include "queue.grpc.pb.h"
+
+#include "model/connect/grpc/connect.hpp"
+#include "model/dao/iasyncqueue.hpp"
+
+namespace Model
+{
+
+namespace DAO
+{
+
+namespace GRPC
+{
+
+/**
+ * @brief IAsyncQueue on the callback API of the stub
+ *
+ * The callbacks run on the threads of gRPC, so they never block.
+ * It does not login again when the token is rejected,
+ * the caller gets ErrCode_OS_ERROR instead.
+ */
+class AsyncQueue : public IAsyncQueue
+{
+
+public:
+
+    AsyncQueue();
+
+    ~AsyncQueue();
+
+    u8 init(std::shared_ptr<Connect::GRPC::Token> &token,
+            const std::string &name);
+
+    std::future<AsyncResult<std::vector<int>>> listPending() override;
+
+    std::future<AsyncResult<std::vector<int>>> listFinished() override;
+
+    std::future<AsyncResult<Proc::Task>> pendingDetails(const int id) override;
+
+    std::future<AsyncResult<Proc::Task>> finishedDetails(const int id) override;
+
+    std::future<u8> clearPending() override;
+
+    std::future<u8> clearFinished() override;
+
+    std::future<AsyncResult<Proc::Task>> currentTask() override;
+
+    std::future<AsyncResult<Proc::Task>> addTask(const Proc::Task &in) override;
+
+    std::future<u8> removeTask(const i32 id) override;
+
+    std::future<u8> reprioritize(const i32 id, const i32 priority) override;
+
+    std::future<AsyncResult<bool>> isRunning() override;
+
+    std::future<AsyncResult<std::vector<std::string>>>
+    readCurrentOutput() override;
+
+    std::future<u8> start() override;
+
+    std::future<u8> stop() override;
+
+private:
+
+    std::unique_ptr<ff::Queue::Stub> m_stub;
+
+    std::shared_ptr<Connect::GRPC::Token> m_token;
+
+    std::string m_queueName;
+
+    ff::QueueReq queueReq() const;
+
+    ff::TaskDetailsReq taskReq(const int id) const;
+
+    std::future<AsyncResult<Proc::Task>>
+    details(const int id,
+            void (ff::Queue::Stub::async_interface::*method)(
+                grpc::ClientContext *,
+                const ff::TaskDetailsReq *,
+                ff::TaskDetailsRes *,
+                std::function<void(grpc::Status)>));
+
+    std::future<u8>
+    simple(void (ff::Queue::Stub::async_interface::*method)(
+               grpc::ClientContext *,
+               const ff::QueueReq *,
+               ff::Empty *,
+               std::function<void(grpc::Status)>));
+
+}; // end class AsyncQueue
+
+} // end namespace GRPC
+
+} // end namespace DAO
+
+} // end namespace Model
+
+#endif // _MODEL_DAO_GRPC_ASYNCQUEUE_HPP_
@@ -0,0 +1,218 @@
+/*
+ * Flex Flow
+ * Copyright (c) 2026-present fdar0536
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include "spdlog/spdlog.h"
+
+#include "model/utils.hpp"
+#include "model/errmsg.hpp"
+
+#include "asynccall.hpp"
+#include "asyncqueue.hpp"
+
+#include "asyncqueuelist.hpp"
+
+namespace Model
+{
+
+namespace DAO
+{
+
+namespace GRPC
+{
+
+AsyncQueueList::AsyncQueueList() :
+    m_stub(nullptr)
+{}
+
+AsyncQueueList::~AsyncQueueList()
+{}
+
+u8 AsyncQueueList::init(std::shared_ptr<Connect::GRPC::Token> &token)
+{
+    FF_DEBUG("{}:{} AsyncQueueList::init", LOG_FILE_PATH(__FILE__), __LINE__);
+
+    if (token == nullptr)
+    {
+        spdlog::error("{}:{} token is nullptr", LOG_FILE_PATH(__FILE__), __LINE__);
+        return ErrCode_INVALID_ARGUMENT;
+    }
+
+    m_token = token;
+    try
+    {
+        m_stub = ff::QueueList::NewStub(m_token->channel);
+        if (m_stub == nullptr)
+        {
+            spdlog::error("{}:{} Fail to get stub",
+                LOG_FILE_PATH(__FILE__), __LINE__);
+            return ErrCode_OS_ERROR;
+        }
+    }
+    catch (...)
+    {
+        spdlog::error("{}:{} Fail to get stub", LOG_FILE_PATH(__FILE__), __LINE__);
+        return ErrCode_OS_ERROR;
+    }
+
+    return ErrCode_OK;
+}
+
+std::future<u8> AsyncQueueList::createQueue(const std::string &name)
+{
+    FF_DEBUG("{}:{} AsyncQueueList::createQueue",
+        LOG_FILE_PATH(__FILE__), __LINE__);
+
+    ff::QueueReq req;
+    req.set_name(name);
+
+    auto async = m_stub->async();
+    return Async::unaryCode<ff::QueueReq, ff::Empty>(
+        *m_token, std::move(req),
+        [async](grpc::ClientContext *ctx,
+                const ff::QueueReq *req,
+                ff::Empty *res,
+                Async::Done done)
+        {
+            async->Create(ctx, req, res, std::move(done));
+        });
+}
+
+std::future<AsyncResult<std::vector<std::string>>> AsyncQueueList::listQueue()
+{
+    FF_DEBUG("{}:{} AsyncQueueList::listQueue",
+        LOG_FILE_PATH(__FILE__), __LINE__);
+
+    typedef Async::StreamCall<ff::Empty, ff::ListQueueRes,
+                              std::vector<std::string>> Call;
+    Call *call = new (std::nothrow) Call(*m_token, ff::Empty(),
+        [](ff::ListQueueRes &res, std::vector<std::string> &out)
+        {
+            out.push_back(res.name());
+        });
+    if (!call)
+    {
+        spdlog::error("{}:{} Fail to allocate memory",
+            LOG_FILE_PATH(__FILE__), __LINE__);
+        return Async::ready(
+            AsyncResult<std::vector<std::string>>{ErrCode_OS_ERROR, {}});
+    }
+
+    auto async = m_stub->async();
+    return call->run([async](grpc::ClientContext *ctx,
+                             const ff::Empty *req,
+                             grpc::ClientReadReactor<ff::ListQueueRes> *reactor)
+    {
+        async->List(ctx, req, reactor);
+    });
+}
+
+std::future<u8> AsyncQueueList::deleteQueue(const std::string &name)
+{
+    FF_DEBUG("{}:{} AsyncQueueList::deleteQueue",
+        LOG_FILE_PATH(__FILE__), __LINE__);
+
+    ff::QueueReq req;
+    req.set_name(name);
+
+    auto async = m_stub->async();
+    return Async::unaryCode<ff::QueueReq, ff::Empty>(
+        *m_token, std::move(req),
+        [async](grpc::ClientContext *ctx,
+                const ff::QueueReq *req,
+                ff::Empty *res,
+                Async::Done done)
+        {
+            async->Delete(ctx, req, res, std::move(done));
+        });
+}
+
+std::future<u8> AsyncQueueList::renameQueue(const std::string &oldName,
+                                            const std::string &newName)
+{
+    FF_DEBUG("{}:{} AsyncQueueList::renameQueue",
+        LOG_FILE_PATH(__FILE__), __LINE__);
+
+    ff::RenameQueueReq req;
+    req.set_oldname(oldName);
+    req.set_newname(newName);
+
+    auto async = m_stub->async();
+    return Async::unaryCode<ff::RenameQueueReq, ff::Empty>(
+        *m_token, std::move(req),
+        [async](grpc::ClientContext *ctx,
+                const ff::RenameQueueReq *req,
+                ff::Empty *res,
+                Async::Done done)
+        {
+            async->Rename(ctx, req, res, std::move(done));
+        });
+}
+
+std::future<AsyncResult<std::shared_ptr<IAsyncQueue>>>
+AsyncQueueList::getQueue(const std::string &name)
+{
+    FF_DEBUG("{}:{} AsyncQueueList::getQueue",
+        LOG_FILE_PATH(__FILE__), __LINE__);
+
+    ff::QueueReq req;
+    req.set_name(name);
+
+    auto async = m_stub->async();
+    auto token = m_token;
+    return Async::unary<std::shared_ptr<IAsyncQueue>, ff::QueueReq, ff::Empty>(
+        *m_token, std::move(req),
+        [async](grpc::ClientContext *ctx,
+                const ff::QueueReq *req,
+                ff::Empty *res,
+                Async::Done done)
+        {
+            async->GetQueue(ctx, req, res, std::move(done));
+        },
+        [token, name](ff::Empty &, std::shared_ptr<IAsyncQueue> &out)
+        {
+            auto queueToken = token;
+            AsyncQueue *queue = new (std::nothrow) AsyncQueue;
+            if (!queue)
+            {
+                spdlog::error("{}:{} Fail to allocate memory",
+                    LOG_FILE_PATH(__FILE__), __LINE__);
+                return;
+            }
+
+            if (queue->init(queueToken, name))
+            {
+                spdlog::error("{}:{} Fail to initialize queue",
+                    LOG_FILE_PATH(__FILE__), __LINE__);
+                delete queue;
+                return;
+            }
+
+            out = std::shared_ptr<IAsyncQueue>(queue);
+        });
+}
+
+} // end namespace GRPC
+
+} // end namespace DAO
+
+} // end namespace Model
@@ -0,0 +1,208 @@
+/*
+ * Flex Flow
+ * Copyright (c) 2026-present fdar0536
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include "spdlog/spdlog.h"
+
+#include "model/utils.hpp"
+
+#include "finishedcache.hpp"
+
+namespace Model
+{
+
+namespace DAO
+{
+
+namespace GRPC
+{
+
+FinishedCache::FinishedCache(size_t capacity) :
+    m_capacity(capacity ? capacity : 1)
+{}
+
+FinishedCache::~FinishedCache()
+{}
+
+u8 FinishedCache::getDetails(const std::string &queue,
+                             const i32 id,
+                             Proc::Task &out)
+{
+    FF_DEBUG("{}:{} FinishedCache::getDetails",
+        LOG_FILE_PATH(__FILE__), __LINE__);
+
+    std::unique_lock<std::mutex> lock(m_mutex);
+    auto it = m_index.find(keyOf(queue, id));
+    if (it == m_index.end())
+    {
+        return 1;
+    }
+
+    m_lru.splice(m_lru.begin(), m_lru, it->second);
+    out = it->second->task;
+    return 0;
+}
+
+void FinishedCache::putDetails(const std::string &queue,
+                               const u64 epoch,
+                               const Proc::Task &task)
+{
+    FF_DEBUG("{}:{} FinishedCache::putDetails",
+        LOG_FILE_PATH(__FILE__), __LINE__);
+
+    std::unique_lock<std::mutex> lock(m_mutex);
+    observe(queue, epoch);
+
+    std::string key = keyOf(queue, task.ID);
+    auto it = m_index.find(key);
+    if (it != m_index.end())
+    {
+        it->second->task = task;
+        m_lru.splice(m_lru.begin(), m_lru, it->second);
+        return;
+    }
+
+    if (m_index.size() >= m_capacity)
+    {
+        m_index.erase(m_lru.back().key);
+        m_lru.pop_back();
+    }
+
+    m_lru.push_front(Entry());
+    m_lru.front().key = key;
+    m_lru.front().queue = queue;
+    m_lru.front().task = task;
+    m_index.emplace(std::move(key), m_lru.begin());
+}
+
+u8 FinishedCache::getList(const std::string &queue,
+                          u64 &epoch,
+                          u64 &version,
+                          std::vector<int> &out)
+{
+    FF_DEBUG("{}:{} FinishedCache::getList", LOG_FILE_PATH(__FILE__), __LINE__);
+
+    std::unique_lock<std::mutex> lock(m_mutex);
+    auto it = m_queues.find(queue);
+    if (it == m_queues.end() || !it->second.hasList)
+    {
+        return 1;
+    }
+
+    epoch = it->second.epoch;
+    version = it->second.version;
+    out = it->second.ids;
+    return 0;
+}
+
+void FinishedCache::putList(const std::string &queue,
+                            const u64 epoch,
+                            const u64 version,
+                            const std::vector<int> &ids)
+{
+    FF_DEBUG("{}:{} FinishedCache::putList", LOG_FILE_PATH(__FILE__), __LINE__);
+
+    std::unique_lock<std::mutex> lock(m_mutex);
+    QueueState &state = observe(queue, epoch);
+    state.version = version;
+
+    // a list larger than the whole cache is not worth keeping
+    state.hasList = ids.size() <= m_capacity;
+    if (state.hasList)
+    {
+        state.ids = ids;
+    }
+    else
+    {
+        state.ids.clear();
+    }
+}
+
+void FinishedCache::generation(const std::string &queue,
+                               u64 &epoch,
+                               u64 &version)
+{
+    std::unique_lock<std::mutex> lock(m_mutex);
+    auto it = m_queues.find(queue);
+    if (it == m_queues.end())
+    {
+        epoch = 0;
+        version = 0;
+        return;
+    }
+
+    epoch = it->second.epoch;
+    version = it->second.version;
+}
+
+void FinishedCache::invalidate(const std::string &queue)
+{
+    FF_DEBUG("{}:{} FinishedCache::invalidate",
+        LOG_FILE_PATH(__FILE__), __LINE__);
+
+    std::unique_lock<std::mutex> lock(m_mutex);
+    dropDetails(queue);
+    m_queues.erase(queue);
+}
+
+// private member functions
+std::string FinishedCache::keyOf(const std::string &queue, const i32 id)
+{
+    // the id ends at the first ':', so keys never collide
+    return std::to_string(id) + ":" + queue;
+}
+
+FinishedCache::QueueState &
+FinishedCache::observe(const std::string &queue, const u64 epoch)
+{
+    QueueState &state = m_queues[queue];
+    if (state.epoch != epoch)
+    {
+        // tasks are removed on the server, or it is another queue now
+        dropDetails(queue);
+        state = QueueState();
+        state.epoch = epoch;
+    }
+
+    return state;
+}
+
+void FinishedCache::dropDetails(const std::string &queue)
+{
+    for (auto it = m_lru.begin(); it != m_lru.end();)
+    {
+        if (it->queue != queue)
+        {
+            ++it;
+            continue;
+        }
+
+        m_index.erase(it->key);
+        it = m_lru.erase(it);
+    }
+}
+
+} // end namespace GRPC
+
+} // end namespace DAO
+
+} // end namespace Model
@@ -0,0 +1,139 @@
+/*
+ * Flex Flow
+ * Copyright (c) 2026-present fdar0536
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#ifndef _MODEL_DAO_GRPC_FINISHEDCACHE_HPP_
+#define _MODEL_DAO_GRPC_FINISHEDCACHE_HPP_
+
+#include <list>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "model/defines.h"
+#include "model/proc/task.hpp"
+
+namespace Model
+{
+
+namespace DAO
+{
+
+namespace GRPC
+{
+
+/**
+ * @brief client side cache of finished tasks
+ *
+ * Task IDs are never reused in a queue, so the details of a finished task
+ * never change until it is removed. Details are kept in an LRU list and are
+ * dropped with their queue when the server reports a new epoch, or when
+ * the queue is cleared, deleted or renamed through this client.
+ * The finished list itself changes, so it is only kept with its version and
+ * revalidated by a conditional ListFinished.
+ */
+class FinishedCache
+{
+public:
+
+    explicit FinishedCache(size_t capacity = 4096);
+
+    ~FinishedCache();
+
+    /**
+     * @return u8 0 if it is cached, 1 if not
+     */
+    u8 getDetails(const std::string &queue, const i32 id, Proc::Task &out);
+
+    void putDetails(const std::string &queue,
+                    const u64 epoch,
+                    const Proc::Task &task);
+
+    /**
+     * @brief get the cached finished list and its generation
+     * @return u8 0 if it is cached, 1 if not
+     */
+    u8 getList(const std::string &queue,
+               u64 &epoch,
+               u64 &version,
+               std::vector<int> &out);
+
+    void putList(const std::string &queue,
+                 const u64 epoch,
+                 const u64 version,
+                 const std::vector<int> &ids);
+
+    /**
+     * @brief the latest generation seen from the server, 0 if unknown
+     */
+    void generation(const std::string &queue, u64 &epoch, u64 &version);
+
+    /**
+     * @brief drop everything of the queue
+     */
+    void invalidate(const std::string &queue);
+
+private:
+
+    typedef struct Entry
+    {
+        std::string key;
+        std::string queue;
+        Proc::Task task;
+    } Entry;
+
+    typedef struct QueueState
+    {
+        u64 epoch = 0;
+        bool hasList = false;
+        u64 version = 0;
+        std::vector<int> ids;
+    } QueueState;
+
+    std::mutex m_mutex;
+
+    size_t m_capacity;
+
+    std::list<Entry> m_lru; // most recent first
+
+    std::unordered_map<std::string, std::list<Entry>::iterator> m_index;
+
+    std::unordered_map<std::string, QueueState> m_queues;
+
+    static std::string keyOf(const std::string &queue, const i32 id);
+
+    // call it with m_mutex locked
+    QueueState &observe(const std::string &queue, const u64 epoch);
+
+    // call it with m_mutex locked
+    void dropDetails(const std::string &queue);
+
+}; // end class FinishedCache
+
+} // end namespace GRPC
+
+} // end namespace DAO
+
+} // end namespace Model
+
+#endif // _MODEL_DAO_GRPC_FINISHEDCACHE_HPP_
@@ -51,9 +51,10 @@ Queue::~Queue()
 
 u8
 Queue::init(std::shared_ptr<Connect::GRPC::Token> &token,
-            const std::string &name)
+            const std::string &name,
+            const std::shared_ptr<FinishedCache> &cache)
 {
-    spdlog::debug("{}:{} Queue::init", LOG_FILE_PATH(__FILE__), __LINE__);
+    FF_DEBUG("{}:{} Queue::init", LOG_FILE_PATH(__FILE__), __LINE__);
 
     if (token == nullptr)
     {
@@ -86,14 +87,20 @@ Queue::init(std::shared_ptr<Connect::GRPC::Token> &token,
         return ErrCode_OS_ERROR;
     }
 
+    m_cache = cache;
+    if (!m_cache)
+    {
+        m_cache = std::make_shared<FinishedCache>();
+    }
+
     m_queueName = name;
-    m_token = token->token;
+    m_token = token;
     return ErrCode_OK;
 }
 
 u8 Queue::listPending(std::vector<int> &out)
 {
-    spdlog::debug("{}:{} Queue::listPending", LOG_FILE_PATH(__FILE__), __LINE__);
+    FF_DEBUG("{}:{} Queue::listPending", LOG_FILE_PATH(__FILE__), __LINE__);
 
     out.clear();
     out.reserve(128);
@@ -101,29 +108,36 @@ u8 Queue::listPending(std::vector<int> &out)
     ff::QueueReq req;
     req.set_name(m_queueName);
 
-    grpc::ClientContext ctx;
     ff::ListTaskRes res;
-
-    Utils::setupCtx(ctx, m_token);
-    auto reader = m_stub->ListPending(&ctx, req);
-    if (reader == nullptr)
+    grpc::Status status = Utils::call(*m_token, [&](grpc::ClientContext &ctx)
     {
-        spdlog::error("{}:{} reader is nullptr", LOG_FILE_PATH(__FILE__), __LINE__);
-        return ErrCode_OS_ERROR;
-    }
+        out.clear();
+        auto reader = m_stub->ListPending(&ctx, req);
+        if (reader == nullptr)
+        {
+            return grpc::Status(grpc::StatusCode::INTERNAL, "reader is nullptr");
+        }
+
+        while(reader->Read(&res))
+        {
+            out.push_back(res.id());
+        }
+
+        return reader->Finish();
+    });
 
-    while(reader->Read(&res))
+    if (status.ok())
     {
-        out.push_back(res.id());
+        return ErrCode_OK;
     }
 
-    UNUSED(reader->Finish());
-    return ErrCode_OK;
+    Utils::buildErrMsg(LOG_FILE_PATH(__FILE__), __LINE__, status);
+    return ErrCode_OS_ERROR;
 }
 
 u8 Queue::listFinished(std::vector<int> &out)
 {
-    spdlog::debug("{}:{} Queue::listFinished",
+    FF_DEBUG("{}:{} Queue::listFinished",
         LOG_FILE_PATH(__FILE__), __LINE__);
 
     out.clear();
@@ -132,41 +146,82 @@ u8 Queue::listFinished(std::vector<int> &out)
     ff::QueueReq req;
     req.set_name(m_queueName);
 
-    grpc::ClientContext ctx;
-    ff::ListTaskRes res;
+    // only ask for the list if it changed since the cached one
+    u64 cachedEpoch(0), cachedVersion(0);
+    std::vector<int> cached;
+    bool isCached = !m_cache->getList(m_queueName, cachedEpoch,
+                                      cachedVersion, cached);
 
-    Utils::setupCtx(ctx, m_token);
-    auto reader = m_stub->ListFinished(&ctx, req);
-    if (reader == nullptr)
+    ff::ListTaskRes res;
+    u64 epoch(0), version(0);
+    bool isNotModified(false);
+    grpc::Status status = Utils::call(*m_token, [&](grpc::ClientContext &ctx)
     {
-        spdlog::error("{}:{} reader is nullptr", LOG_FILE_PATH(__FILE__), __LINE__);
-        return ErrCode_OS_ERROR;
-    }
+        out.clear();
+        if (isCached)
+        {
+            ctx.AddMetadata("x-ff-if-epoch", std::to_string(cachedEpoch));
+            ctx.AddMetadata("x-ff-if-version", std::to_string(cachedVersion));
+        }
+
+        auto reader = m_stub->ListFinished(&ctx, req);
+        if (reader == nullptr)
+        {
+            return grpc::Status(grpc::StatusCode::INTERNAL, "reader is nullptr");
+        }
 
-    while(reader->Read(&res))
+        while(reader->Read(&res))
+        {
+            out.push_back(res.id());
+        }
+
+        grpc::Status ret = reader->Finish();
+        u64 flag(0);
+        isNotModified = !Utils::getTrailingU64(ctx, "x-ff-not-modified", flag) && flag;
+        if (Utils::getTrailingU64(ctx, "x-ff-finished-epoch", epoch) ||
+            Utils::getTrailingU64(ctx, "x-ff-finished-version", version))
+        {
+            epoch = 0; // an older server, do not cache
+        }
+
+        return ret;
+    });
+
+    if (status.ok())
     {
-        out.push_back(res.id());
+        if (isNotModified && isCached)
+        {
+            out = std::move(cached);
+            return ErrCode_OK;
+        }
+
+        if (epoch)
+        {
+            m_cache->putList(m_queueName, epoch, version, out);
+        }
+
+        return ErrCode_OK;
     }
 
-    UNUSED(reader->Finish());
-    return ErrCode_OK;
+    Utils::buildErrMsg(LOG_FILE_PATH(__FILE__), __LINE__, status);
+    return ErrCode_OS_ERROR;
 }
 
 u8 Queue::pendingDetails(const int id,
                              Proc::Task &out)
 {
-    spdlog::debug("{}:{} Queue::pendingDetails",
+    FF_DEBUG("{}:{} Queue::pendingDetails",
         LOG_FILE_PATH(__FILE__), __LINE__);
 
     ff::TaskDetailsReq req;
     req.set_name(m_queueName);
     req.set_id(id);
 
-    grpc::ClientContext ctx;
     ff::TaskDetailsRes res;
-
-    Utils::setupCtx(ctx, m_token);
-    grpc::Status status = m_stub->PendingDetails(&ctx, req, &res);
+    grpc::Status status = Utils::call(*m_token, [&](grpc::ClientContext &ctx)
+    {
+        return m_stub->PendingDetails(&ctx, req, &res);
+    });
     if (status.ok())
     {
         buildTask(res, out);
@@ -180,21 +235,38 @@ u8 Queue::pendingDetails(const int id,
 u8 Queue::finishedDetails(const int id,
                               Proc::Task &out)
 {
-    spdlog::debug("{}:{} Queue::finishedDetails",
+    FF_DEBUG("{}:{} Queue::finishedDetails",
         LOG_FILE_PATH(__FILE__), __LINE__);
 
+    if (!m_cache->getDetails(m_queueName, id, out))
+    {
+        return ErrCode_OK;
+    }
+
     ff::TaskDetailsReq req;
     req.set_name(m_queueName);
     req.set_id(id);
 
-    grpc::ClientContext ctx;
     ff::TaskDetailsRes res;
+    u64 epoch(0);
+    grpc::Status status = Utils::call(*m_token, [&](grpc::ClientContext &ctx)
+    {
+        grpc::Status ret = m_stub->FinishedDetails(&ctx, req, &res);
+        if (Utils::getTrailingU64(ctx, "x-ff-finished-epoch", epoch))
+        {
+            epoch = 0; // an older server, do not cache
+        }
 
-    Utils::setupCtx(ctx, m_token);
-    grpc::Status status = m_stub->FinishedDetails(&ctx, req, &res);
+        return ret;
+    });
     if (status.ok())
     {
         buildTask(res, out);
+        if (epoch)
+        {
+            m_cache->putDetails(m_queueName, epoch, out);
+        }
+
         return ErrCode_OK;
     }
 
@@ -204,17 +276,17 @@ u8 Queue::finishedDetails(const int id,
 
 u8 Queue::clearPending()
 {
-    spdlog::debug("{}:{} Queue::clearPending",
+    FF_DEBUG("{}:{} Queue::clearPending",
         LOG_FILE_PATH(__FILE__), __LINE__);
 
     ff::QueueReq req;
     req.set_name(m_queueName);
 
-    grpc::ClientContext ctx;
     ff::Empty res;
-
-    Utils::setupCtx(ctx, m_token);
-    grpc::Status status = m_stub->ClearPending(&ctx, req, &res);
+    grpc::Status status = Utils::call(*m_token, [&](grpc::ClientContext &ctx)
+    {
+        return m_stub->ClearPending(&ctx, req, &res);
+    });
     if (status.ok())
     {
         return ErrCode_OK;
@@ -226,17 +298,20 @@ u8 Queue::clearPending()
 
 u8 Queue::clearFinished()
 {
-    spdlog::debug("{}:{} Queue::clearFinished",
+    FF_DEBUG("{}:{} Queue::clearFinished",
         LOG_FILE_PATH(__FILE__), __LINE__);
 
     ff::QueueReq req;
     req.set_name(m_queueName);
 
-    grpc::ClientContext ctx;
     ff::Empty res;
+    grpc::Status status = Utils::call(*m_token, [&](grpc::ClientContext &ctx)
+    {
+        return m_stub->ClearFinished(&ctx, req, &res);
+    });
 
-    Utils::setupCtx(ctx, m_token);
-    grpc::Status status = m_stub->ClearFinished(&ctx, req, &res);
+    // whatever the result is, the cached list may be wrong now
+    m_cache->invalidate(m_queueName);
     if (status.ok())
     {
         return ErrCode_OK;
@@ -248,17 +323,17 @@ u8 Queue::clearFinished()
 
 u8 Queue::currentTask(Proc::Task &out)
 {
-    spdlog::debug("{}:{} Queue::currentTask",
+    FF_DEBUG("{}:{} Queue::currentTask",
         LOG_FILE_PATH(__FILE__), __LINE__);
 
     ff::QueueReq req;
     req.set_name(m_queueName);
 
-    grpc::ClientContext ctx;
     ff::TaskDetailsRes res;
-
-    Utils::setupCtx(ctx, m_token);
-    grpc::Status status = m_stub->CurrentTask(&ctx, req, &res);
+    grpc::Status status = Utils::call(*m_token, [&](grpc::ClientContext &ctx)
+    {
+        return m_stub->CurrentTask(&ctx, req, &res);
+    });
     if (status.ok())
     {
         buildTask(res, out);
@@ -272,7 +347,7 @@ u8 Queue::currentTask(Proc::Task &out)
 
 u8 Queue::addTask(Proc::Task &in)
 {
-    spdlog::debug("{}:{} Queue::addTask",
+    FF_DEBUG("{}:{} Queue::addTask",
         LOG_FILE_PATH(__FILE__), __LINE__);
 
     ff::AddTaskReq req;
@@ -286,11 +361,17 @@ u8 Queue::addTask(Proc::Task &in)
         req.add_args(*it);
     }
 
-    grpc::ClientContext ctx;
-    ff::ListTaskRes res;
+    req.set_cpus(in.cpus);
+    req.set_memorymb(in.memoryMB);
+    req.set_priority(in.priority);
+    req.set_walltimeoutsec(in.wallTimeoutSec);
+    req.set_cputimeoutsec(in.cpuTimeoutSec);
 
-    Utils::setupCtx(ctx, m_token);
-    grpc::Status status = m_stub->AddTask(&ctx, req, &res);
+    ff::ListTaskRes res;
+    grpc::Status status = Utils::call(*m_token, [&](grpc::ClientContext &ctx)
+    {
+        return m_stub->AddTask(&ctx, req, &res);
+    });
     if (status.ok())
     {
         in.ID = res.id();
@@ -304,20 +385,42 @@ u8 Queue::addTask(Proc::Task &in)
 
 u8 Queue::removeTask(const i32 in)
 {
-    spdlog::debug("{}:{} Queue::removeTask",
+    FF_DEBUG("{}:{} Queue::removeTask",
         LOG_FILE_PATH(__FILE__), __LINE__);
 
     ff::TaskDetailsReq req;
     req.set_name(m_queueName);
     req.set_id(in);
 
-    grpc::ClientContext ctx;
     ff::Empty res;
+    grpc::Status status = Utils::call(*m_token, [&](grpc::ClientContext &ctx)
+    {
+        return m_stub->RemoveTask(&ctx, req, &res);
+    });
+    if (!status.ok())
+    {
+        Utils::buildErrMsg(LOG_FILE_PATH(__FILE__), __LINE__, status);
+        return ErrCode_OS_ERROR;
+    }
+
+    return ErrCode_OK;
+}
+
+u8 Queue::reprioritize(const i32 id, const i32 priority)
+{
+    FF_DEBUG("{}:{} Queue::reprioritize",
+        LOG_FILE_PATH(__FILE__), __LINE__);
 
-    Utils::setupCtx(ctx, m_token);
-    grpc::Status status;
+    ff::ReprioritizeReq req;
+    req.set_name(m_queueName);
+    req.set_id(id);
+    req.set_priority(priority);
 
-    status = m_stub->RemoveTask(&ctx, req, &res);
+    ff::Empty res;
+    grpc::Status status = Utils::call(*m_token, [&](grpc::ClientContext &ctx)
+    {
+        return m_stub->Reprioritize(&ctx, req, &res);
+    });
     if (!status.ok())
     {
         Utils::buildErrMsg(LOG_FILE_PATH(__FILE__), __LINE__, status);
@@ -329,17 +432,17 @@ u8 Queue::removeTask(const i32 in)
 
 bool Queue::isRunning() const
 {
-    spdlog::debug("{}:{} Queue::isRunning",
+    FF_DEBUG("{}:{} Queue::isRunning",
         LOG_FILE_PATH(__FILE__), __LINE__);
 
     ff::QueueReq req;
     req.set_name(m_queueName);
 
-    grpc::ClientContext ctx;
     ff::IsRunningRes res;
-
-    Utils::setupCtx(ctx, m_token);
-    grpc::Status status = m_stub->IsRunning(&ctx, req, &res);
+    grpc::Status status = Utils::call(*m_token, [&](grpc::ClientContext &ctx)
+    {
+        return m_stub->IsRunning(&ctx, req, &res);
+    });
     if (status.ok())
     {
         return res.isrunning();
@@ -351,7 +454,7 @@ bool Queue::isRunning() const
 
 void Queue::readCurrentOutput(std::vector<std::string> &out)
 {
-    spdlog::debug("{}:{} Queue::readCurrentOutput",
+    FF_DEBUG("{}:{} Queue::readCurrentOutput",
         LOG_FILE_PATH(__FILE__), __LINE__);
 
     out.clear();
@@ -360,37 +463,42 @@ void Queue::readCurrentOutput(std::vector<std::string> &out)
     ff::QueueReq req;
     req.set_name(m_queueName);
 
-    grpc::ClientContext ctx;
     ff::Msg res;
-    Utils::setupCtx(ctx, m_token);
-
-    auto reader = m_stub->ReadCurrentOutput(&ctx, req);
-    if (reader == nullptr)
+    grpc::Status status = Utils::call(*m_token, [&](grpc::ClientContext &ctx)
     {
-        spdlog::error("{}:{} reader is nullptr", LOG_FILE_PATH(__FILE__), __LINE__);
-        return;
-    }
+        out.clear();
+        auto reader = m_stub->ReadCurrentOutput(&ctx, req);
+        if (reader == nullptr)
+        {
+            return grpc::Status(grpc::StatusCode::INTERNAL, "reader is nullptr");
+        }
 
-    while (reader->Read(&res))
+        while (reader->Read(&res))
+        {
+            out.push_back(std::move(*res.mutable_msg()));
+        }
+
+        return reader->Finish();
+    });
+
+    if (!status.ok())
     {
-        out.push_back(std::move(res.msg()));
+        Utils::buildErrMsg(LOG_FILE_PATH(__FILE__), __LINE__, status);
     }
-
-    UNUSED(reader->Finish());
 }
 
 u8 Queue::start()
 {
-    spdlog::debug("{}:{} Queue::start", LOG_FILE_PATH(__FILE__), __LINE__);
+    FF_DEBUG("{}:{} Queue::start", LOG_FILE_PATH(__FILE__), __LINE__);
 
     ff::QueueReq req;
     req.set_name(m_queueName);
 
-    grpc::ClientContext ctx;
     ff::Empty res;
-
-    Utils::setupCtx(ctx, m_token);
-    grpc::Status status = m_stub->Start(&ctx, req, &res);
+    grpc::Status status = Utils::call(*m_token, [&](grpc::ClientContext &ctx)
+    {
+        return m_stub->Start(&ctx, req, &res);
+    });
     if (status.ok())
     {
         return ErrCode_OK;
@@ -402,16 +510,16 @@ u8 Queue::start()
 
 void Queue::stop()
 {
-    spdlog::debug("{}:{} Queue::stop", LOG_FILE_PATH(__FILE__), __LINE__);
+    FF_DEBUG("{}:{} Queue::stop", LOG_FILE_PATH(__FILE__), __LINE__);
 
     ff::QueueReq req;
     req.set_name(m_queueName);
 
-    grpc::ClientContext ctx;
     ff::Empty res;
-
-    Utils::setupCtx(ctx, m_token);
-    grpc::Status status = m_stub->Stop(&ctx, req, &res);
+    grpc::Status status = Utils::call(*m_token, [&](grpc::ClientContext &ctx)
+    {
+        return m_stub->Stop(&ctx, req, &res);
+    });
     if (status.ok())
     {
         return;
@@ -420,10 +528,15 @@ void Queue::stop()
     Utils::buildErrMsg(LOG_FILE_PATH(__FILE__), __LINE__, status);
 }
 
-// private member functions
+void Queue::finishedGeneration(u64 &epoch, u64 &version) const
+{
+    m_cache->generation(m_queueName, epoch, version);
+}
+
+// static member functions
 void Queue::buildTask(ff::TaskDetailsRes &res, Proc::Task &task)
 {
-    spdlog::debug("{}:{} Queue::buildTask", LOG_FILE_PATH(__FILE__), __LINE__);
+    FF_DEBUG("{}:{} Queue::buildTask", LOG_FILE_PATH(__FILE__), __LINE__);
 
     task.workDir = res.workdir();
     task.execName = res.execname();
@@ -436,6 +549,25 @@ void Queue::buildTask(ff::TaskDetailsRes &res, Proc::Task &task)
 
     task.exitCode = res.exitcode();
     task.ID = res.id();
+    task.cpus = res.cpus();
+    task.memoryMB = res.memorymb();
+    task.priority = res.priority();
+    task.suspendedMs = res.suspendedms();
+    task.enqueueTime = res.enqueuetime();
+    task.startTime = res.starttime();
+    task.endTime = res.endtime();
+    task.wallTimeoutSec = res.walltimeoutsec();
+    task.cpuTimeoutSec = res.cputimeoutsec();
+    task.isTimedOut = res.istimedout();
+    task.cpuUsageUs = res.cpuusageus();
+    task.memoryPeakBytes = res.memorypeakbytes();
+    task.ioReadBytes = res.ioreadbytes();
+    task.ioWriteBytes = res.iowritebytes();
+    task.userTimeUs = res.usertimeus();
+    task.systemTimeUs = res.systemtimeus();
+    task.maxRssKB = res.maxrsskb();
+    task.majorFaults = res.majorfaults();
+    task.minorFaults = res.minorfaults();
 }
 
 } // end namespace GRPC
@@ -27,6 +27,7 @@
 #include "queue.grpc.pb.h"
 
 #include "model/connect/grpc/connect.hpp"
+#include "model/dao/grpc/finishedcache.hpp"
 #include "model/proc/task.hpp"
 #include "model/dao/iqueue.hpp"
 
@@ -48,8 +49,13 @@ public:
 
     ~Queue();
 
+    /**
+     * @param cache shared by the queues of one connection,
+     * a new one is created if it is nullptr
+     */
     u8 init(std::shared_ptr<Connect::GRPC::Token> &token,
-            const std::string &name);
+            const std::string &name,
+            const std::shared_ptr<FinishedCache> &cache = nullptr);
 
     u8 listPending(std::vector<int> &out) override;
 
@@ -71,6 +77,8 @@ public:
 
     u8 removeTask(const i32 in) override;
 
+    u8 reprioritize(const i32 id, const i32 priority) override;
+
     bool isRunning() const override;
 
     void readCurrentOutput(std::vector<std::string> &out) override;
@@ -79,15 +87,19 @@ public:
 
     void stop() override;
 
+    void finishedGeneration(u64 &epoch, u64 &version) const override;
+
+    static void buildTask(ff::TaskDetailsRes &res, Proc::Task &task);
+
 private:
 
     std::unique_ptr<ff::Queue::Stub> m_stub;
 
-    std::string m_token;
+    std::shared_ptr<Connect::GRPC::Token> m_token;
 
     std::string m_queueName;
 
-    static void buildTask(ff::TaskDetailsRes &res, Proc::Task &task);
+    std::shared_ptr<FinishedCache> m_cache;
 
 }; // end class Queue
 
@@ -51,7 +51,7 @@ QueueList::~QueueList()
 
 u8 QueueList::init(std::shared_ptr<Connect::GRPC::Token> &token)
 {
-    spdlog::debug("{}:{} QueueList::init", LOG_FILE_PATH(__FILE__), __LINE__);
+    FF_DEBUG("{}:{} QueueList::init", LOG_FILE_PATH(__FILE__), __LINE__);
 
     if (token == nullptr)
     {
@@ -60,6 +60,7 @@ u8 QueueList::init(std::shared_ptr<Connect::GRPC::Token> &token)
     }
 
     m_token = token;
+    m_cache = std::make_shared<FinishedCache>();
     try
     {
         m_stub = ff::QueueList::NewStub(m_token->channel);
@@ -81,17 +82,17 @@ u8 QueueList::init(std::shared_ptr<Connect::GRPC::Token> &token)
 
 u8 QueueList::createQueue(const std::string &name)
 {
-    spdlog::debug("{}:{} QueueList::createQueue",
+    FF_DEBUG("{}:{} QueueList::createQueue",
         LOG_FILE_PATH(__FILE__), __LINE__);
 
     ff::QueueReq req;
     req.set_name(name);
 
     ff::Empty res;
-    grpc::ClientContext ctx;
-
-    Utils::setupCtx(ctx, m_token->token);
-    grpc::Status status = m_stub->Create(&ctx, req, &res);
+    grpc::Status status = Utils::call(*m_token, [&](grpc::ClientContext &ctx)
+    {
+        return m_stub->Create(&ctx, req, &res);
+    });
     if (status.ok())
     {
         return ErrCode_OK;
@@ -103,7 +104,7 @@ u8 QueueList::createQueue(const std::string &name)
 
 u8 QueueList::listQueue(std::vector<std::string> &out)
 {
-    spdlog::debug("{}:{} QueueList::listQueue",
+    FF_DEBUG("{}:{} QueueList::listQueue",
         LOG_FILE_PATH(__FILE__), __LINE__);
 
     out.clear();
@@ -111,22 +112,22 @@ u8 QueueList::listQueue(std::vector<std::string> &out)
 
     ff::Empty req;
     ff::ListQueueRes res;
-    grpc::ClientContext ctx;
-
-    Utils::setupCtx(ctx, m_token->token);
-    auto reader = m_stub->List(&ctx, req);
-    if (reader == nullptr)
+    grpc::Status status = Utils::call(*m_token, [&](grpc::ClientContext &ctx)
     {
-        spdlog::error("{}:{} reader is nullptr", LOG_FILE_PATH(__FILE__), __LINE__);
-        return ErrCode_OS_ERROR;
-    }
+        out.clear();
+        auto reader = m_stub->List(&ctx, req);
+        if (reader == nullptr)
+        {
+            return grpc::Status(grpc::StatusCode::INTERNAL, "reader is nullptr");
+        }
 
-    while (reader->Read(&res))
-    {
-        out.push_back(res.name());
-    }
+        while (reader->Read(&res))
+        {
+            out.push_back(res.name());
+        }
 
-    grpc::Status status = reader->Finish();
+        return reader->Finish();
+    });
     if (status.ok())
     {
         return ErrCode_OK;
@@ -138,17 +139,19 @@ u8 QueueList::listQueue(std::vector<std::string> &out)
 
 u8 QueueList::deleteQueue(const std::string &name)
 {
-    spdlog::debug("{}:{} QueueList::deleteQueue",
+    FF_DEBUG("{}:{} QueueList::deleteQueue",
         LOG_FILE_PATH(__FILE__), __LINE__);
 
     ff::QueueReq req;
     req.set_name(name);
 
     ff::Empty res;
-    grpc::ClientContext ctx;
+    grpc::Status status = Utils::call(*m_token, [&](grpc::ClientContext &ctx)
+    {
+        return m_stub->Delete(&ctx, req, &res);
+    });
 
-    Utils::setupCtx(ctx, m_token->token);
-    grpc::Status status = m_stub->Delete(&ctx, req, &res);
+    m_cache->invalidate(name);
     if (status.ok())
     {
         return ErrCode_OK;
@@ -161,7 +164,7 @@ u8 QueueList::deleteQueue(const std::string &name)
 u8 QueueList::renameQueue(const std::string &oldName,
                               const std::string &newName)
 {
-    spdlog::debug("{}:{} QueueList::renameQueue",
+    FF_DEBUG("{}:{} QueueList::renameQueue",
         LOG_FILE_PATH(__FILE__), __LINE__);
 
     ff::RenameQueueReq req;
@@ -169,10 +172,13 @@ u8 QueueList::renameQueue(const std::string &oldName,
     req.set_newname(newName);
 
     ff::Empty res;
-    grpc::ClientContext ctx;
+    grpc::Status status = Utils::call(*m_token, [&](grpc::ClientContext &ctx)
+    {
+        return m_stub->Rename(&ctx, req, &res);
+    });
 
-    Utils::setupCtx(ctx, m_token->token);
-    grpc::Status status = m_stub->Rename(&ctx, req, &res);
+    m_cache->invalidate(oldName);
+    m_cache->invalidate(newName);
     if (status.ok())
     {
         return ErrCode_OK;
@@ -184,17 +190,17 @@ u8 QueueList::renameQueue(const std::string &oldName,
 
 std::shared_ptr<IQueue> QueueList::getQueue(const std::string &name)
 {
-    spdlog::debug("{}:{} QueueList::getQueue",
+    FF_DEBUG("{}:{} QueueList::getQueue",
         LOG_FILE_PATH(__FILE__), __LINE__);
 
     ff::QueueReq req;
     req.set_name(name);
 
     ff::Empty res;
-    grpc::ClientContext ctx;
-
-    Utils::setupCtx(ctx, m_token->token);
-    grpc::Status status = m_stub->GetQueue(&ctx, req, &res);
+    grpc::Status status = Utils::call(*m_token, [&](grpc::ClientContext &ctx)
+    {
+        return m_stub->GetQueue(&ctx, req, &res);
+    });
     if (status.ok())
     {
         Queue *queue = new (std::nothrow) Queue;
@@ -205,7 +211,7 @@ std::shared_ptr<IQueue> QueueList::getQueue(const std::string &name)
             return nullptr;
         }
 
-        if (queue->init(m_token, name))
+        if (queue->init(m_token, name, m_cache))
         {
             spdlog::error("{}:{} Fail to initialize queue",
                 LOG_FILE_PATH(__FILE__), __LINE__);
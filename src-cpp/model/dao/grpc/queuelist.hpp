@@ -26,6 +26,7 @@
 
 #include "model/connect/grpc/connect.hpp"
 #include "model/dao/iqueuelist.hpp"
+#include "model/dao/grpc/finishedcache.hpp"
 
 #include "queuelist.grpc.pb.h"
 
@@ -66,6 +67,8 @@ private:
 
     std::shared_ptr<Connect::GRPC::Token> m_token;
 
+    std::shared_ptr<FinishedCache> m_cache;
+
 }; // end class QueueList
 
 } // end namespace GRPC
@@ -22,6 +22,8 @@
  */
 
 
+#include <charconv>
+
 #include "spdlog/spdlog.h"
 
 #include "model/utils.hpp"
@@ -40,12 +42,15 @@ namespace GRPC
 namespace Utils
 {
 
-void setupCtx(grpc::ClientContext &ctx, const std::string &token)
+void setupCtx(grpc::ClientContext &ctx,
+              const std::string &token,
+              const u64 timeoutMs)
 {
-    spdlog::debug("{}:{} setupCtx", LOG_FILE_PATH(__FILE__), __LINE__);
+    FF_DEBUG("{}:{} setupCtx", LOG_FILE_PATH(__FILE__), __LINE__);
     
     ctx.set_deadline(std::chrono::system_clock::now() +
-                     std::chrono::milliseconds(FF_CLIENT_TIMEOUT * 1000));
+                     std::chrono::milliseconds(
+                        timeoutMs ? timeoutMs : FF_CLIENT_TIMEOUT * 1000));
     if (token.empty())
     {
         return;
@@ -56,12 +61,29 @@ void setupCtx(grpc::ClientContext &ctx, const std::string &token)
 
 void buildErrMsg(const std::string_view &file, i32 line, grpc::Status &status)
 {
-    spdlog::debug("{}:{} buildErrMsg", LOG_FILE_PATH(__FILE__), __LINE__);
+    FF_DEBUG("{}:{} buildErrMsg", LOG_FILE_PATH(__FILE__), __LINE__);
 
     spdlog::error("{}:{} gRPC error code {}: {}", file, line,
                   static_cast<i32>(status.error_code()), status.error_message());
 }
 
+u8 getTrailingU64(const grpc::ClientContext &ctx, const std::string &key, u64 &out)
+{
+    FF_DEBUG("{}:{} getTrailingU64", LOG_FILE_PATH(__FILE__), __LINE__);
+
+    auto &metadata = ctx.GetServerTrailingMetadata();
+    auto it = metadata.find(key);
+    if (it == metadata.end())
+    {
+        return 1;
+    }
+
+    auto res = std::from_chars(it->second.data(),
+                               it->second.data() + it->second.length(),
+                               out);
+    return res.ec == std::errc() ? 0 : 1;
+}
+
 } // end namespace Utils
 
 } // end namespace GRPC
@@ -27,6 +27,7 @@
 #include "grpcpp/grpcpp.h"
 
 #include "model/defines.h"
+#include "model/connect/grpc/connect.hpp"
 
 namespace Model
 {
@@ -40,10 +41,50 @@ namespace GRPC
 namespace Utils
 {
 
-void setupCtx(grpc::ClientContext &ctx, const std::string &token = "");
+/**
+ * @param timeoutMs deadline of the call, 0 means FF_CLIENT_TIMEOUT seconds
+ */
+void setupCtx(grpc::ClientContext &ctx,
+              const std::string &token = "",
+              const u64 timeoutMs = 0);
 
 void buildErrMsg(const std::string_view &, i32, grpc::Status &);
 
+/**
+ * @brief read a number from the trailing metadata of a finished call
+ * @return u8 0 on success, 1 if it is not found or invalid
+ */
+u8 getTrailingU64(const grpc::ClientContext &ctx, const std::string &key, u64 &out);
+
+/**
+ * @brief run fn(grpc::ClientContext &) with the token of the connection,
+ * login again and retry once if the token is rejected
+ *
+ * fn may run twice, so it must reset its output first.
+ */
+template <typename Fn>
+grpc::Status call(Connect::GRPC::Token &token, Fn &&fn)
+{
+    std::string used = Connect::GRPC::currentToken(token);
+    grpc::Status status;
+    for (u8 attempt = 0; attempt < 2; ++attempt)
+    {
+        grpc::ClientContext ctx;
+        setupCtx(ctx, used, token.options.callTimeoutMs);
+        status = fn(ctx);
+        if (status.error_code() != grpc::StatusCode::UNAUTHENTICATED ||
+            attempt ||
+            Connect::GRPC::refresh(token, used))
+        {
+            break;
+        }
+
+        used = Connect::GRPC::currentToken(token);
+    }
+
+    return status;
+}
+
 } // end namespace Utils
 
 } // end namespace GRPC
@@ -0,0 +1,100 @@
+/*
+ * Flex Flow
+ * Copyright (c) 2026-present fdar0536
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#ifndef _MODEL_DAO_IASYNCQUEUE_HPP_
+#define _MODEL_DAO_IASYNCQUEUE_HPP_
+
+#include <future>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "model/errmsg.hpp"
+#include "model/proc/task.hpp"
+
+namespace Model
+{
+
+namespace DAO
+{
+
+/**
+ * @brief the error code of an asynchronous call and its output
+ */
+template <typename T>
+struct AsyncResult
+{
+    u8 code = ErrCode_OK;
+    T value = T();
+};
+
+/**
+ * @brief asynchronous version of IQueue
+ *
+ * Every call returns immediately, so many calls can be in flight at once.
+ */
+class IAsyncQueue
+{
+public:
+
+    virtual ~IAsyncQueue() {}
+
+    virtual std::future<AsyncResult<std::vector<int>>> listPending() = 0;
+
+    virtual std::future<AsyncResult<std::vector<int>>> listFinished() = 0;
+
+    virtual std::future<AsyncResult<Proc::Task>> pendingDetails(const int id) = 0;
+
+    virtual std::future<AsyncResult<Proc::Task>> finishedDetails(const int id) = 0;
+
+    virtual std::future<u8> clearPending() = 0;
+
+    virtual std::future<u8> clearFinished() = 0;
+
+    virtual std::future<AsyncResult<Proc::Task>> currentTask() = 0;
+
+    /**
+     * @return the task with its new ID
+     */
+    virtual std::future<AsyncResult<Proc::Task>> addTask(const Proc::Task &in) = 0;
+
+    virtual std::future<u8> removeTask(const i32 id) = 0;
+
+    virtual std::future<u8> reprioritize(const i32 id, const i32 priority) = 0;
+
+    virtual std::future<AsyncResult<bool>> isRunning() = 0;
+
+    virtual std::future<AsyncResult<std::vector<std::string>>>
+    readCurrentOutput() = 0;
+
+    virtual std::future<u8> start() = 0;
+
+    virtual std::future<u8> stop() = 0;
+
+}; // end class IAsyncQueue
+
+} // end namespace DAO
+
+} // end namespace Model
+
+#endif // _MODEL_DAO_IASYNCQUEUE_HPP_
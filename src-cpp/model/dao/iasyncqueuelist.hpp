@@ -0,0 +1,68 @@
+/*
+ * Flex Flow
+ * Copyright (c) 2026-present fdar0536
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#ifndef _MODEL_DAO_IASYNCQUEUELIST_HPP_
+#define _MODEL_DAO_IASYNCQUEUELIST_HPP_
+
+#include <string>
+#include <vector>
+
+#include "iasyncqueue.hpp"
+
+namespace Model
+{
+
+namespace DAO
+{
+
+/**
+ * @brief asynchronous version of IQueueList
+ */
+class IAsyncQueueList
+{
+public:
+
+    virtual ~IAsyncQueueList() {}
+
+    virtual std::future<u8> createQueue(const std::string &name) = 0;
+
+    virtual std::future<AsyncResult<std::vector<std::string>>> listQueue() = 0;
+
+    virtual std::future<u8> deleteQueue(const std::string &name) = 0;
+
+    virtual std::future<u8> renameQueue(const std::string &oldName,
+                                        const std::string &newName) = 0;
+
+    /**
+     * @return nullptr in value if the queue is not found
+     */
+    virtual std::future<AsyncResult<std::shared_ptr<IAsyncQueue>>>
+    getQueue(const std::string &name) = 0;
+
+}; // end class IAsyncQueueList
+
+} // end namespace DAO
+
+} // end namespace Model
+
+#endif // _MODEL_DAO_IASYNCQUEUELIST_HPP_
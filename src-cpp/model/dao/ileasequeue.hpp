@@ -0,0 +1,99 @@
+/*
+ * Flex Flow
+ * Copyright (c) 2026-present fdar0536
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#ifndef _MODEL_DAO_ILEASEQUEUE_HPP_
+#define _MODEL_DAO_ILEASEQUEUE_HPP_
+
+#include <string>
+#include <vector>
+
+#include "model/proc/task.hpp"
+
+namespace Model
+{
+
+namespace DAO
+{
+
+/**
+ * @brief a queue whose pending tasks can be run by remote workers
+ *
+ * A leased task stays in the pending list until its result is reported,
+ * so it is given to another worker once the lease expires.
+ */
+class ILeaseQueue
+{
+public:
+
+    virtual ~ILeaseQueue() {}
+
+    /**
+     * @brief lease the first pending task which is not running
+     * @param worker identify the worker in the other calls
+     * @return u8 ErrCode_NOT_FOUND if there is nothing to run
+     */
+    virtual u8 leaseTask(const std::string &worker,
+                         const u32 leaseMs,
+                         Proc::Task &out) = 0;
+
+    /**
+     * @return u8 ErrCode_NOT_FOUND if the lease is gone,
+     * the worker should stop the task then
+     */
+    virtual u8 renewLease(const std::string &worker,
+                          const i32 id,
+                          const u32 leaseMs) = 0;
+
+    /**
+     * @brief keep the output of a leased task for readCurrentOutput
+     */
+    virtual u8 appendLeaseOutput(const std::string &worker,
+                                 const i32 id,
+                                 std::vector<std::string> &output) = 0;
+
+    /**
+     * @brief move the leased task to the finished list
+     * @param isTimedOut the worker stopped it at its time limit
+     * @param isFailed the worker could not run it, so its run time
+     * says nothing about the task
+     * @return u8 ErrCode_NOT_FOUND if the lease is gone
+     */
+    virtual u8 finishLease(const std::string &worker,
+                           const i32 id,
+                           const i32 exitCode,
+                           const bool isTimedOut,
+                           const bool isFailed) = 0;
+
+    /**
+     * @brief give the tasks of a worker back to the pending list at once,
+     * e.g. when it disconnects
+     */
+    virtual void releaseLeases(const std::string &worker) = 0;
+
+}; // end class ILeaseQueue
+
+} // end namespace DAO
+
+} // end namespace Model
+
+#endif // _MODEL_DAO_ILEASEQUEUE_HPP_
@@ -61,6 +61,11 @@ public:
 
     virtual u8 removeTask(const i32 in) = 0;
 
+    /**
+     * @brief change the priority of a pending task, it keeps its ID
+     */
+    virtual u8 reprioritize(const i32 id, const i32 priority) = 0;
+
     virtual bool isRunning() const = 0;
 
     virtual void readCurrentOutput(std::vector<std::string> &out) = 0;
@@ -69,6 +74,14 @@ public:
 
     virtual void stop() = 0;
 
+    /**
+     * @brief generation of the finished list
+     * @param epoch changes whenever finished tasks are removed, or the queue
+     * is created again, so cached task details must be dropped
+     * @param version changes on every change of the finished list
+     */
+    virtual void finishedGeneration(u64 &epoch, u64 &version) const = 0;
+
 protected:
 
     std::shared_ptr<Proc::IProc> m_proc;
@@ -22,6 +22,8 @@
  */
 
 #include <memory>
+#include <random>
+#include <unordered_set>
 #ifdef _WIN32
 #define sleep(x) Sleep(x * 1000)
 #else
@@ -31,9 +33,12 @@
 #include "spdlog/spdlog.h"
 
 #include "model/errmsg.hpp"
+#include "model/sched/estimator.hpp"
+#include "model/sched/scheduler.hpp"
 #include "model/utils.hpp"
 
 #include "queue.hpp"
+#include "queuegroup.hpp"
 
 namespace Model
 {
@@ -50,8 +55,75 @@ static std::mutex dbColumnNameMutex;
 
 static bool isDBColumnNameInit = false;
 
+typedef struct AddedColumn
+{
+    const char *name;
+    const char *type;
+    const char *constraint;
+} AddedColumn;
+
+// columns added after the first release, in table order,
+// older databases get them with the default value when they are opened
+static const AddedColumn addedColumns[] =
+{
+    {"cpus", "INT", "NOT NULL DEFAULT 1"},
+    {"memoryMB", "INT", "NOT NULL DEFAULT 0"},
+    {"priority", "INT", "NOT NULL DEFAULT 0"},
+    {"suspendedMs", "INT", "NOT NULL DEFAULT 0"},
+    {"enqueueTime", "INT", "NOT NULL DEFAULT 0"},
+    {"startTime", "INT", "NOT NULL DEFAULT 0"},
+    {"endTime", "INT", "NOT NULL DEFAULT 0"},
+    {"wallTimeoutSec", "INT", "NOT NULL DEFAULT 0"},
+    {"cpuTimeoutSec", "INT", "NOT NULL DEFAULT 0"},
+    {"isTimedOut", "INT", "NOT NULL DEFAULT 0"},
+    {"cpuUsageUs", "INT", "NOT NULL DEFAULT 0"},
+    {"memoryPeakBytes", "INT", "NOT NULL DEFAULT 0"},
+    {"ioReadBytes", "INT", "NOT NULL DEFAULT 0"},
+    {"ioWriteBytes", "INT", "NOT NULL DEFAULT 0"},
+    {"userTimeUs", "INT", "NOT NULL DEFAULT 0"},
+    {"systemTimeUs", "INT", "NOT NULL DEFAULT 0"},
+    {"maxRssKB", "INT", "NOT NULL DEFAULT 0"},
+    {"majorFaults", "INT", "NOT NULL DEFAULT 0"},
+    {"minorFaults", "INT", "NOT NULL DEFAULT 0"},
+};
+
+// how many pending tasks of the top priority are compared in shortest job first
+static constexpr u32 MAX_SHORTEST_FIRST_SCAN = 1024;
+
+// how many finished tasks feed the estimator when a queue is opened
+static constexpr u32 ESTIMATOR_WARM_UP = 1000;
+
+static std::shared_ptr<Metrics::Histogram> opDuration(const char *op)
+{
+    return Metrics::registry().histogram("ff_sqlite_op_duration",
+        Metrics::label("op", op));
+}
+
+static i64 nowMs()
+{
+    return std::chrono::duration_cast<std::chrono::milliseconds>(
+        std::chrono::system_clock::now().time_since_epoch()).count();
+}
+
+static u64 runMs(const Proc::Task &task)
+{
+    i64 out = task.endTime - task.startTime - static_cast<i64>(task.suspendedMs);
+    return out > 0 ? static_cast<u64>(out) : 0;
+}
+
+// random, so a queue which is created again never repeats an old epoch
+static u64 newEpoch()
+{
+    std::random_device device;
+    return (static_cast<u64>(device()) << 32) ^ device() ^
+        static_cast<u64>(std::chrono::system_clock::now().time_since_epoch().count());
+}
+
 Queue::Queue() :
-    m_token(nullptr)
+    m_token(nullptr),
+    m_currentID(-1),
+    m_finishedEpoch(newEpoch()),
+    m_finishedVersion(0)
 {
     m_proc = nullptr;
 }
@@ -59,6 +131,12 @@ Queue::Queue() :
 Queue::~Queue()
 {
     stopImpl();
+
+    // mainLoop records the stopped task before the members are gone
+    if (m_thread.joinable())
+    {
+        m_thread.join();
+    }
 }
 
 u8
@@ -67,7 +145,7 @@ Queue::init(std::shared_ptr<Connect::SQLite::Token> &token,
             std::shared_ptr<Proc::IProc> &process,
             const std::string &name)
 {
-    spdlog::debug("{}:{} Queue::init", LOG_FILE_PATH(__FILE__), __LINE__);
+    FF_DEBUG("{}:{} Queue::init", LOG_FILE_PATH(__FILE__), __LINE__);
 
     if (!process)
     {
@@ -101,6 +179,11 @@ Queue::init(std::shared_ptr<Connect::SQLite::Token> &token,
             dbColumnName["ID"] = "INT";
             dbColumnName["exitCode"] = "INT";
             dbColumnName["isSuccess"] = "INT";
+            for (auto &column : addedColumns)
+            {
+                dbColumnName[column.name] = column.type;
+            }
+
             isDBColumnNameInit = true;
         }
     }
@@ -112,6 +195,20 @@ Queue::init(std::shared_ptr<Connect::SQLite::Token> &token,
         return ErrCode_OS_ERROR;
     }
 
+    {
+        std::unique_lock<std::mutex> lock(m_token->mutex);
+        m_name = name;
+        bindMetrics(name);
+
+        std::vector<int> pending;
+        if (!listIDInTable("pending", pending))
+        {
+            m_pendingGauge->set(static_cast<i64>(pending.size()));
+        }
+
+        warmEstimator();
+    }
+
     m_proc = process;
     m_isRunning.store(false, std::memory_order_relaxed);
     m_start.store(false, std::memory_order_relaxed);
@@ -121,17 +218,27 @@ Queue::init(std::shared_ptr<Connect::SQLite::Token> &token,
 
 u8 Queue::listPending(std::vector<int> &out)
 {
-    spdlog::debug("{}:{} Queue::listPending", LOG_FILE_PATH(__FILE__), __LINE__);
+    FF_DEBUG("{}:{} Queue::listPending", LOG_FILE_PATH(__FILE__), __LINE__);
 
-    std::unique_lock<std::mutex> lock(m_token->mutex);
-    return listIDInTable("pending", out);
+    std::unique_lock<std::mutex> lock = lockDB();
+    static auto duration = opDuration("listPending");
+    Metrics::ScopedTimer timer(duration);
+    u8 ret = listIDInTable("pending", out);
+    if (!ret)
+    {
+        m_pendingGauge->set(static_cast<i64>(out.size()));
+    }
+
+    return ret;
 }
 
 u8 Queue::listFinished(std::vector<int> &out)
 {
-    spdlog::debug("{}:{} Queue::listFinished", LOG_FILE_PATH(__FILE__), __LINE__);
+    FF_DEBUG("{}:{} Queue::listFinished", LOG_FILE_PATH(__FILE__), __LINE__);
 
-    std::unique_lock<std::mutex> lock(m_token->mutex);
+    std::unique_lock<std::mutex> lock = lockDB();
+    static auto duration = opDuration("listFinished");
+    Metrics::ScopedTimer timer(duration);
     return listIDInTable("done", out);
 }
 
@@ -139,9 +246,11 @@ u8
 Queue::pendingDetails(const int id,
                             Proc::Task &out)
 {
-    spdlog::debug("{}:{} Queue::pendingDetails", LOG_FILE_PATH(__FILE__), __LINE__);
+    FF_DEBUG("{}:{} Queue::pendingDetails", LOG_FILE_PATH(__FILE__), __LINE__);
 
-    std::unique_lock<std::mutex> lock(m_token->mutex);
+    std::unique_lock<std::mutex> lock = lockDB();
+    static auto duration = opDuration("pendingDetails");
+    Metrics::ScopedTimer timer(duration);
     return taskDetails("pending", id, out);
 }
 
@@ -149,32 +258,53 @@ u8
 Queue::finishedDetails(const int id,
                              Proc::Task &out)
 {
-    spdlog::debug("{}:{} Queue::finishedDetails", LOG_FILE_PATH(__FILE__), __LINE__);
+    FF_DEBUG("{}:{} Queue::finishedDetails", LOG_FILE_PATH(__FILE__), __LINE__);
 
-    std::unique_lock<std::mutex> lock(m_token->mutex);
+    std::unique_lock<std::mutex> lock = lockDB();
+    static auto duration = opDuration("finishedDetails");
+    Metrics::ScopedTimer timer(duration);
     return taskDetails("done", id, out);
 }
 
 u8 Queue::clearPending()
 {
-    spdlog::debug("{}:{} Queue::clearPending", LOG_FILE_PATH(__FILE__), __LINE__);
+    FF_DEBUG("{}:{} Queue::clearPending", LOG_FILE_PATH(__FILE__), __LINE__);
 
-    std::unique_lock<std::mutex> lock(m_token->mutex);
+    std::unique_lock<std::mutex> lock = lockDB();
     std::unique_lock<std::mutex> lock2(m_currentTaskMutex);
-    return clearTable("pending");
+    static auto duration = opDuration("clearPending");
+    Metrics::ScopedTimer timer(duration);
+    u8 ret = clearTable("pending");
+    if (!ret)
+    {
+        m_pendingGauge->set(0);
+        m_enqueueTime.clear();
+        m_leases.clear();
+    }
+
+    return ret;
 }
 
 u8 Queue::clearFinished()
 {
-    spdlog::debug("{}:{} Queue::clearFinished", LOG_FILE_PATH(__FILE__), __LINE__);
+    FF_DEBUG("{}:{} Queue::clearFinished", LOG_FILE_PATH(__FILE__), __LINE__);
 
-    std::unique_lock<std::mutex> lock(m_token->mutex);
-    return clearTable("done");
+    std::unique_lock<std::mutex> lock = lockDB();
+    static auto duration = opDuration("clearFinished");
+    Metrics::ScopedTimer timer(duration);
+    u8 ret = clearTable("done");
+    if (!ret)
+    {
+        m_finishedEpoch.store(newEpoch(), std::memory_order_relaxed);
+        m_finishedVersion.fetch_add(1, std::memory_order_release);
+    }
+
+    return ret;
 }
 
 u8 Queue::currentTask(Proc::Task &out)
 {
-    spdlog::debug("{}:{} Queue::currentTask", LOG_FILE_PATH(__FILE__), __LINE__);
+    FF_DEBUG("{}:{} Queue::currentTask", LOG_FILE_PATH(__FILE__), __LINE__);
 
     if (!isRunning())
     {
@@ -189,9 +319,11 @@ u8 Queue::currentTask(Proc::Task &out)
 
 u8 Queue::addTask(Proc::Task &in)
 {
-    spdlog::debug("{}:{} Queue::addTask", LOG_FILE_PATH(__FILE__), __LINE__);
+    FF_DEBUG("{}:{} Queue::addTask", LOG_FILE_PATH(__FILE__), __LINE__);
 
-    std::unique_lock<std::mutex> lock(m_token->mutex);
+    std::unique_lock<std::mutex> lock = lockDB();
+    static auto duration = opDuration("addTask");
+    Metrics::ScopedTimer timer(duration);
     u8 code;
     code = getID(in.ID);
     if (code)
@@ -200,35 +332,108 @@ u8 Queue::addTask(Proc::Task &in)
         return ErrCode_OS_ERROR;
     }
 
-    return addTaskToTable("pending", in);
+    in.enqueueTime = nowMs();
+    code = addTaskToTable("pending", in);
+    if (!code)
+    {
+        m_pendingGauge->add(1);
+        m_enqueueTime[in.ID] = std::chrono::steady_clock::now();
+    }
+
+    return code;
 }
 
 u8 Queue::removeTask(const i32 in)
 {
-    spdlog::debug("{}:{} Queue::removeTask", LOG_FILE_PATH(__FILE__), __LINE__);
+    FF_DEBUG("{}:{} Queue::removeTask", LOG_FILE_PATH(__FILE__), __LINE__);
 
-    std::unique_lock<std::mutex> lock(m_token->mutex);
+    std::unique_lock<std::mutex> lock = lockDB();
+    static auto duration = opDuration("removeTask");
+    Metrics::ScopedTimer timer(duration);
     return removeTaskFromPending(in, true);
 }
 
+u8 Queue::reprioritize(const i32 id, const i32 priority)
+{
+    FF_DEBUG("{}:{} Queue::reprioritize", LOG_FILE_PATH(__FILE__), __LINE__);
+    FF_DEBUG("{}:{} id: {}, priority: {}", LOG_FILE_PATH(__FILE__), __LINE__, id, priority);
+
+    std::unique_lock<std::mutex> lock = lockDB();
+    static auto duration = opDuration("reprioritize");
+    Metrics::ScopedTimer timer(duration);
+
+    u8 ret(ErrCode_OK);
+    if (sqlite3_prepare_v2(m_token->db,
+        "UPDATE pending SET priority=? WHERE ID=?;", 41,
+        &m_token->stmt, NULL))
+    {
+        ret = ErrCode_OS_ERROR;
+        spdlog::error("{}:{} Fail to build prepared statment: {}",
+            LOG_FILE_PATH(__FILE__), __LINE__,
+            sqlite3_errmsg(m_token->db));
+        goto exit;
+    }
+
+    if (sqlite3_bind_int(m_token->stmt, 1, priority) ||
+        sqlite3_bind_int(m_token->stmt, 2, id))
+    {
+        ret = ErrCode_OS_ERROR;
+        spdlog::error("{}:{} Fail to build prepared statment: {}",
+            LOG_FILE_PATH(__FILE__), __LINE__,
+            sqlite3_errmsg(m_token->db));
+        goto exit;
+    }
+
+    if (sqlite3_step(m_token->stmt) != SQLITE_DONE)
+    {
+        ret = ErrCode_OS_ERROR;
+        spdlog::error("{}:{} Fail to execute sql: {}",
+            LOG_FILE_PATH(__FILE__), __LINE__,
+            sqlite3_errmsg(m_token->db));
+        goto exit;
+    }
+
+    if (!sqlite3_changes(m_token->db))
+    {
+        ret = ErrCode_NOT_FOUND;
+        spdlog::error("{}:{} Task {} is not pending",
+            LOG_FILE_PATH(__FILE__), __LINE__, id);
+    }
+
+exit:
+
+    UNUSED(sqlite3_finalize(m_token->stmt));
+    m_token->stmt = nullptr;
+    return ret;
+}
+
 bool Queue::isRunning() const
 {
-    spdlog::debug("{}:{} Queue::isRunning", LOG_FILE_PATH(__FILE__), __LINE__);
+    FF_DEBUG("{}:{} Queue::isRunning", LOG_FILE_PATH(__FILE__), __LINE__);
 
     return m_isRunning.load(std::memory_order_relaxed);
 }
 
 void Queue::readCurrentOutput(std::vector<std::string> &out)
 {
-    spdlog::debug("{}:{} Queue::readCurrentOutput", LOG_FILE_PATH(__FILE__), __LINE__);
+    FF_DEBUG("{}:{} Queue::readCurrentOutput", LOG_FILE_PATH(__FILE__), __LINE__);
 
     out.clear();
     m_proc->readCurrentOutput(out);
+
+    // then the output sent by workers
+    std::unique_lock<std::mutex> lock(m_leaseOutputMutex);
+    out.reserve(out.size() + m_leaseOutput.size());
+    while (!m_leaseOutput.empty())
+    {
+        out.push_back(std::move(m_leaseOutput.front()));
+        m_leaseOutput.pop_front();
+    }
 }
 
 u8 Queue::start()
 {
-    spdlog::debug("{}:{} Queue::start", LOG_FILE_PATH(__FILE__), __LINE__);
+    FF_DEBUG("{}:{} Queue::start", LOG_FILE_PATH(__FILE__), __LINE__);
 
     if (isRunning())
     {
@@ -236,6 +441,12 @@ u8 Queue::start()
         return ErrCode_INVALID_ARGUMENT;
     }
 
+    // the previous loop may still be on its way out
+    if (m_thread.joinable())
+    {
+        m_thread.join();
+    }
+
     m_isRunning.store(true, std::memory_order_relaxed);
     m_start.store(true, std::memory_order_relaxed);
     m_thread = std::jthread(&Queue::mainLoop, this);
@@ -247,22 +458,280 @@ void Queue::stop()
     stopImpl();
 }
 
+void Queue::finishedGeneration(u64 &epoch, u64 &version) const
+{
+    // the epoch is stored before the version is bumped
+    version = m_finishedVersion.load(std::memory_order_acquire);
+    epoch = m_finishedEpoch.load(std::memory_order_relaxed);
+}
+
+u8 Queue::leaseTask(const std::string &worker,
+                    const u32 leaseMs,
+                    Proc::Task &out)
+{
+    FF_DEBUG("{}:{} Queue::leaseTask", LOG_FILE_PATH(__FILE__), __LINE__);
+    FF_DEBUG("{}:{} worker: {}", LOG_FILE_PATH(__FILE__), __LINE__, worker);
+
+    if (!leaseMs)
+    {
+        spdlog::error("{}:{} leaseMs is 0", LOG_FILE_PATH(__FILE__), __LINE__);
+        return ErrCode_INVALID_ARGUMENT;
+    }
+
+    u8 code = leaseTaskImpl(worker, leaseMs, out);
+    if (code == ErrCode_NOT_FOUND && !stealTasks())
+    {
+        code = leaseTaskImpl(worker, leaseMs, out);
+    }
+
+    return code;
+}
+
+u8 Queue::renewLease(const std::string &worker,
+                     const i32 id,
+                     const u32 leaseMs)
+{
+    FF_DEBUG("{}:{} Queue::renewLease", LOG_FILE_PATH(__FILE__), __LINE__);
+
+    std::unique_lock<std::mutex> lock = lockDB();
+    auto it = m_leases.find(id);
+    if (it == m_leases.end() || it->second.worker != worker)
+    {
+        spdlog::warn("{}:{} lease of task {} is lost by {}",
+            LOG_FILE_PATH(__FILE__), __LINE__, id, worker);
+        return ErrCode_NOT_FOUND;
+    }
+
+    it->second.deadline = std::chrono::steady_clock::now() +
+                          std::chrono::milliseconds(leaseMs);
+    return ErrCode_OK;
+}
+
+u8 Queue::appendLeaseOutput(const std::string &worker,
+                            const i32 id,
+                            std::vector<std::string> &output)
+{
+    FF_DEBUG("{}:{} Queue::appendLeaseOutput", LOG_FILE_PATH(__FILE__), __LINE__);
+
+    static auto droppedChunks =
+        Metrics::registry().counter("ff_proc_output_dropped_total");
+
+    std::unique_lock<std::mutex> lock = lockDB();
+    auto it = m_leases.find(id);
+    if (it == m_leases.end() || it->second.worker != worker)
+    {
+        return ErrCode_NOT_FOUND;
+    }
+
+    std::unique_lock<std::mutex> outputLock(m_leaseOutputMutex);
+    for (auto msg = output.begin(); msg != output.end(); ++msg)
+    {
+        if (m_leaseOutput.size() >= FF_MAX_READ_QUEUE_SIZE)
+        {
+            m_leaseOutput.pop_front();
+            droppedChunks->add();
+        }
+
+        m_leaseOutput.push_back(std::move(*msg));
+    }
+
+    return ErrCode_OK;
+}
+
+u8 Queue::finishLease(const std::string &worker,
+                      const i32 id,
+                      const i32 exitCode,
+                      const bool isTimedOut,
+                      const bool isFailed)
+{
+    FF_DEBUG("{}:{} Queue::finishLease", LOG_FILE_PATH(__FILE__), __LINE__);
+    FF_DEBUG("{}:{} worker: {}, id: {}, exitCode: {}, isTimedOut: {}, isFailed: {}",
+        LOG_FILE_PATH(__FILE__), __LINE__, worker, id, exitCode, isTimedOut, isFailed);
+
+    std::unique_lock<std::mutex> lock = lockDB();
+    static auto duration = opDuration("finishLease");
+    Metrics::ScopedTimer timer(duration);
+    auto it = m_leases.find(id);
+    if (it == m_leases.end() || it->second.worker != worker)
+    {
+        spdlog::warn("{}:{} result of task {} from {} is dropped, the lease is lost",
+            LOG_FILE_PATH(__FILE__), __LINE__, id, worker);
+        return ErrCode_NOT_FOUND;
+    }
+
+    auto start = it->second.start;
+    m_leases.erase(it);
+
+    Proc::Task task;
+    u8 code = taskDetails("pending", id, task);
+    if (code)
+    {
+        return code;
+    }
+
+    task.exitCode = exitCode;
+    task.isTimedOut = isTimedOut;
+    task.endTime = nowMs();
+    task.startTime = task.endTime - static_cast<i64>(Metrics::elapsedUs(start) / 1000);
+
+    // only a run which ended on its own tells how long the task takes
+    if (!isTimedOut && !isFailed)
+    {
+        Sched::estimator().record(task, runMs(task));
+    }
+
+    code = removeTaskFromPending(id, false);
+    if (code)
+    {
+        spdlog::error("{}:{} Fail to remove task from pending",
+            LOG_FILE_PATH(__FILE__), __LINE__);
+        return code;
+    }
+
+    if (addTaskToTable("done", task))
+    {
+        spdlog::error("{}:{} Fail to add task to done list",
+            LOG_FILE_PATH(__FILE__), __LINE__);
+        return ErrCode_OS_ERROR;
+    }
+
+    m_runHistogram->record(Metrics::elapsedUs(start));
+    m_finishedVersion.fetch_add(1, std::memory_order_release);
+    return ErrCode_OK;
+}
+
+void Queue::releaseLeases(const std::string &worker)
+{
+    FF_DEBUG("{}:{} Queue::releaseLeases", LOG_FILE_PATH(__FILE__), __LINE__);
+    FF_DEBUG("{}:{} worker: {}", LOG_FILE_PATH(__FILE__), __LINE__, worker);
+
+    std::unique_lock<std::mutex> lock = lockDB();
+    std::erase_if(m_leases, [&worker](const auto &lease)
+    {
+        return lease.second.worker == worker;
+    });
+}
+
 u8 Queue::rename(const std::string &newName, const std::string &oldName)
 {
-    spdlog::debug("{}:{} Queue::rename", LOG_FILE_PATH(__FILE__), __LINE__);
+    FF_DEBUG("{}:{} Queue::rename", LOG_FILE_PATH(__FILE__), __LINE__);
 
     std::string newPath = m_targetPath + "/" + newName + ".db";
     std::string oldPath = m_targetPath + "/" + oldName + ".db";
 
-    return connectToDB(newPath, oldPath);
+    if (connectToDB(newPath, oldPath))
+    {
+        return 1;
+    }
+
+    std::unique_lock<std::mutex> lock(m_token->mutex);
+    m_name = newName;
+    bindMetrics(newName);
+    Metrics::registry().remove(Metrics::label("queue", oldName));
+    return 0;
+}
+
+u8 Queue::stealFrom(Queue &victim, const u32 maxCount, u32 &out)
+{
+    FF_DEBUG("{}:{} Queue::stealFrom", LOG_FILE_PATH(__FILE__), __LINE__);
+    FF_DEBUG("{}:{} maxCount: {}", LOG_FILE_PATH(__FILE__), __LINE__, maxCount);
+
+    static auto stolen = Metrics::registry().counter("ff_tasks_stolen_total");
+
+    out = 0;
+    if (&victim == this || !maxCount)
+    {
+        spdlog::error("{}:{} Invalid input", LOG_FILE_PATH(__FILE__), __LINE__);
+        return ErrCode_INVALID_ARGUMENT;
+    }
+
+    // both connections are idle while the victim's database is attached
+    std::scoped_lock lock(m_token->mutex, victim.m_token->mutex);
+    static auto duration = opDuration("stealTasks");
+    Metrics::ScopedTimer timer(duration);
+
+    std::vector<int> ids;
+    if (victim.listIDInTable("pending", ids))
+    {
+        return ErrCode_OS_ERROR;
+    }
+
+    // take the tail of the dispatch order,
+    // the victim keeps the tasks it would run next
+    i32 currentID = victim.m_currentID.load(std::memory_order_relaxed);
+    std::vector<Proc::Task> tasks;
+    std::vector<i32> oldIDs;
+    for (auto it = ids.rbegin(); it != ids.rend() && tasks.size() < maxCount; ++it)
+    {
+        if (*it == currentID || victim.m_leases.find(*it) != victim.m_leases.end())
+        {
+            continue;
+        }
+
+        Proc::Task task;
+        if (victim.taskDetails("pending", *it, task))
+        {
+            return ErrCode_OS_ERROR;
+        }
+
+        tasks.push_back(task);
+        oldIDs.push_back(*it);
+    }
+
+    if (tasks.empty())
+    {
+        return ErrCode_OK;
+    }
+
+    u8 ret = moveTasks(victim.m_dbPath, tasks);
+    if (ret)
+    {
+        return ret;
+    }
+
+    // tasks keep their enqueue time, so the wait histogram stays honest
+    auto now = std::chrono::steady_clock::now();
+    for (size_t i = 0; i < tasks.size(); ++i)
+    {
+        auto it = victim.m_enqueueTime.find(oldIDs[i]);
+        if (it != victim.m_enqueueTime.end())
+        {
+            m_enqueueTime[tasks[i].ID] = it->second;
+            victim.m_enqueueTime.erase(it);
+        }
+        else
+        {
+            m_enqueueTime[tasks[i].ID] = now;
+        }
+    }
+
+    out = static_cast<u32>(tasks.size());
+    m_pendingGauge->add(out);
+    victim.m_pendingGauge->add(-static_cast<i64>(out));
+    stolen->add(out);
+    spdlog::info("{}:{} {} stole {} tasks from {}",
+        LOG_FILE_PATH(__FILE__), __LINE__, m_name, out, victim.m_name);
+    return ErrCode_OK;
+}
+
+i64 Queue::pendingCount()
+{
+    std::unique_lock<std::mutex> lock(m_token->mutex);
+    return m_pendingGauge->value();
+}
+
+void Queue::setGroup(const std::shared_ptr<QueueGroup> &group)
+{
+    std::unique_lock<std::mutex> lock(m_groupMutex);
+    m_group = group;
 }
 
 // private member functions
 u8 Queue::connectToDB(const std::string &path, const std::string &oldPath)
 {
-    spdlog::debug("{}:{} Queue::connectToDB", LOG_FILE_PATH(__FILE__), __LINE__);
-    spdlog::debug("{}:{} path: {}", LOG_FILE_PATH(__FILE__), __LINE__, path.c_str());
-    spdlog::debug("{}:{} oldPath: {}", LOG_FILE_PATH(__FILE__), __LINE__, oldPath.c_str());
+    FF_DEBUG("{}:{} Queue::connectToDB", LOG_FILE_PATH(__FILE__), __LINE__);
+    FF_DEBUG("{}:{} path: {}", LOG_FILE_PATH(__FILE__), __LINE__, path.c_str());
+    FF_DEBUG("{}:{} oldPath: {}", LOG_FILE_PATH(__FILE__), __LINE__, oldPath.c_str());
 
     std::unique_lock<std::mutex> lock(m_token->mutex);
     if (!oldPath.empty())
@@ -297,6 +766,7 @@ u8 Queue::connectToDB(const std::string &path, const std::string &oldPath)
         return 1;
     }
 
+    m_dbPath = path;
     rcPending = verifyTable("pending");
     if (rcPending == 1)
     {
@@ -306,6 +776,16 @@ u8 Queue::connectToDB(const std::string &path, const std::string &oldPath)
         return 1;
     }
 
+    // dispatch order, nextTask walks it instead of sorting the table
+    if (execSQL("CREATE INDEX IF NOT EXISTS pendingPriority "
+                "ON pending (priority DESC, ID);"))
+    {
+        spdlog::error("{}:{} Fail to create index of pending", LOG_FILE_PATH(__FILE__), __LINE__);
+        UNUSED(sqlite3_close(m_token->db));
+        m_token->db = nullptr;
+        return 1;
+    }
+
     rcDone = verifyTable("done");
     if (rcPending == 1)
     {
@@ -341,8 +821,8 @@ u8 Queue::connectToDB(const std::string &path, const std::string &oldPath)
 
 u8 Queue::createTable(const std::string &name)
 {
-    spdlog::debug("{}:{} Queue::createTable", LOG_FILE_PATH(__FILE__), __LINE__);
-    spdlog::debug("{}:{} name: {}", LOG_FILE_PATH(__FILE__), __LINE__, name.c_str());
+    FF_DEBUG("{}:{} Queue::createTable", LOG_FILE_PATH(__FILE__), __LINE__);
+    FF_DEBUG("{}:{} name: {}", LOG_FILE_PATH(__FILE__), __LINE__, name.c_str());
 
     u8 ret(2);
     std::string sql = "create table ";
@@ -353,8 +833,13 @@ u8 Queue::createTable(const std::string &name)
         "workDir text NOT NULL, "
         "ID INT NOT NULL PRIMARY KEY, "
         "exitCode INT NOT NULL, "
-        "isSuccess INT NOT NULL"
-        ");";
+        "isSuccess INT NOT NULL";
+    for (auto &column : addedColumns)
+    {
+        sql += fmt::format(", {} {} {}", column.name, column.type, column.constraint);
+    }
+
+    sql += ");";
 
     if (sqlite3_prepare_v2(m_token->db,
         sql.c_str(),
@@ -383,14 +868,15 @@ exit:
 
 u8 Queue::verifyTable(const std::string &name)
 {
-    spdlog::debug("{}:{} Queue::verifyTable", LOG_FILE_PATH(__FILE__), __LINE__);
-    spdlog::debug("{}:{} name: {}", LOG_FILE_PATH(__FILE__), __LINE__, name.c_str());
+    FF_DEBUG("{}:{} Queue::verifyTable", LOG_FILE_PATH(__FILE__), __LINE__);
+    FF_DEBUG("{}:{} name: {}", LOG_FILE_PATH(__FILE__), __LINE__, name.c_str());
 
     u8 ret(0);
     i32 rowCount(0);
     i32 rc(0);
     std::string colName, colType;
     std::string sql;
+    std::unordered_set<std::string> columns;
     if (sqlite3_prepare_v2(m_token->db,
         "SELECT name FROM sqlite_master WHERE type='table' AND name=?;", 61,
         &m_token->stmt, NULL))
@@ -481,7 +967,7 @@ u8 Queue::verifyTable(const std::string &name)
                 goto exit;
             }
 
-            ++rowCount;
+            columns.insert(colName);
         }
         else if (rc == SQLITE_DONE)
         {
@@ -497,7 +983,31 @@ u8 Queue::verifyTable(const std::string &name)
         }
     }
 
-    if (rowCount != 6)
+    UNUSED(sqlite3_finalize(m_token->stmt));
+    m_token->stmt = nullptr;
+
+    // migrate the tables of older versions
+    for (auto &column : addedColumns)
+    {
+        if (columns.find(column.name) != columns.end())
+        {
+            continue;
+        }
+
+        spdlog::info("{}:{} add column {} to table {}",
+            LOG_FILE_PATH(__FILE__), __LINE__, column.name, name);
+        sql = fmt::format("ALTER TABLE \"{}\" ADD COLUMN {} {} {};",
+            name, column.name, column.type, column.constraint);
+        if (execSQL(sql.c_str()))
+        {
+            ret = 1;
+            goto exit;
+        }
+
+        columns.insert(column.name);
+    }
+
+    if (columns.size() != dbColumnName.size())
     {
         spdlog::error("{}:{} Invalid table", LOG_FILE_PATH(__FILE__), __LINE__);
         ret = 1;
@@ -512,7 +1022,7 @@ exit:
 
 u8 Queue::verifyID()
 {
-    spdlog::debug("{}:{} Queue::verifyID", LOG_FILE_PATH(__FILE__), __LINE__);
+    FF_DEBUG("{}:{} Queue::verifyID", LOG_FILE_PATH(__FILE__), __LINE__);
 
     u8 ret(0);
     i32 rowCount(0);
@@ -725,8 +1235,8 @@ exit:
 
 u8 Queue::clearTable(const std::string &name)
 {
-    spdlog::debug("{}:{} Queue::clearTable", LOG_FILE_PATH(__FILE__), __LINE__);
-    spdlog::debug("{}:{} name: {}", LOG_FILE_PATH(__FILE__), __LINE__, name.c_str());
+    FF_DEBUG("{}:{} Queue::clearTable", LOG_FILE_PATH(__FILE__), __LINE__);
+    FF_DEBUG("{}:{} name: {}", LOG_FILE_PATH(__FILE__), __LINE__, name.c_str());
 
     std::string sql = "";
     u8 ret(ErrCode_OK);
@@ -762,15 +1272,17 @@ exit:
 u8 Queue::listIDInTable(const std::string &name,
                               std::vector<int> &out)
 {
-    spdlog::debug("{}:{} Queue::listIDInTable", LOG_FILE_PATH(__FILE__), __LINE__);
-    spdlog::debug("{}:{} name: {}", LOG_FILE_PATH(__FILE__), __LINE__, name.c_str());
+    FF_DEBUG("{}:{} Queue::listIDInTable", LOG_FILE_PATH(__FILE__), __LINE__);
+    FF_DEBUG("{}:{} name: {}", LOG_FILE_PATH(__FILE__), __LINE__, name.c_str());
 
     out.clear();
     out.reserve(128);
 
     i32 rc(0);
     u8 ret(ErrCode_OK);
-    std::string sql = "SELECT ID FROM " + name + ";";
+    // pending is listed in dispatch order
+    std::string sql = "SELECT ID FROM " + name +
+        (name == "pending" ? " ORDER BY priority DESC, ID;" : ";");
 
     if (sqlite3_prepare_v2(m_token->db,
         sql.c_str(), sql.length(),
@@ -816,8 +1328,8 @@ u8 Queue::taskDetails(const std::string &name,
                             const i32 id,
                             Proc::Task &out)
 {
-    spdlog::debug("{}:{} Queue::taskDetails", LOG_FILE_PATH(__FILE__), __LINE__);
-    spdlog::debug("{}:{} name: {}, id: {}", LOG_FILE_PATH(__FILE__), __LINE__,
+    FF_DEBUG("{}:{} Queue::taskDetails", LOG_FILE_PATH(__FILE__), __LINE__);
+    FF_DEBUG("{}:{} name: {}, id: {}", LOG_FILE_PATH(__FILE__), __LINE__,
         name, id);
 
     i32 rc(0);
@@ -851,16 +1363,7 @@ u8 Queue::taskDetails(const std::string &name,
 
         if (rc == SQLITE_ROW)
         {
-            out.execName = reinterpret_cast<const char *>(
-                sqlite3_column_text(m_token->stmt, 0));
-            splitString(reinterpret_cast<const char *>
-                (sqlite3_column_text(m_token->stmt, 1)), out.args);
-            out.workDir = reinterpret_cast<const char *>
-            (sqlite3_column_text(m_token->stmt, 2));
-            out.ID = sqlite3_column_int(m_token->stmt, 3);
-            out.exitCode = sqlite3_column_int(m_token->stmt, 4);
-            out.isSuccess = sqlite3_column_int(m_token->stmt, 5);
-
+            readTask(out);
             ++rowCount;
         }
         else if (rc == SQLITE_DONE)
@@ -894,12 +1397,12 @@ exit:
 u8 Queue::addTaskToTable(const std::string &name,
                                const Proc::Task &in)
 {
-    spdlog::debug("{}:{} Queue::addTaskToTable", LOG_FILE_PATH(__FILE__), __LINE__);
-    spdlog::debug("{}:{} name: {}", LOG_FILE_PATH(__FILE__), __LINE__, name);
+    FF_DEBUG("{}:{} Queue::addTaskToTable", LOG_FILE_PATH(__FILE__), __LINE__);
+    FF_DEBUG("{}:{} name: {}", LOG_FILE_PATH(__FILE__), __LINE__, name);
 
     std::string args = "";
     std::string sql = "insert into " + name + " ";
-    sql += "values(?,?,?,?,?,?);";
+    sql += "values(?,?,?,?,?,?,?,?,?,?,?,?,?,?,?,?,?,?,?,?,?,?,?,?,?);";
     u8 ret(ErrCode_OK);
 
     if (sqlite3_prepare_v2(m_token->db,
@@ -968,16 +1471,187 @@ u8 Queue::addTaskToTable(const std::string &name,
         goto exit;
     }
 
-    if (sqlite3_step(m_token->stmt) != SQLITE_DONE)
+    if (sqlite3_bind_int(m_token->stmt, 7, static_cast<i32>(in.cpus)))
     {
         ret = ErrCode_OS_ERROR;
-        spdlog::error("{}:{} Fail to insert task to table {}",
+        spdlog::error("{}:{} Fail to build prepared statment: {}",
             LOG_FILE_PATH(__FILE__), __LINE__,
-            name);
+            sqlite3_errmsg(m_token->db));
+        goto exit;
     }
 
-exit:
-
+    if (sqlite3_bind_int64(m_token->stmt, 8, static_cast<sqlite3_int64>(in.memoryMB)))
+    {
+        ret = ErrCode_OS_ERROR;
+        spdlog::error("{}:{} Fail to build prepared statment: {}",
+            LOG_FILE_PATH(__FILE__), __LINE__,
+            sqlite3_errmsg(m_token->db));
+        goto exit;
+    }
+
+    if (sqlite3_bind_int(m_token->stmt, 9, in.priority))
+    {
+        ret = ErrCode_OS_ERROR;
+        spdlog::error("{}:{} Fail to build prepared statment: {}",
+            LOG_FILE_PATH(__FILE__), __LINE__,
+            sqlite3_errmsg(m_token->db));
+        goto exit;
+    }
+
+    if (sqlite3_bind_int64(m_token->stmt, 10, static_cast<sqlite3_int64>(in.suspendedMs)))
+    {
+        ret = ErrCode_OS_ERROR;
+        spdlog::error("{}:{} Fail to build prepared statment: {}",
+            LOG_FILE_PATH(__FILE__), __LINE__,
+            sqlite3_errmsg(m_token->db));
+        goto exit;
+    }
+
+    if (sqlite3_bind_int64(m_token->stmt, 11, static_cast<sqlite3_int64>(in.enqueueTime)))
+    {
+        ret = ErrCode_OS_ERROR;
+        spdlog::error("{}:{} Fail to build prepared statment: {}",
+            LOG_FILE_PATH(__FILE__), __LINE__,
+            sqlite3_errmsg(m_token->db));
+        goto exit;
+    }
+
+    if (sqlite3_bind_int64(m_token->stmt, 12, static_cast<sqlite3_int64>(in.startTime)))
+    {
+        ret = ErrCode_OS_ERROR;
+        spdlog::error("{}:{} Fail to build prepared statment: {}",
+            LOG_FILE_PATH(__FILE__), __LINE__,
+            sqlite3_errmsg(m_token->db));
+        goto exit;
+    }
+
+    if (sqlite3_bind_int64(m_token->stmt, 13, static_cast<sqlite3_int64>(in.endTime)))
+    {
+        ret = ErrCode_OS_ERROR;
+        spdlog::error("{}:{} Fail to build prepared statment: {}",
+            LOG_FILE_PATH(__FILE__), __LINE__,
+            sqlite3_errmsg(m_token->db));
+        goto exit;
+    }
+
+    if (sqlite3_bind_int(m_token->stmt, 14, static_cast<i32>(in.wallTimeoutSec)))
+    {
+        ret = ErrCode_OS_ERROR;
+        spdlog::error("{}:{} Fail to build prepared statment: {}",
+            LOG_FILE_PATH(__FILE__), __LINE__,
+            sqlite3_errmsg(m_token->db));
+        goto exit;
+    }
+
+    if (sqlite3_bind_int(m_token->stmt, 15, static_cast<i32>(in.cpuTimeoutSec)))
+    {
+        ret = ErrCode_OS_ERROR;
+        spdlog::error("{}:{} Fail to build prepared statment: {}",
+            LOG_FILE_PATH(__FILE__), __LINE__,
+            sqlite3_errmsg(m_token->db));
+        goto exit;
+    }
+
+    if (sqlite3_bind_int(m_token->stmt, 16, in.isTimedOut))
+    {
+        ret = ErrCode_OS_ERROR;
+        spdlog::error("{}:{} Fail to build prepared statment: {}",
+            LOG_FILE_PATH(__FILE__), __LINE__,
+            sqlite3_errmsg(m_token->db));
+        goto exit;
+    }
+
+    if (sqlite3_bind_int64(m_token->stmt, 17, static_cast<sqlite3_int64>(in.cpuUsageUs)))
+    {
+        ret = ErrCode_OS_ERROR;
+        spdlog::error("{}:{} Fail to build prepared statment: {}",
+            LOG_FILE_PATH(__FILE__), __LINE__,
+            sqlite3_errmsg(m_token->db));
+        goto exit;
+    }
+
+    if (sqlite3_bind_int64(m_token->stmt, 18, static_cast<sqlite3_int64>(in.memoryPeakBytes)))
+    {
+        ret = ErrCode_OS_ERROR;
+        spdlog::error("{}:{} Fail to build prepared statment: {}",
+            LOG_FILE_PATH(__FILE__), __LINE__,
+            sqlite3_errmsg(m_token->db));
+        goto exit;
+    }
+
+    if (sqlite3_bind_int64(m_token->stmt, 19, static_cast<sqlite3_int64>(in.ioReadBytes)))
+    {
+        ret = ErrCode_OS_ERROR;
+        spdlog::error("{}:{} Fail to build prepared statment: {}",
+            LOG_FILE_PATH(__FILE__), __LINE__,
+            sqlite3_errmsg(m_token->db));
+        goto exit;
+    }
+
+    if (sqlite3_bind_int64(m_token->stmt, 20, static_cast<sqlite3_int64>(in.ioWriteBytes)))
+    {
+        ret = ErrCode_OS_ERROR;
+        spdlog::error("{}:{} Fail to build prepared statment: {}",
+            LOG_FILE_PATH(__FILE__), __LINE__,
+            sqlite3_errmsg(m_token->db));
+        goto exit;
+    }
+
+    if (sqlite3_bind_int64(m_token->stmt, 21, static_cast<sqlite3_int64>(in.userTimeUs)))
+    {
+        ret = ErrCode_OS_ERROR;
+        spdlog::error("{}:{} Fail to build prepared statment: {}",
+            LOG_FILE_PATH(__FILE__), __LINE__,
+            sqlite3_errmsg(m_token->db));
+        goto exit;
+    }
+
+    if (sqlite3_bind_int64(m_token->stmt, 22, static_cast<sqlite3_int64>(in.systemTimeUs)))
+    {
+        ret = ErrCode_OS_ERROR;
+        spdlog::error("{}:{} Fail to build prepared statment: {}",
+            LOG_FILE_PATH(__FILE__), __LINE__,
+            sqlite3_errmsg(m_token->db));
+        goto exit;
+    }
+
+    if (sqlite3_bind_int64(m_token->stmt, 23, static_cast<sqlite3_int64>(in.maxRssKB)))
+    {
+        ret = ErrCode_OS_ERROR;
+        spdlog::error("{}:{} Fail to build prepared statment: {}",
+            LOG_FILE_PATH(__FILE__), __LINE__,
+            sqlite3_errmsg(m_token->db));
+        goto exit;
+    }
+
+    if (sqlite3_bind_int64(m_token->stmt, 24, static_cast<sqlite3_int64>(in.majorFaults)))
+    {
+        ret = ErrCode_OS_ERROR;
+        spdlog::error("{}:{} Fail to build prepared statment: {}",
+            LOG_FILE_PATH(__FILE__), __LINE__,
+            sqlite3_errmsg(m_token->db));
+        goto exit;
+    }
+
+    if (sqlite3_bind_int64(m_token->stmt, 25, static_cast<sqlite3_int64>(in.minorFaults)))
+    {
+        ret = ErrCode_OS_ERROR;
+        spdlog::error("{}:{} Fail to build prepared statment: {}",
+            LOG_FILE_PATH(__FILE__), __LINE__,
+            sqlite3_errmsg(m_token->db));
+        goto exit;
+    }
+
+    if (sqlite3_step(m_token->stmt) != SQLITE_DONE)
+    {
+        ret = ErrCode_OS_ERROR;
+        spdlog::error("{}:{} Fail to insert task to table {}",
+            LOG_FILE_PATH(__FILE__), __LINE__,
+            name);
+    }
+
+exit:
+
     UNUSED(sqlite3_finalize(m_token->stmt));
     m_token->stmt = nullptr;
     return ret;
@@ -986,10 +1660,10 @@ exit:
 u8 Queue::removeTaskFromPending(const i32 id,
                                       const bool needCheckCurrentTask)
 {
-    spdlog::debug("{}:{} Queue::removeTaskFromPending",
+    FF_DEBUG("{}:{} Queue::removeTaskFromPending",
         LOG_FILE_PATH(__FILE__), __LINE__);
-    spdlog::debug("{}:{} id: {}", LOG_FILE_PATH(__FILE__), __LINE__, id);
-    spdlog::debug("{}:{} needCheckCurrentTask: {}", LOG_FILE_PATH(__FILE__), __LINE__,
+    FF_DEBUG("{}:{} id: {}", LOG_FILE_PATH(__FILE__), __LINE__, id);
+    FF_DEBUG("{}:{} needCheckCurrentTask: {}", LOG_FILE_PATH(__FILE__), __LINE__,
         needCheckCurrentTask);
 
     u8 ret(ErrCode_OK);
@@ -1002,6 +1676,13 @@ u8 Queue::removeTaskFromPending(const i32 id,
                 LOG_FILE_PATH(__FILE__), __LINE__);
             return ErrCode_INVALID_ARGUMENT;
         }
+
+        if (m_leases.find(id) != m_leases.end())
+        {
+            spdlog::error("{}:{} Cannot remove leased task",
+                LOG_FILE_PATH(__FILE__), __LINE__);
+            return ErrCode_INVALID_ARGUMENT;
+        }
     }
 
     if (sqlite3_prepare_v2(m_token->db,
@@ -1028,8 +1709,12 @@ u8 Queue::removeTaskFromPending(const i32 id,
     {
         ret = ErrCode_NOT_FOUND;
         spdlog::error("{}:{} Fail to remove task", LOG_FILE_PATH(__FILE__), __LINE__);
+        goto exit;
     }
 
+    m_pendingGauge->add(-sqlite3_changes(m_token->db));
+    m_enqueueTime.erase(id);
+
 exit:
 
     UNUSED(sqlite3_finalize(m_token->stmt));
@@ -1039,8 +1724,8 @@ exit:
 
 void Queue::splitString(const std::string &in, std::vector<std::string> &out)
 {
-    spdlog::debug("{}:{} Queue::splitString", LOG_FILE_PATH(__FILE__), __LINE__);
-    spdlog::debug("{}:{} in: {}", LOG_FILE_PATH(__FILE__), __LINE__, in.c_str());
+    FF_DEBUG("{}:{} Queue::splitString", LOG_FILE_PATH(__FILE__), __LINE__);
+    FF_DEBUG("{}:{} in: {}", LOG_FILE_PATH(__FILE__), __LINE__, in.c_str());
 
     std::string s = in;
     std::string delimiter = "__,__";
@@ -1060,7 +1745,7 @@ void Queue::splitString(const std::string &in, std::vector<std::string> &out)
 
 std::string Queue::concatString(const std::vector<std::string> &in)
 {
-    spdlog::debug("{}:{} Queue::concatString", LOG_FILE_PATH(__FILE__), __LINE__);
+    FF_DEBUG("{}:{} Queue::concatString", LOG_FILE_PATH(__FILE__), __LINE__);
 
     std::string out = "";
     size_t last(0);
@@ -1082,7 +1767,7 @@ exit:
 
 u8 Queue::getID(i32 &out)
 {
-    spdlog::debug("{}:{} Queue::getID", LOG_FILE_PATH(__FILE__), __LINE__);
+    FF_DEBUG("{}:{} Queue::getID", LOG_FILE_PATH(__FILE__), __LINE__);
 
     i32 rc(0);
     i32 rowCount(0);
@@ -1178,7 +1863,7 @@ exit:
 
 void Queue::mainLoop()
 {
-    spdlog::debug("{}:{} Queue::mainLoop", LOG_FILE_PATH(__FILE__), __LINE__);
+    FF_DEBUG("{}:{} Queue::mainLoop", LOG_FILE_PATH(__FILE__), __LINE__);
 
     while (m_start.load(std::memory_order_relaxed))
     {
@@ -1187,20 +1872,68 @@ void Queue::mainLoop()
             continue;
         }
 
+        // wait for the budget, the task stays pending meanwhile
+        std::string name;
+        {
+            std::unique_lock<std::mutex> lock = lockDB();
+            name = m_name;
+        }
+
+        Sched::Scheduler::Grant grant;
+        if (Sched::scheduler().acquire(name, m_currentTask, m_start, grant))
+        {
+            mainLoopAbort();
+            continue;
+        }
+
+        // the run time does not include the wait for the budget
+        m_taskStartTime = std::chrono::steady_clock::now();
+        {
+            std::unique_lock<std::mutex> lock(m_currentTaskMutex);
+            m_currentTask.startTime = nowMs();
+            m_currentTask.queue = name;
+        }
+
         // invoke process
         if (m_proc->start(m_currentTask))
         {
             spdlog::error("{}:{} Fail to start process.", LOG_FILE_PATH(__FILE__), __LINE__);
+            Sched::scheduler().release(grant);
+            {
+                std::unique_lock<std::mutex> lock(m_currentTaskMutex);
+                m_currentTask.endTime = nowMs();
+            }
+
             mainLoopFin();
             m_start.store(false, std::memory_order_relaxed);
             continue;
         }
 
+        // a task of higher priority may suspend it from now on
+        Sched::scheduler().bind(grant, m_proc);
         while(m_proc->isRunning())
         {
             sleep(1);
         }
 
+        // stopImpl clears m_start before it stops the process
+        bool isStopped = !m_start.load(std::memory_order_relaxed);
+
+        u64 suspendedMs = Sched::scheduler().release(grant);
+        {
+            std::unique_lock<std::mutex> lock(m_currentTaskMutex);
+            m_currentTask.suspendedMs = suspendedMs;
+            m_currentTask.endTime = nowMs();
+            m_currentTask.isTimedOut = m_proc->isTimedOut();
+            m_proc->usage(m_currentTask);
+        }
+
+        // only a run which ended on its own tells how long the task takes
+        if (!m_currentTask.isTimedOut && !isStopped)
+        {
+            Sched::estimator().record(m_currentTask, runMs(m_currentTask));
+        }
+
         mainLoopFin();
     } // end while (m_start.load(std::memory_order_relaxed))
 
@@ -1209,84 +1942,76 @@ void Queue::mainLoop()
 
 u8 Queue::mainLoopInit()
 {
-    spdlog::debug("{}:{} Queue::mainLoopInit", LOG_FILE_PATH(__FILE__), __LINE__);
-
-    // find the task in pending list
-    std::unique_lock<std::mutex> lock(m_token->mutex);
-    u8 ret(0);
+    FF_DEBUG("{}:{} Queue::mainLoopInit", LOG_FILE_PATH(__FILE__), __LINE__);
 
-    if (sqlite3_prepare_v2(m_token->db,
-        "SELECT * FROM pending limit 1;", 30,
-        &m_token->stmt, NULL))
+    u8 code = takeTask();
+    if (code == ErrCode_NOT_FOUND && !stealTasks())
     {
-        spdlog::error("{}:{} Fail to build prepared statment: {}",
-            LOG_FILE_PATH(__FILE__), __LINE__,
-            sqlite3_errmsg(m_token->db));
-        ret = 1;
-        goto exit;
+        code = takeTask();
     }
 
-    switch (sqlite3_step(m_token->stmt))
+    switch (code)
     {
-    case SQLITE_ROW:
+    case ErrCode_OK:
     {
-        std::unique_lock<std::mutex> lock(m_currentTaskMutex);
-        m_currentTask.execName = reinterpret_cast<const char *>
-            (sqlite3_column_text(m_token->stmt, 0));
-        splitString(reinterpret_cast<const char *>
-            (sqlite3_column_text(m_token->stmt, 1)), m_currentTask.args);
-        m_currentTask.workDir = reinterpret_cast<const char *>
-            (sqlite3_column_text(m_token->stmt, 2));
-        m_currentTask.ID = sqlite3_column_int(m_token->stmt, 3);
-        m_currentTask.exitCode = sqlite3_column_int(m_token->stmt, 4);
-        m_currentTask.isSuccess = sqlite3_column_int(m_token->stmt, 5);
-        break;
+        return 0;
     }
-    case SQLITE_DONE:
+    case ErrCode_NOT_FOUND:
     {
         spdlog::error("{}:{} Pending list is empty",
             LOG_FILE_PATH(__FILE__), __LINE__);
-        m_start.store(false, std::memory_order_relaxed);
-        m_isRunning.store(false, std::memory_order_relaxed);
-        ret = 1;
         break;
     }
     default:
     {
-        // other error
-        spdlog::error("{}:{} Fail to execute sql: {}",
-            LOG_FILE_PATH(__FILE__), __LINE__,
-            sqlite3_errmsg(m_token->db));
-        m_start.store(false, std::memory_order_relaxed);
-        m_isRunning.store(false, std::memory_order_relaxed);
-        ret = 1;
+        spdlog::error("{}:{} Fail to get next task",
+            LOG_FILE_PATH(__FILE__), __LINE__);
         break;
     }
     }
 
-exit:
+    m_start.store(false, std::memory_order_relaxed);
+    m_isRunning.store(false, std::memory_order_relaxed);
+    return 1;
+}
 
-    UNUSED(sqlite3_finalize(m_token->stmt));
-    m_token->stmt = nullptr;
-    return ret;
+void Queue::mainLoopAbort()
+{
+    FF_DEBUG("{}:{} Queue::mainLoopAbort", LOG_FILE_PATH(__FILE__), __LINE__);
+
+    // same order as takeTask
+    std::unique_lock<std::mutex> dbLock = lockDB();
+    std::unique_lock<std::mutex> lock(m_currentTaskMutex);
+    m_currentID.store(-1, std::memory_order_relaxed);
+    m_currentTask = Proc::Task();
 }
 
 void Queue::mainLoopFin()
 {
-    spdlog::debug("{}:{} Queue::mainLoopFin", LOG_FILE_PATH(__FILE__), __LINE__);
+    FF_DEBUG("{}:{} Queue::mainLoopFin", LOG_FILE_PATH(__FILE__), __LINE__);
 
     std::unique_lock<std::mutex> lock(m_currentTaskMutex);
     if (m_proc->exitCode(m_currentTask.exitCode))
     {
         spdlog::error("{}:{} Fail to get exit code.",
             LOG_FILE_PATH(__FILE__), __LINE__);
+        m_currentID.store(-1, std::memory_order_relaxed);
         m_start.store(false, std::memory_order_relaxed);
         m_currentTask = Proc::Task();
         return;
     }
 
     // write task details to done list
-    std::unique_lock<std::mutex> dbLock(m_token->mutex);
+    std::unique_lock<std::mutex> dbLock = lockDB();
+
+    // not before the lock, or the task could be leased or stolen
+    // while it is still in the pending list
+    m_currentID.store(-1, std::memory_order_relaxed);
+    static auto duration = opDuration("finishTask");
+    Metrics::ScopedTimer timer(duration);
+    u64 runUs = Metrics::elapsedUs(m_taskStartTime);
+    u64 suspendedUs = m_currentTask.suspendedMs * 1000;
+    m_runHistogram->record(runUs > suspendedUs ? runUs - suspendedUs : 0);
     u8 code(ErrCode_OK);
     code = removeTaskFromPending(m_currentTask.ID, false);
     if (code == ErrCode_INVALID_ARGUMENT ||
@@ -1308,21 +2033,458 @@ void Queue::mainLoopFin()
         return;
     }
 
+    m_finishedVersion.fetch_add(1, std::memory_order_release);
     m_currentTask = Proc::Task();
 }
 
+void Queue::readTask(Proc::Task &out)
+{
+    out.execName = reinterpret_cast<const char *>
+        (sqlite3_column_text(m_token->stmt, 0));
+    splitString(reinterpret_cast<const char *>
+        (sqlite3_column_text(m_token->stmt, 1)), out.args);
+    out.workDir = reinterpret_cast<const char *>
+        (sqlite3_column_text(m_token->stmt, 2));
+    out.ID = sqlite3_column_int(m_token->stmt, 3);
+    out.exitCode = sqlite3_column_int(m_token->stmt, 4);
+    out.isSuccess = sqlite3_column_int(m_token->stmt, 5);
+    out.cpus = static_cast<u32>(sqlite3_column_int(m_token->stmt, 6));
+    out.memoryMB = static_cast<u64>(sqlite3_column_int64(m_token->stmt, 7));
+    out.priority = sqlite3_column_int(m_token->stmt, 8);
+    out.suspendedMs = static_cast<u64>(sqlite3_column_int64(m_token->stmt, 9));
+    out.enqueueTime = sqlite3_column_int64(m_token->stmt, 10);
+    out.startTime = sqlite3_column_int64(m_token->stmt, 11);
+    out.endTime = sqlite3_column_int64(m_token->stmt, 12);
+    out.wallTimeoutSec = static_cast<u32>(sqlite3_column_int(m_token->stmt, 13));
+    out.cpuTimeoutSec = static_cast<u32>(sqlite3_column_int(m_token->stmt, 14));
+    out.isTimedOut = sqlite3_column_int(m_token->stmt, 15);
+    out.cpuUsageUs = static_cast<u64>(sqlite3_column_int64(m_token->stmt, 16));
+    out.memoryPeakBytes = static_cast<u64>(sqlite3_column_int64(m_token->stmt, 17));
+    out.ioReadBytes = static_cast<u64>(sqlite3_column_int64(m_token->stmt, 18));
+    out.ioWriteBytes = static_cast<u64>(sqlite3_column_int64(m_token->stmt, 19));
+    out.userTimeUs = static_cast<u64>(sqlite3_column_int64(m_token->stmt, 20));
+    out.systemTimeUs = static_cast<u64>(sqlite3_column_int64(m_token->stmt, 21));
+    out.maxRssKB = static_cast<u64>(sqlite3_column_int64(m_token->stmt, 22));
+    out.majorFaults = static_cast<u64>(sqlite3_column_int64(m_token->stmt, 23));
+    out.minorFaults = static_cast<u64>(sqlite3_column_int64(m_token->stmt, 24));
+}
+
+u8 Queue::nextTask(Proc::Task &out)
+{
+    FF_DEBUG("{}:{} Queue::nextTask", LOG_FILE_PATH(__FILE__), __LINE__);
+
+    expireLeases();
+
+    u8 ret(ErrCode_NOT_FOUND);
+    i32 id(0);
+    i32 currentID = m_currentID.load(std::memory_order_relaxed);
+
+    // among the tasks of the top priority, the one with the lowest
+    // expected run time minus aging x wait time
+    bool isShortestFirst = Sched::estimator().isShortestFirst(m_name);
+    f64 aging = isShortestFirst ? Sched::estimator().aging() : 0;
+    i64 now = nowMs();
+    f64 score(0), bestScore(0);
+    u32 scanned(0);
+    Proc::Task task;
+    if (sqlite3_prepare_v2(m_token->db,
+        "SELECT * FROM pending ORDER BY priority DESC, ID;", 49,
+        &m_token->stmt, NULL))
+    {
+        spdlog::error("{}:{} Fail to build prepared statment: {}",
+            LOG_FILE_PATH(__FILE__), __LINE__,
+            sqlite3_errmsg(m_token->db));
+        ret = ErrCode_OS_ERROR;
+        goto exit;
+    }
+
+    while (1)
+    {
+        i32 rc = sqlite3_step(m_token->stmt);
+        if (rc == SQLITE_ROW)
+        {
+            // skip the tasks which are run by mainLoop or workers
+            id = sqlite3_column_int(m_token->stmt, 3);
+            if (id == currentID || m_leases.find(id) != m_leases.end())
+            {
+                continue;
+            }
+
+            if (!isShortestFirst)
+            {
+                readTask(out);
+                ret = ErrCode_OK;
+                break;
+            }
+
+            readTask(task);
+            if (ret == ErrCode_OK && task.priority < out.priority)
+            {
+                break;
+            }
+
+            score = static_cast<f64>(Sched::estimator().expectedMs(task));
+            if (task.enqueueTime)
+            {
+                score -= aging * static_cast<f64>(now - task.enqueueTime);
+            }
+
+            if (ret != ErrCode_OK || score < bestScore)
+            {
+                out = task;
+                bestScore = score;
+                ret = ErrCode_OK;
+            }
+
+            if (++scanned >= MAX_SHORTEST_FIRST_SCAN)
+            {
+                break;
+            }
+        }
+        else if (rc == SQLITE_DONE)
+        {
+            break;
+        }
+        else
+        {
+            // other error
+            spdlog::error("{}:{} Fail to execute sql: {}",
+                LOG_FILE_PATH(__FILE__), __LINE__,
+                sqlite3_errmsg(m_token->db));
+            ret = ErrCode_OS_ERROR;
+            break;
+        }
+    }
+
+exit:
+
+    UNUSED(sqlite3_finalize(m_token->stmt));
+    m_token->stmt = nullptr;
+    return ret;
+}
+
+void Queue::warmEstimator()
+{
+    FF_DEBUG("{}:{} Queue::warmEstimator", LOG_FILE_PATH(__FILE__), __LINE__);
+
+    std::string sql = fmt::format(
+        "SELECT * FROM done WHERE startTime > 0 AND isTimedOut = 0 ORDER BY ID DESC LIMIT {};",
+        ESTIMATOR_WARM_UP);
+    std::vector<Proc::Task> tasks;
+    if (sqlite3_prepare_v2(m_token->db,
+        sql.c_str(), sql.length(),
+        &m_token->stmt, NULL))
+    {
+        spdlog::error("{}:{} Fail to build prepared statment: {}",
+            LOG_FILE_PATH(__FILE__), __LINE__,
+            sqlite3_errmsg(m_token->db));
+        goto exit;
+    }
+
+    while (sqlite3_step(m_token->stmt) == SQLITE_ROW)
+    {
+        Proc::Task task;
+        readTask(task);
+        tasks.push_back(task);
+    }
+
+    // oldest first, so the latest runs weigh the most
+    for (auto it = tasks.rbegin(); it != tasks.rend(); ++it)
+    {
+        Sched::estimator().record(*it, runMs(*it));
+    }
+
+exit:
+
+    UNUSED(sqlite3_finalize(m_token->stmt));
+    m_token->stmt = nullptr;
+}
+
+void Queue::expireLeases()
+{
+    static auto expired = Metrics::registry().counter("ff_lease_expired_total");
+
+    auto now = std::chrono::steady_clock::now();
+    for (auto it = m_leases.begin(); it != m_leases.end();)
+    {
+        if (it->second.deadline > now)
+        {
+            ++it;
+            continue;
+        }
+
+        spdlog::warn("{}:{} lease of task {} held by {} is expired, run it again",
+            LOG_FILE_PATH(__FILE__), __LINE__, it->first, it->second.worker);
+        expired->add();
+        it = m_leases.erase(it);
+    }
+}
+
+void Queue::recordWait(const i32 id,
+                       const std::chrono::steady_clock::time_point &now)
+{
+    // tasks added before the server started have no enqueue time
+    auto it = m_enqueueTime.find(id);
+    if (it != m_enqueueTime.end())
+    {
+        m_waitHistogram->record(static_cast<u64>(
+            std::chrono::duration_cast<std::chrono::microseconds>(
+                now - it->second).count()));
+        m_enqueueTime.erase(it);
+    }
+}
+
+u8 Queue::execSQL(const char *sql)
+{
+    FF_DEBUG("{}:{} Queue::execSQL", LOG_FILE_PATH(__FILE__), __LINE__);
+    FF_DEBUG("{}:{} sql: {}", LOG_FILE_PATH(__FILE__), __LINE__, sql);
+
+    u8 ret(ErrCode_OK);
+    if (sqlite3_prepare_v2(m_token->db, sql, -1, &m_token->stmt, NULL))
+    {
+        ret = ErrCode_OS_ERROR;
+        spdlog::error("{}:{} Fail to build prepared statment: {}",
+            LOG_FILE_PATH(__FILE__), __LINE__,
+            sqlite3_errmsg(m_token->db));
+        goto exit;
+    }
+
+    if (sqlite3_step(m_token->stmt) != SQLITE_DONE)
+    {
+        ret = ErrCode_OS_ERROR;
+        spdlog::error("{}:{} Fail to execute sql: {}",
+            LOG_FILE_PATH(__FILE__), __LINE__,
+            sqlite3_errmsg(m_token->db));
+    }
+
+exit:
+
+    UNUSED(sqlite3_finalize(m_token->stmt));
+    m_token->stmt = nullptr;
+    return ret;
+}
+
+u8 Queue::moveTasks(const std::string &path, std::vector<Proc::Task> &tasks)
+{
+    FF_DEBUG("{}:{} Queue::moveTasks", LOG_FILE_PATH(__FILE__), __LINE__);
+    FF_DEBUG("{}:{} path: {}", LOG_FILE_PATH(__FILE__), __LINE__, path);
+
+    u8 ret(ErrCode_OK);
+    bool isAttached(false), inTransaction(false);
+    i32 oldID(0);
+
+    if (sqlite3_prepare_v2(m_token->db,
+        "ATTACH DATABASE ? AS victim;", 28,
+        &m_token->stmt, NULL))
+    {
+        ret = ErrCode_OS_ERROR;
+        spdlog::error("{}:{} Fail to build prepared statment: {}",
+            LOG_FILE_PATH(__FILE__), __LINE__,
+            sqlite3_errmsg(m_token->db));
+        goto exit;
+    }
+
+    if (sqlite3_bind_text(m_token->stmt, 1, path.c_str(), path.length(), NULL))
+    {
+        ret = ErrCode_OS_ERROR;
+        spdlog::error("{}:{} Fail to build prepared statment: {}",
+            LOG_FILE_PATH(__FILE__), __LINE__,
+            sqlite3_errmsg(m_token->db));
+        goto exit;
+    }
+
+    if (sqlite3_step(m_token->stmt) != SQLITE_DONE)
+    {
+        ret = ErrCode_OS_ERROR;
+        spdlog::error("{}:{} Fail to attach {}: {}",
+            LOG_FILE_PATH(__FILE__), __LINE__, path,
+            sqlite3_errmsg(m_token->db));
+        goto exit;
+    }
+
+    UNUSED(sqlite3_finalize(m_token->stmt));
+    m_token->stmt = nullptr;
+    isAttached = true;
+
+    // one transaction over both files, sqlite commits them atomically
+    if (execSQL("BEGIN IMMEDIATE;"))
+    {
+        ret = ErrCode_OS_ERROR;
+        goto exit;
+    }
+
+    inTransaction = true;
+    for (auto it = tasks.begin(); it != tasks.end(); ++it)
+    {
+        oldID = it->ID;
+        if (getID(it->ID) || addTaskToTable("main.pending", *it))
+        {
+            ret = ErrCode_OS_ERROR;
+            goto exit;
+        }
+
+        if (sqlite3_prepare_v2(m_token->db,
+            "DELETE FROM victim.pending WHERE ID=?;", 38,
+            &m_token->stmt, NULL))
+        {
+            ret = ErrCode_OS_ERROR;
+            spdlog::error("{}:{} Fail to build prepared statment: {}",
+                LOG_FILE_PATH(__FILE__), __LINE__,
+                sqlite3_errmsg(m_token->db));
+            goto exit;
+        }
+
+        if (sqlite3_bind_int(m_token->stmt, 1, oldID))
+        {
+            ret = ErrCode_OS_ERROR;
+            spdlog::error("{}:{} Fail to build prepared statment: {}",
+                LOG_FILE_PATH(__FILE__), __LINE__,
+                sqlite3_errmsg(m_token->db));
+            goto exit;
+        }
+
+        if (sqlite3_step(m_token->stmt) != SQLITE_DONE ||
+            sqlite3_changes(m_token->db) != 1)
+        {
+            ret = ErrCode_OS_ERROR;
+            spdlog::error("{}:{} Fail to remove task {} from victim",
+                LOG_FILE_PATH(__FILE__), __LINE__, oldID);
+            goto exit;
+        }
+
+        UNUSED(sqlite3_finalize(m_token->stmt));
+        m_token->stmt = nullptr;
+    }
+
+    if (execSQL("COMMIT;"))
+    {
+        ret = ErrCode_OS_ERROR;
+        goto exit;
+    }
+
+    inTransaction = false;
+
+exit:
+
+    UNUSED(sqlite3_finalize(m_token->stmt));
+    m_token->stmt = nullptr;
+    if (inTransaction && execSQL("ROLLBACK;"))
+    {
+        spdlog::error("{}:{} Fail to roll back", LOG_FILE_PATH(__FILE__), __LINE__);
+    }
+
+    if (isAttached && execSQL("DETACH DATABASE victim;"))
+    {
+        spdlog::error("{}:{} Fail to detach", LOG_FILE_PATH(__FILE__), __LINE__);
+    }
+
+    return ret;
+}
+
+u8 Queue::stealTasks()
+{
+    FF_DEBUG("{}:{} Queue::stealTasks", LOG_FILE_PATH(__FILE__), __LINE__);
+
+    std::shared_ptr<QueueGroup> group;
+    {
+        std::unique_lock<std::mutex> lock(m_groupMutex);
+        group = m_group;
+    }
+
+    u32 count(0);
+    if (!group || group->steal(*this, count) || !count)
+    {
+        return 1;
+    }
+
+    return 0;
+}
+
+u8 Queue::takeTask()
+{
+    FF_DEBUG("{}:{} Queue::takeTask", LOG_FILE_PATH(__FILE__), __LINE__);
+
+    // find the task in pending list
+    std::unique_lock<std::mutex> lock = lockDB();
+    static auto duration = opDuration("nextTask");
+    Metrics::ScopedTimer timer(duration);
+
+    Proc::Task task;
+    u8 code = nextTask(task);
+    if (code)
+    {
+        return code;
+    }
+
+    std::unique_lock<std::mutex> taskLock(m_currentTaskMutex);
+    m_currentTask = task;
+    m_currentID.store(task.ID, std::memory_order_relaxed);
+    m_taskStartTime = std::chrono::steady_clock::now();
+    recordWait(task.ID, m_taskStartTime);
+    return ErrCode_OK;
+}
+
+u8 Queue::leaseTaskImpl(const std::string &worker,
+                        const u32 leaseMs,
+                        Proc::Task &out)
+{
+    FF_DEBUG("{}:{} Queue::leaseTaskImpl", LOG_FILE_PATH(__FILE__), __LINE__);
+
+    std::unique_lock<std::mutex> lock = lockDB();
+    static auto duration = opDuration("leaseTask");
+    Metrics::ScopedTimer timer(duration);
+    u8 code = nextTask(out);
+    if (code)
+    {
+        return code;
+    }
+
+    auto now = std::chrono::steady_clock::now();
+    m_leases[out.ID] = Lease{worker, now, now + std::chrono::milliseconds(leaseMs)};
+    recordWait(out.ID, now);
+    return ErrCode_OK;
+}
+
+std::unique_lock<std::mutex> Queue::lockDB()
+{
+    static auto lockWait = Metrics::registry().histogram("ff_sqlite_lock_wait");
+    auto start = std::chrono::steady_clock::now();
+    std::unique_lock<std::mutex> lock(m_token->mutex);
+    lockWait->record(Metrics::elapsedUs(start));
+    return lock;
+}
+
+void Queue::bindMetrics(const std::string &name)
+{
+    FF_DEBUG("{}:{} Queue::bindMetrics", LOG_FILE_PATH(__FILE__), __LINE__);
+    FF_DEBUG("{}:{} name: {}", LOG_FILE_PATH(__FILE__), __LINE__, name);
+
+    std::string labels = Metrics::label("queue", name);
+    auto pending = Metrics::registry().gauge("ff_queue_pending", labels);
+    if (m_pendingGauge)
+    {
+        // keep the depth when renaming
+        pending->set(m_pendingGauge->value());
+    }
+
+    m_pendingGauge = pending;
+    m_waitHistogram = Metrics::registry().histogram("ff_task_wait", labels);
+    m_runHistogram = Metrics::registry().histogram("ff_task_run", labels);
+}
+
 void Queue::stopImpl()
 {
     if (!m_isRunning.load(std::memory_order_relaxed))
     {
-        spdlog::debug("{}:{} Queue is not running.",
+        FF_DEBUG("{}:{} Queue is not running.",
             LOG_FILE_PATH(__FILE__), __LINE__);
         return;
     }
 
     m_start.store(false, std::memory_order_relaxed);
+    Sched::scheduler().interrupt();
+    // mainLoop clears m_isRunning once the task is reaped and recorded
     m_proc->stop();
-    m_isRunning.store(false, std::memory_order_relaxed);
 }
 
 } // end namespace SQLite
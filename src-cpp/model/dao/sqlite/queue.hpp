@@ -25,12 +25,17 @@
 #define _MODEL_DAO_SQLITE_QUEUE_HPP_
 
 #include <atomic>
+#include <chrono>
+#include <deque>
 #include <mutex>
 #include <thread>
+#include <unordered_map>
 
 #include "model/connect/sqlite/token.hpp"
 
+#include "model/dao/ileasequeue.hpp"
 #include "model/dao/iqueue.hpp"
+#include "model/metrics/metrics.hpp"
 #include "model/proc/iproc.hpp"
 
 namespace Model
@@ -42,7 +47,9 @@ namespace DAO
 namespace SQLite
 {
 
-class Queue: public IQueue
+class QueueGroup;
+
+class Queue: public IQueue, public ILeaseQueue
 {
 public:
 
@@ -75,6 +82,8 @@ public:
 
     virtual u8 removeTask(const i32 in) override;
 
+    virtual u8 reprioritize(const i32 id, const i32 priority) override;
+
     virtual bool isRunning() const override;
 
     virtual void readCurrentOutput(std::vector<std::string> &out) override;
@@ -83,8 +92,51 @@ public:
 
     virtual void stop() override;
 
+    virtual void finishedGeneration(u64 &epoch, u64 &version) const override;
+
+    virtual u8 leaseTask(const std::string &worker,
+                         const u32 leaseMs,
+                         Proc::Task &out) override;
+
+    virtual u8 renewLease(const std::string &worker,
+                          const i32 id,
+                          const u32 leaseMs) override;
+
+    virtual u8 appendLeaseOutput(const std::string &worker,
+                                 const i32 id,
+                                 std::vector<std::string> &output) override;
+
+    virtual u8 finishLease(const std::string &worker,
+                           const i32 id,
+                           const i32 exitCode,
+                           const bool isTimedOut,
+                           const bool isFailed) override;
+
+    virtual void releaseLeases(const std::string &worker) override;
+
     u8 rename(const std::string &newName, const std::string &oldName);
 
+    /**
+     * @brief move up to maxCount waiting tasks of victim to this queue
+     *
+     * Both databases are changed in one transaction, so every task is
+     * either still in victim or in this queue with a new ID.
+     * The current and the leased tasks of victim are never moved.
+     * @param out how many tasks are moved
+     */
+    u8 stealFrom(Queue &victim, const u32 maxCount, u32 &out);
+
+    /**
+     * @brief pending tasks, including the running and the leased ones
+     */
+    i64 pendingCount();
+
+    /**
+     * @brief steal from this group when running out of tasks,
+     * nullptr to leave the group
+     */
+    void setGroup(const std::shared_ptr<QueueGroup> &group);
+
 private:
 
     std::shared_ptr<Connect::SQLite::Token> m_token;
@@ -95,12 +147,57 @@ private:
 
     std::atomic<bool> m_isRunning;
 
+    // ID of the task which is run by mainLoop, -1 if none
+    std::atomic<i32> m_currentID;
+
     std::atomic<bool> m_start;
 
     std::jthread m_thread;
 
     std::string m_targetPath;
 
+    // guarded by m_token->mutex
+    std::string m_name;
+
+    std::string m_dbPath;
+
+    std::mutex m_groupMutex;
+
+    std::shared_ptr<QueueGroup> m_group;
+
+    std::atomic<u64> m_finishedEpoch;
+
+    std::atomic<u64> m_finishedVersion;
+
+    // metrics, guarded by m_token->mutex
+    std::shared_ptr<Metrics::Gauge> m_pendingGauge;
+
+    std::shared_ptr<Metrics::Histogram> m_waitHistogram;
+
+    std::shared_ptr<Metrics::Histogram> m_runHistogram;
+
+    std::unordered_map<i32, std::chrono::steady_clock::time_point> m_enqueueTime;
+
+    std::chrono::steady_clock::time_point m_taskStartTime;
+
+    typedef struct Lease
+    {
+        std::string worker;
+        std::chrono::steady_clock::time_point start;
+        std::chrono::steady_clock::time_point deadline;
+    } Lease;
+
+    // leased tasks stay in pending, guarded by m_token->mutex
+    std::unordered_map<i32, Lease> m_leases;
+
+    std::mutex m_leaseOutputMutex;
+
+    std::deque<std::string> m_leaseOutput;
+
+    std::unique_lock<std::mutex> lockDB();
+
+    void bindMetrics(const std::string &);
+
     u8 connectToDB(const std::string &, const std::string & = "");
 
     u8 createTable(const std::string &);
@@ -127,10 +224,34 @@ private:
 
     u8 getID(i32 &);
 
+    void readTask(Proc::Task &);
+
+    u8 nextTask(Proc::Task &);
+
+    // feed the estimator with the latest finished tasks
+    void warmEstimator();
+
+    void expireLeases();
+
+    void recordWait(const i32, const std::chrono::steady_clock::time_point &);
+
+    u8 execSQL(const char *);
+
+    u8 moveTasks(const std::string &, std::vector<Proc::Task> &);
+
+    u8 stealTasks();
+
+    u8 takeTask();
+
+    u8 leaseTaskImpl(const std::string &, const u32, Proc::Task &);
+
     void mainLoop();
 
     u8 mainLoopInit();
 
+    // the task was not started, leave it in the pending list
+    void mainLoopAbort();
+
     void mainLoopFin();
 
     void stopImpl();
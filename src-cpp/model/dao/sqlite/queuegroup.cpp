@@ -0,0 +1,115 @@
+/*
+ * Flex Flow
+ * Copyright (c) 2026-present fdar0536
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+#include "spdlog/spdlog.h"
+
+#include "model/errmsg.hpp"
+#include "model/utils.hpp"
+
+#include "queue.hpp"
+#include "queuegroup.hpp"
+
+namespace Model
+{
+
+namespace DAO
+{
+
+namespace SQLite
+{
+
+void QueueGroup::join(const std::shared_ptr<Queue> &queue)
+{
+    FF_DEBUG("{}:{} QueueGroup::join", LOG_FILE_PATH(__FILE__), __LINE__);
+
+    m_members.update([&](Members &members) -> u8
+    {
+        // drop the deleted queues as well
+        std::erase_if(members, [&](const std::weak_ptr<Queue> &member)
+        {
+            auto ptr = member.lock();
+            return !ptr || ptr == queue;
+        });
+
+        members.push_back(queue);
+        return 0;
+    });
+}
+
+void QueueGroup::leave(const Queue *queue)
+{
+    FF_DEBUG("{}:{} QueueGroup::leave", LOG_FILE_PATH(__FILE__), __LINE__);
+
+    m_members.update([&](Members &members) -> u8
+    {
+        std::erase_if(members, [&](const std::weak_ptr<Queue> &member)
+        {
+            auto ptr = member.lock();
+            return !ptr || ptr.get() == queue;
+        });
+
+        return 0;
+    });
+}
+
+u8 QueueGroup::steal(Queue &thief, u32 &out)
+{
+    FF_DEBUG("{}:{} QueueGroup::steal", LOG_FILE_PATH(__FILE__), __LINE__);
+
+    out = 0;
+    auto members = m_members.load();
+    std::shared_ptr<Queue> victim = nullptr;
+    i64 most(0);
+    for (auto it = members->begin(); it != members->end(); ++it)
+    {
+        // a stopped queue keeps its tasks, someone stopped it on purpose
+        auto member = it->lock();
+        if (!member || member.get() == &thief || !member->isRunning())
+        {
+            continue;
+        }
+
+        i64 count = member->pendingCount();
+        if (count > most)
+        {
+            most = count;
+            victim = member;
+        }
+    }
+
+    if (!victim)
+    {
+        return ErrCode_NOT_FOUND;
+    }
+
+    // the count includes the task which the victim is running
+    u32 batch = static_cast<u32>(most / 2);
+    if (!batch) batch = 1;
+    if (batch > MAX_STEAL_BATCH) batch = MAX_STEAL_BATCH;
+    return thief.stealFrom(*victim, batch, out);
+}
+
+} // end namespace SQLite
+
+} // end namespace DAO
+
+} // end namespace Model
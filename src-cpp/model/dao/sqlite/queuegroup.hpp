@@ -0,0 +1,82 @@
+/*
+ * Flex Flow
+ * Copyright (c) 2026-present fdar0536
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+#ifndef _MODEL_DAO_SQLITE_QUEUEGROUP_HPP_
+#define _MODEL_DAO_SQLITE_QUEUEGROUP_HPP_
+
+#include <memory>
+#include <vector>
+
+#include "model/defines.h"
+#include "model/snapshot.hpp"
+
+namespace Model
+{
+
+namespace DAO
+{
+
+namespace SQLite
+{
+
+class Queue;
+
+/**
+ * @brief queues which share their pending tasks
+ *
+ * A member which runs out of tasks steals from the running member
+ * with the most pending tasks before it stops.
+ */
+class QueueGroup
+{
+public:
+
+    // upper bound of the tasks moved in one transaction
+    static constexpr u32 MAX_STEAL_BATCH = 64;
+
+    void join(const std::shared_ptr<Queue> &queue);
+
+    void leave(const Queue *queue);
+
+    /**
+     * @brief move about half of the busiest member's waiting tasks to thief
+     * @param out how many tasks are moved
+     * @return u8 ErrCode_NOT_FOUND if no other member is running
+     */
+    u8 steal(Queue &thief, u32 &out);
+
+private:
+
+    typedef std::vector<std::weak_ptr<Queue>> Members;
+
+    // changed on create / delete / rename only
+    Snapshot<Members> m_members;
+
+}; // end class QueueGroup
+
+} // end namespace SQLite
+
+} // end namespace DAO
+
+} // end namespace Model
+
+#endif // _MODEL_DAO_SQLITE_QUEUEGROUP_HPP_
@@ -62,9 +62,10 @@ QueueList::~QueueList()
 
 u8
 QueueList::init(std::shared_ptr<Connect::SQLite::Token> &token,
-        const std::string &target)
+        const std::string &target,
+        const std::map<std::string, std::vector<std::string>> &groups)
 {
-    spdlog::debug("{}:{} QueueList::init", LOG_FILE_PATH(__FILE__), __LINE__);
+    FF_DEBUG("{}:{} QueueList::init", LOG_FILE_PATH(__FILE__), __LINE__);
 
     if (token == nullptr)
     {
@@ -76,6 +77,22 @@ QueueList::init(std::shared_ptr<Connect::SQLite::Token> &token,
     m_token = token;
     m_target = target;
 
+    m_groups.clear();
+    for (auto it = groups.begin(); it != groups.end(); ++it)
+    {
+        auto group = std::make_shared<QueueGroup>();
+        for (auto name = it->second.begin(); name != it->second.end(); ++name)
+        {
+            if (!m_groups.emplace(*name, group).second)
+            {
+                spdlog::error("{}:{} {} is in more than one group",
+                    LOG_FILE_PATH(__FILE__), __LINE__, *name);
+                m_token = nullptr;
+                return ErrCode_INVALID_ARGUMENT;
+            }
+        }
+    }
+
     if (Utils::verifyDir(target))
     {
         spdlog::error("{}:{} Fail to verify target path.",
@@ -84,61 +101,177 @@ QueueList::init(std::shared_ptr<Connect::SQLite::Token> &token,
     }
 
     // create queue
-    std::error_code ec;
-    std::string fileName;
-    m_queueList.clear();
-    for (const auto& entry :
-         std::filesystem::directory_iterator(target))
+    u8 ret = m_queueList.update([&](QueueMap &map) -> u8
     {
-        if (std::filesystem::is_directory(entry))
+        std::string fileName;
+        map.clear();
+        for (const auto& entry :
+             std::filesystem::directory_iterator(target))
         {
-            spdlog::warn("{}:{} {} is directory, ignore...", LOG_FILE_PATH(__FILE__), __LINE__,
-                         entry.path().string());
-            continue;
+            if (std::filesystem::is_directory(entry))
+            {
+                spdlog::warn("{}:{} {} is directory, ignore...", LOG_FILE_PATH(__FILE__), __LINE__,
+                             entry.path().string());
+                continue;
+            }
+
+            if (!std::filesystem::is_regular_file(entry))
+            {
+                spdlog::warn("{}:{} {} is not regular file, ignore...",
+                    LOG_FILE_PATH(__FILE__), __LINE__,
+                    entry.path().string());
+                continue;
+            }
+
+            // regular file
+            fileName = entry.path().string();
+            Utils::convertPath(fileName);
+            size_t index = fileName.find_last_of("/");
+            std::string name = fileName.substr(index + 1);
+            index = name.find_last_of(".");
+            if (name.substr(index + 1) != "db")
+            {
+                spdlog::warn("{}:{} {} is not database, ignore...",
+                    LOG_FILE_PATH(__FILE__), __LINE__,
+                    fileName);
+                continue;
+            }
+
+            name = name.substr(0, index);
+            if (createQueueImpl(map, name))
+            {
+                spdlog::error("{}:{} Fail to create queue: {}", LOG_FILE_PATH(__FILE__), __LINE__,
+                              name);
+                return ErrCode_OS_ERROR;
+            }
         }
 
-        if (!std::filesystem::is_regular_file(entry))
+        return ErrCode_OK;
+    });
+
+    if (ret)
+    {
+        m_token = nullptr;
+        return ret;
+    }
+
+    return ErrCode_OK;
+}
+
+u8 QueueList::createQueue(const std::string &name)
+{
+    FF_DEBUG("{}:{} QueueList::createQueue", LOG_FILE_PATH(__FILE__), __LINE__);
+
+    return m_queueList.update([&](QueueMap &map) -> u8
+    {
+        return createQueueImpl(map, name);
+    });
+}
+
+u8 QueueList::listQueue(std::vector<std::string> &out)
+{
+    FF_DEBUG("{}:{} QueueList::listQueue", LOG_FILE_PATH(__FILE__), __LINE__);
+
+    auto queueList = m_queueList.load();
+    out.clear();
+    out.reserve(queueList->size());
+    for (auto it = queueList->begin();
+         it != queueList->end();
+         ++it)
+    {
+        out.push_back(it->first);
+    }
+
+    return ErrCode_OK;
+}
+
+u8 QueueList::deleteQueue(const std::string &name)
+{
+    FF_DEBUG("{}:{} QueueList::deleteQueue", LOG_FILE_PATH(__FILE__), __LINE__);
+
+    u8 ret = m_queueList.update([&](QueueMap &map) -> u8
+    {
+        auto it = map.find(name);
+        if (it == map.end())
         {
-            spdlog::warn("{}:{} {} is not regular file, ignore...",
-                LOG_FILE_PATH(__FILE__), __LINE__,
-                entry.path().string());
-            continue;
+            spdlog::error("{}:{} No such queue: {}", LOG_FILE_PATH(__FILE__), __LINE__,
+                name);
+            return ErrCode_NOT_FOUND;
         }
 
-        // regular file
-        fileName = entry.path().string();
-        Utils::convertPath(fileName);
-        size_t index = fileName.find_last_of("/");
-        std::string name = fileName.substr(index + 1);
-        index = name.find_last_of(".");
-        if (name.substr(index + 1) != "db")
+        // callers may still hold the queue, nobody steals from it anymore
+        joinGroup(it->second, "");
+        map.erase(it);
+        return ErrCode_OK;
+    });
+
+    if (ret)
+    {
+        return ret;
+    }
+
+    std::remove((m_target + "/" + name + ".db").c_str());
+    Metrics::registry().remove(Metrics::label("queue", name));
+    return ErrCode_OK;
+}
+
+u8
+QueueList::renameQueue(const std::string &oldName,
+                             const std::string &newName)
+{
+    FF_DEBUG("{}:{} QueueList::renameQueue", LOG_FILE_PATH(__FILE__), __LINE__);
+    FF_DEBUG("{}:{} oldName: {}", LOG_FILE_PATH(__FILE__), __LINE__, oldName.c_str());
+    FF_DEBUG("{}:{} newName: {}", LOG_FILE_PATH(__FILE__), __LINE__, newName.c_str());
+
+    return m_queueList.update([&](QueueMap &map) -> u8
+    {
+        auto it = map.find(oldName);
+        if (it == map.end())
         {
-            spdlog::warn("{}:{} {} is not database, ignore...",
-                LOG_FILE_PATH(__FILE__), __LINE__,
-                fileName);
-            continue;
+            spdlog::error("{}:{} No such queue: {}", LOG_FILE_PATH(__FILE__), __LINE__,
+                oldName);
+            return ErrCode_NOT_FOUND;
         }
 
-        name = name.substr(0, index);
-        if (createQueue(name))
+        if (map.find(newName) != map.end())
         {
-            spdlog::error("{}:{} Fail to create queue: {}", LOG_FILE_PATH(__FILE__), __LINE__,
-                          name);
-            m_token = nullptr;
-            m_queueList.clear();
+            spdlog::error("{}:{} {} is already exists", LOG_FILE_PATH(__FILE__), __LINE__,
+                newName);
+            return ErrCode_ALREADY_EXISTS;
+        }
+
+        Queue *queue = static_cast<Queue *>(it->second.get());
+        if (queue->rename(newName, oldName))
+        {
+            spdlog::error("{}:{} Fail to rename", LOG_FILE_PATH(__FILE__), __LINE__);
             return ErrCode_OS_ERROR;
         }
-    }
 
-    return ErrCode_OK;
+        joinGroup(it->second, newName);
+        map[newName] = it->second;
+        map.erase(oldName);
+        return ErrCode_OK;
+    });
 }
 
-u8 QueueList::createQueue(const std::string &name)
+std::shared_ptr<IQueue> QueueList::getQueue(const std::string &name)
 {
-    spdlog::debug("{}:{} QueueList::createQueue", LOG_FILE_PATH(__FILE__), __LINE__);
-    spdlog::debug("{}:{} name: {}", LOG_FILE_PATH(__FILE__), __LINE__, name.c_str());
+    FF_DEBUG("{}:{} QueueList::getQueue", LOG_FILE_PATH(__FILE__), __LINE__);
+    FF_DEBUG("{}:{} name: {}", LOG_FILE_PATH(__FILE__), __LINE__, name.c_str());
 
-    if (m_queueList.find(name) != m_queueList.end())
+    auto queueList = m_queueList.load();
+    auto it = queueList->find(name);
+    if (it == queueList->end()) return nullptr;
+    return it->second;
+}
+
+// private member functions
+u8 QueueList::createQueueImpl(QueueMap &map, const std::string &name)
+{
+    FF_DEBUG("{}:{} QueueList::createQueueImpl", LOG_FILE_PATH(__FILE__), __LINE__);
+    FF_DEBUG("{}:{} name: {}", LOG_FILE_PATH(__FILE__), __LINE__, name.c_str());
+
+    if (map.find(name) != map.end())
     {
         spdlog::error("{}:{} {} is already exists", LOG_FILE_PATH(__FILE__), __LINE__, name);
         return ErrCode_ALREADY_EXISTS;
@@ -168,86 +301,50 @@ u8 QueueList::createQueue(const std::string &name)
     
     auto _proc = std::shared_ptr<Proc::IProc>(proc);
 
-    if (queue->init(m_token, m_target, _proc, name))
+    // every queue owns its own database connection
+    Connect::SQLite::Token *token = new (std::nothrow) Connect::SQLite::Token;
+    if (!token)
     {
         delete queue;
-        spdlog::error("{}:{} Fail to initialize queue", LOG_FILE_PATH(__FILE__), __LINE__);
+        spdlog::error("{}:{} Fail to allocate memory", LOG_FILE_PATH(__FILE__), __LINE__);
         return ErrCode_OS_ERROR;
     }
 
-    m_queueList[name] = std::shared_ptr<IQueue>(queue);
-    return ErrCode_OK;
-}
-
-u8 QueueList::listQueue(std::vector<std::string> &out)
-{
-    spdlog::debug("{}:{} QueueList::listQueue", LOG_FILE_PATH(__FILE__), __LINE__);
+    auto _token = std::shared_ptr<Connect::SQLite::Token>(token);
 
-    out.clear();
-    out.reserve(m_queueList.size());
-    for (auto it = m_queueList.begin();
-         it != m_queueList.end();
-         ++it)
+    if (queue->init(_token, m_target, _proc, name))
     {
-        out.push_back(it->first);
+        delete queue;
+        spdlog::error("{}:{} Fail to initialize queue", LOG_FILE_PATH(__FILE__), __LINE__);
+        return ErrCode_OS_ERROR;
     }
 
+    map[name] = std::shared_ptr<IQueue>(queue);
+    joinGroup(map[name], name);
     return ErrCode_OK;
 }
 
-u8 QueueList::deleteQueue(const std::string &name)
+void QueueList::joinGroup(const std::shared_ptr<IQueue> &queue,
+                          const std::string &name)
 {
-    spdlog::debug("{}:{} QueueList::deleteQueue", LOG_FILE_PATH(__FILE__), __LINE__);
+    FF_DEBUG("{}:{} QueueList::joinGroup", LOG_FILE_PATH(__FILE__), __LINE__);
+    FF_DEBUG("{}:{} name: {}", LOG_FILE_PATH(__FILE__), __LINE__, name);
 
-    if (!m_queueList.erase(name))
+    auto ptr = std::static_pointer_cast<Queue>(queue);
+    for (auto it = m_groups.begin(); it != m_groups.end(); ++it)
     {
-        spdlog::error("{}:{} No such queue: {}", LOG_FILE_PATH(__FILE__), __LINE__,
-            name);
-        return ErrCode_NOT_FOUND;
+        it->second->leave(ptr.get());
     }
 
-    std::remove((m_target + "/" + name + ".db").c_str());
-    return ErrCode_OK;
-}
-
-u8
-QueueList::renameQueue(const std::string &oldName,
-                             const std::string &newName)
-{
-    spdlog::debug("{}:{} QueueList::renameQueue", LOG_FILE_PATH(__FILE__), __LINE__);
-    spdlog::debug("{}:{} oldName: {}", LOG_FILE_PATH(__FILE__), __LINE__, oldName.c_str());
-    spdlog::debug("{}:{} newName: {}", LOG_FILE_PATH(__FILE__), __LINE__, newName.c_str());
-
-    for (auto &it : m_queueList)
+    auto it = m_groups.find(name);
+    if (it == m_groups.end())
     {
-        if (it.first == oldName)
-        {
-            Queue *queue = static_cast<Queue *>(it.second.get());
-            if (queue->rename(newName, oldName))
-            {
-                spdlog::error("{}:{} Fail to rename", LOG_FILE_PATH(__FILE__), __LINE__);
-                return ErrCode_OS_ERROR;
-            }
-
-            m_queueList[newName] = it.second;
-            m_queueList.erase(oldName);
-            return ErrCode_OK;
-        }
+        ptr->setGroup(nullptr);
+        return;
     }
 
-    spdlog::error("{}:{} No such queue: {}", LOG_FILE_PATH(__FILE__), __LINE__,
-        oldName);
-    return ErrCode_NOT_FOUND;
-}
-
-std::shared_ptr<IQueue> QueueList::getQueue(const std::string &name)
-{
-    spdlog::debug("{}:{} QueueList::getQueue", LOG_FILE_PATH(__FILE__), __LINE__);
-    spdlog::debug("{}:{} name: {}", LOG_FILE_PATH(__FILE__), __LINE__, name.c_str());
-
-    auto it = m_queueList.find(name);
-    if (it == m_queueList.end()) return nullptr;
-    return it->second;
+    it->second->join(ptr);
+    ptr->setGroup(it->second);
 }
 
 } // end namespace SQLite
@@ -24,11 +24,15 @@
 #ifndef _MODEL_DAO_SQLITE_QUEUELIST_HPP_
 #define _MODEL_DAO_SQLITE_QUEUELIST_HPP_
 
+#include <map>
 #include <unordered_map>
 
 #include "model/connect/sqlite/token.hpp"
 
 #include "model/dao/iqueuelist.hpp"
+#include "model/snapshot.hpp"
+
+#include "queuegroup.hpp"
 
 namespace Model
 {
@@ -47,7 +51,13 @@ public:
 
     ~QueueList();
 
-    u8 init(std::shared_ptr<Connect::SQLite::Token> &token, const std::string &target);
+    /**
+     * @param groups group name to the names of its queues,
+     * a queue belongs to one group at most
+     */
+    u8 init(std::shared_ptr<Connect::SQLite::Token> &token,
+            const std::string &target,
+            const std::map<std::string, std::vector<std::string>> &groups = {});
 
     u8 createQueue(const std::string &name) override;
 
@@ -62,11 +72,22 @@ public:
 
 private:
 
-    std::unordered_map<std::string,
-    std::shared_ptr<IQueue>> m_queueList;
+    typedef std::unordered_map<std::string,
+    std::shared_ptr<IQueue>> QueueMap;
+
+    // lookups read the current version without locking,
+    // create / delete / rename publish a new one
+    Snapshot<QueueMap> m_queueList;
 
     std::shared_ptr<Connect::SQLite::Token> m_token;
     std::string m_target;
+
+    // queue name to its group, fixed after init
+    std::unordered_map<std::string, std::shared_ptr<QueueGroup>> m_groups;
+
+    u8 createQueueImpl(QueueMap &map, const std::string &name);
+
+    void joinGroup(const std::shared_ptr<IQueue> &queue, const std::string &name);
 };
 
 } // end namespace SQLite
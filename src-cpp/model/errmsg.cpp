@@ -38,7 +38,7 @@ static std::unordered_map<u8, grpc::StatusCode> table;
 
 void init()
 {
-    spdlog::debug("{}:{} init", LOG_FILE_PATH(__FILE__), __LINE__);
+    FF_DEBUG("{}:{} init", LOG_FILE_PATH(__FILE__), __LINE__);
     table[ErrCode_OK] = grpc::StatusCode::OK;
     table[ErrCode_INVALID_ARGUMENT] = grpc::StatusCode::INVALID_ARGUMENT;
     table[ErrCode_NOT_FOUND] = grpc::StatusCode::NOT_FOUND;
@@ -49,7 +49,7 @@ void init()
 
 grpc::Status toGRPCStatus(u8 code, const std::string &msg)
 {
-    spdlog::debug("{}:{} toGRPCStatus", LOG_FILE_PATH(__FILE__), __LINE__);
+    FF_DEBUG("{}:{} toGRPCStatus", LOG_FILE_PATH(__FILE__), __LINE__);
     return grpc::Status(table[code], msg);
 }
 
@@ -0,0 +1,406 @@
+/*
+ * Flex Flow
+ * Copyright (c) 2026-present fdar0536
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include <bit>
+#include <cmath>
+
+#include "spdlog/spdlog.h"
+
+#include "model/utils.hpp"
+
+#include "metrics.hpp"
+
+namespace Model
+{
+
+namespace Metrics
+{
+
+// Counter
+void Counter::add(u64 value)
+{
+    m_value.fetch_add(value, std::memory_order_relaxed);
+}
+
+u64 Counter::value() const
+{
+    return m_value.load(std::memory_order_relaxed);
+}
+
+// Gauge
+void Gauge::set(i64 value)
+{
+    m_value.store(value, std::memory_order_relaxed);
+}
+
+void Gauge::add(i64 value)
+{
+    m_value.fetch_add(value, std::memory_order_relaxed);
+}
+
+i64 Gauge::value() const
+{
+    return m_value.load(std::memory_order_relaxed);
+}
+
+// Histogram
+void Histogram::record(u64 value)
+{
+    m_buckets[bucketIndex(value)].fetch_add(1, std::memory_order_relaxed);
+    m_count.fetch_add(1, std::memory_order_relaxed);
+    m_sum.fetch_add(value, std::memory_order_relaxed);
+
+    u64 current = m_max.load(std::memory_order_relaxed);
+    while (value > current &&
+           !m_max.compare_exchange_weak(current, value,
+                                        std::memory_order_relaxed))
+    {}
+}
+
+u64 Histogram::count() const
+{
+    return m_count.load(std::memory_order_relaxed);
+}
+
+u64 Histogram::sum() const
+{
+    return m_sum.load(std::memory_order_relaxed);
+}
+
+u64 Histogram::max() const
+{
+    return m_max.load(std::memory_order_relaxed);
+}
+
+u64 Histogram::percentile(f64 quantile) const
+{
+    std::array<u64, BUCKET_COUNT> buckets;
+    u64 total(0);
+    for (u32 i = 0; i < BUCKET_COUNT; ++i)
+    {
+        buckets[i] = m_buckets[i].load(std::memory_order_relaxed);
+        total += buckets[i];
+    }
+
+    if (!total)
+    {
+        return 0;
+    }
+
+    if (quantile < 0) quantile = 0;
+    if (quantile > 1) quantile = 1;
+    u64 target = static_cast<u64>(std::ceil(quantile * total));
+    if (!target) target = 1;
+
+    u64 seen(0);
+    for (u32 i = 0; i < BUCKET_COUNT; ++i)
+    {
+        seen += buckets[i];
+        if (seen >= target)
+        {
+            u64 upper = bucketLowerBound(i + 1) - 1;
+            u64 currentMax = max();
+            return upper < currentMax ? upper : currentMax;
+        }
+    }
+
+    return max();
+}
+
+u64 Histogram::countBelow(u64 bound) const
+{
+    u64 out(0);
+    for (u32 i = 0; i < BUCKET_COUNT; ++i)
+    {
+        if (bucketLowerBound(i + 1) > bound)
+        {
+            break;
+        }
+
+        out += m_buckets[i].load(std::memory_order_relaxed);
+    }
+
+    return out;
+}
+
+u32 Histogram::bucketIndex(u64 value)
+{
+    constexpr u64 maxValue = (static_cast<u64>(1) << MAX_VALUE_BITS) - 1;
+    if (value > maxValue) value = maxValue;
+    if (value < SUB_BUCKET_COUNT) return static_cast<u32>(value);
+
+    u32 exponent = static_cast<u32>(std::bit_width(value)) - 1;
+    u32 sub = static_cast<u32>(value >> (exponent - SUB_BUCKET_BITS)) &
+              (SUB_BUCKET_COUNT - 1);
+    return SUB_BUCKET_COUNT +
+           (exponent - SUB_BUCKET_BITS) * SUB_BUCKET_COUNT + sub;
+}
+
+u64 Histogram::bucketLowerBound(u32 index)
+{
+    if (index < SUB_BUCKET_COUNT) return index;
+
+    u32 exponent = (index - SUB_BUCKET_COUNT) / SUB_BUCKET_COUNT +
+                   SUB_BUCKET_BITS;
+    u64 sub = index % SUB_BUCKET_COUNT;
+    return (SUB_BUCKET_COUNT + sub) << (exponent - SUB_BUCKET_BITS);
+}
+
+// ScopedTimer
+ScopedTimer::ScopedTimer(const std::shared_ptr<Histogram> &histogram) :
+    m_histogram(histogram.get()),
+    m_start(std::chrono::steady_clock::now())
+{}
+
+ScopedTimer::~ScopedTimer()
+{
+    if (m_histogram)
+    {
+        m_histogram->record(elapsedUs(m_start));
+    }
+}
+
+// Registry
+std::shared_ptr<Counter>
+Registry::counter(const std::string &name, const std::string &labels)
+{
+    return getOrCreate(&Families::counters, name, labels);
+}
+
+std::shared_ptr<Gauge>
+Registry::gauge(const std::string &name, const std::string &labels)
+{
+    return getOrCreate(&Families::gauges, name, labels);
+}
+
+std::shared_ptr<Histogram>
+Registry::histogram(const std::string &name, const std::string &labels)
+{
+    return getOrCreate(&Families::histograms, name, labels);
+}
+
+template <typename T>
+static void removeLabels(Registry::Family<T> &family, const std::string &labels)
+{
+    for (auto it = family.begin(); it != family.end();)
+    {
+        if (it->first.second == labels)
+        {
+            it = family.erase(it);
+            continue;
+        }
+
+        ++it;
+    }
+}
+
+void Registry::remove(const std::string &labels)
+{
+    FF_DEBUG("{}:{} Registry::remove", LOG_FILE_PATH(__FILE__), __LINE__);
+    FF_DEBUG("{}:{} labels: {}", LOG_FILE_PATH(__FILE__), __LINE__, labels);
+
+    m_families.update([&](Families &families) -> u8
+    {
+        removeLabels(families.counters, labels);
+        removeLabels(families.gauges, labels);
+        removeLabels(families.histograms, labels);
+        return 0;
+    });
+}
+
+std::shared_ptr<const Registry::Families> Registry::load() const
+{
+    return m_families.load();
+}
+
+static std::string seriesName(const std::string &name,
+                              const std::string &labels,
+                              const std::string &extraLabel = "")
+{
+    if (labels.empty() && extraLabel.empty())
+    {
+        return name;
+    }
+
+    std::string out = name + "{" + labels;
+    if (!labels.empty() && !extraLabel.empty())
+    {
+        out += ",";
+    }
+
+    out += extraLabel + "}";
+    return out;
+}
+
+static void writeType(std::string &out,
+                      std::string &lastName,
+                      const std::string &name,
+                      const char *type)
+{
+    if (name == lastName)
+    {
+        return;
+    }
+
+    lastName = name;
+    out += fmt::format("# TYPE {} {}\n", name, type);
+}
+
+std::string Registry::toPrometheus() const
+{
+    FF_DEBUG("{}:{} Registry::toPrometheus", LOG_FILE_PATH(__FILE__), __LINE__);
+
+    // bucket bounds in us: 1, 4, 16, ... 4^19 (about 3 days)
+    static constexpr u32 boundCount = 20;
+
+    auto families = m_families.load();
+    std::string out;
+    std::string lastName;
+
+    for (auto it = families->counters.begin();
+         it != families->counters.end();
+         ++it)
+    {
+        writeType(out, lastName, it->first.first, "counter");
+        out += fmt::format("{} {}\n",
+            seriesName(it->first.first, it->first.second),
+            it->second->value());
+    }
+
+    for (auto it = families->gauges.begin();
+         it != families->gauges.end();
+         ++it)
+    {
+        writeType(out, lastName, it->first.first, "gauge");
+        out += fmt::format("{} {}\n",
+            seriesName(it->first.first, it->first.second),
+            it->second->value());
+    }
+
+    for (auto it = families->histograms.begin();
+         it != families->histograms.end();
+         ++it)
+    {
+        std::string name = it->first.first + "_seconds";
+        const std::string &labels = it->first.second;
+        const Histogram &histogram = *it->second;
+
+        writeType(out, lastName, name, "histogram");
+        u64 bound(1);
+        for (u32 i = 0; i < boundCount; ++i, bound <<= 2)
+        {
+            out += fmt::format("{} {}\n",
+                seriesName(name + "_bucket", labels,
+                    fmt::format("le=\"{}\"", static_cast<f64>(bound) / 1e6)),
+                histogram.countBelow(bound));
+        }
+
+        u64 count = histogram.count();
+        out += fmt::format("{} {}\n",
+            seriesName(name + "_bucket", labels, "le=\"+Inf\""), count);
+        out += fmt::format("{} {}\n",
+            seriesName(name + "_sum", labels),
+            static_cast<f64>(histogram.sum()) / 1e6);
+        out += fmt::format("{} {}\n",
+            seriesName(name + "_count", labels), count);
+    }
+
+    return out;
+}
+
+// private member functions
+template <typename T>
+std::shared_ptr<T> Registry::getOrCreate(Family<T> Families::*family,
+                                         const std::string &name,
+                                         const std::string &labels)
+{
+    Key key(name, labels);
+    {
+        auto families = m_families.load();
+        auto it = ((*families).*family).find(key);
+        if (it != ((*families).*family).end())
+        {
+            return it->second;
+        }
+    }
+
+    std::shared_ptr<T> out = nullptr;
+    m_families.update([&](Families &families) -> u8
+    {
+        auto &series = (families.*family)[key];
+        if (!series)
+        {
+            series = std::make_shared<T>();
+        }
+
+        out = series;
+        return 0;
+    });
+
+    return out;
+}
+
+// global functions
+Registry &registry()
+{
+    static Registry instance;
+    return instance;
+}
+
+std::string label(const std::string &key, const std::string &value)
+{
+    std::string out = key + "=\"";
+    out.reserve(out.size() + value.size() + 1);
+    for (auto it = value.begin(); it != value.end(); ++it)
+    {
+        switch (*it)
+        {
+        case '\\':
+            out += "\\\\";
+            break;
+        case '"':
+            out += "\\\"";
+            break;
+        case '\n':
+            out += "\\n";
+            break;
+        default:
+            out += *it;
+            break;
+        }
+    }
+
+    out += "\"";
+    return out;
+}
+
+u64 elapsedUs(const std::chrono::steady_clock::time_point &since)
+{
+    return static_cast<u64>(
+        std::chrono::duration_cast<std::chrono::microseconds>(
+            std::chrono::steady_clock::now() - since).count());
+}
+
+} // end namespace Metrics
+
+} // end namespace Model
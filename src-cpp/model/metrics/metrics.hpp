@@ -0,0 +1,229 @@
+/*
+ * Flex Flow
+ * Copyright (c) 2026-present fdar0536
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#ifndef _MODEL_METRICS_METRICS_HPP_
+#define _MODEL_METRICS_METRICS_HPP_
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <map>
+#include <memory>
+#include <string>
+
+#include "model/defines.h"
+#include "model/snapshot.hpp"
+
+namespace Model
+{
+
+namespace Metrics
+{
+
+/**
+ * @brief monotonic counter
+ */
+class Counter
+{
+public:
+
+    void add(u64 value = 1);
+
+    u64 value() const;
+
+private:
+
+    std::atomic<u64> m_value = 0;
+
+}; // end class Counter
+
+/**
+ * @brief value that can go up and down
+ */
+class Gauge
+{
+public:
+
+    void set(i64 value);
+
+    void add(i64 value);
+
+    i64 value() const;
+
+private:
+
+    std::atomic<i64> m_value = 0;
+
+}; // end class Gauge
+
+/**
+ * @brief log-linear histogram of microseconds
+ *
+ * Every power of two is split into 8 sub-buckets, so the reported
+ * percentiles are within 12.5% of the recorded values.
+ * Values at or above 2^40 us (about 12 days) are clamped.
+ */
+class Histogram
+{
+public:
+
+    static constexpr u32 SUB_BUCKET_BITS = 3;
+
+    static constexpr u32 SUB_BUCKET_COUNT = 1 << SUB_BUCKET_BITS;
+
+    static constexpr u32 MAX_VALUE_BITS = 40;
+
+    static constexpr u32 BUCKET_COUNT =
+        SUB_BUCKET_COUNT * (MAX_VALUE_BITS - SUB_BUCKET_BITS + 1);
+
+    void record(u64 value);
+
+    u64 count() const;
+
+    u64 sum() const;
+
+    u64 max() const;
+
+    /**
+     * @brief estimate the value at the given quantile
+     * @param quantile in range [0, 1]
+     * @return u64 the upper bound of the bucket which holds the quantile
+     */
+    u64 percentile(f64 quantile) const;
+
+    /**
+     * @brief count of the values which are less than bound
+     */
+    u64 countBelow(u64 bound) const;
+
+    static u32 bucketIndex(u64 value);
+
+    static u64 bucketLowerBound(u32 index);
+
+private:
+
+    std::array<std::atomic<u64>, BUCKET_COUNT> m_buckets = {};
+
+    std::atomic<u64> m_count = 0;
+
+    std::atomic<u64> m_sum = 0;
+
+    std::atomic<u64> m_max = 0;
+
+}; // end class Histogram
+
+/**
+ * @brief record the lifetime of this object into a histogram
+ */
+class ScopedTimer
+{
+public:
+
+    explicit ScopedTimer(const std::shared_ptr<Histogram> &histogram);
+
+    ~ScopedTimer();
+
+private:
+
+    Histogram *m_histogram;
+
+    std::chrono::steady_clock::time_point m_start;
+
+}; // end class ScopedTimer
+
+/**
+ * @brief named metrics of the whole process
+ *
+ * A series is identified by its name and its label string,
+ * e.g. ("ff_queue_pending", "queue=\"default\"").
+ * Looking up an existing series does not take any lock.
+ */
+class Registry
+{
+public:
+
+    typedef std::pair<std::string, std::string> Key;
+
+    template <typename T>
+    using Family = std::map<Key, std::shared_ptr<T>>;
+
+    struct Families
+    {
+        Family<Counter> counters;
+
+        Family<Gauge> gauges;
+
+        Family<Histogram> histograms;
+    };
+
+    std::shared_ptr<Counter>
+    counter(const std::string &name, const std::string &labels = "");
+
+    std::shared_ptr<Gauge>
+    gauge(const std::string &name, const std::string &labels = "");
+
+    std::shared_ptr<Histogram>
+    histogram(const std::string &name, const std::string &labels = "");
+
+    /**
+     * @brief remove every series which has exactly these labels
+     */
+    void remove(const std::string &labels);
+
+    std::shared_ptr<const Families> load() const;
+
+    /**
+     * @brief render all series in the Prometheus text format
+     *
+     * Histograms are exported with a "_seconds" suffix.
+     */
+    std::string toPrometheus() const;
+
+private:
+
+    Snapshot<Families> m_families;
+
+    template <typename T>
+    std::shared_ptr<T> getOrCreate(Family<T> Families::*family,
+                                   const std::string &name,
+                                   const std::string &labels);
+
+}; // end class Registry
+
+/**
+ * @brief the registry of this process
+ */
+Registry &registry();
+
+/**
+ * @brief build a label string, e.g. key="value"
+ */
+std::string label(const std::string &key, const std::string &value);
+
+u64 elapsedUs(const std::chrono::steady_clock::time_point &since);
+
+} // end namespace Metrics
+
+} // end namespace Model
+
+#endif // _MODEL_METRICS_METRICS_HPP_
@@ -0,0 +1,330 @@
+/*
+ * Flex Flow
+ * Copyright (c) 2026-present fdar0536
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include <cstdlib>
+#include <fstream>
+#include <sstream>
+
+#include <signal.h>
+
+#include "unistd.h"
+#include "fcntl.h"
+#include "sys/stat.h"
+
+#include "spdlog/spdlog.h"
+
+#include "model/utils.hpp"
+
+#include "cgroup.hpp"
+#include "reactor.hpp"
+
+namespace Model
+{
+
+namespace Proc
+{
+
+typedef struct CgroupConfig
+{
+    // empty means cgroups are not used
+    std::string root = "";
+    std::map<std::string, Cgroup::Limits> limits;
+} CgroupConfig;
+
+// written once by configure before any task starts
+static CgroupConfig &cgroupConfig()
+{
+    static CgroupConfig instance;
+    return instance;
+}
+
+static u8 writeFile(const std::string &path, const std::string &value)
+{
+    int fd = open(path.c_str(), O_WRONLY | O_CLOEXEC);
+    if (fd == -1)
+    {
+        spdlog::error("{}:{} Fail to open {}: {}",
+            LOG_FILE_PATH(__FILE__), __LINE__, path, strerror(errno));
+        return 1;
+    }
+
+    ssize_t ret = write(fd, value.c_str(), value.length());
+    int error = errno;
+    close(fd);
+    if (ret != static_cast<ssize_t>(value.length()))
+    {
+        spdlog::error("{}:{} Fail to write \"{}\" to {}: {}",
+            LOG_FILE_PATH(__FILE__), __LINE__, value, path, strerror(error));
+        return 1;
+    }
+
+    return 0;
+}
+
+// value of "key value" lines, e.g. usage_usec in cpu.stat
+static u64 readKey(const std::string &path, const std::string &key)
+{
+    std::ifstream file(path);
+    std::string name;
+    u64 value(0);
+    while (file >> name >> value)
+    {
+        if (name == key)
+        {
+            return value;
+        }
+    }
+
+    return 0;
+}
+
+static void killLeaf(const std::string &path)
+{
+    // cgroup.kill is there since linux 5.14
+    std::ofstream file(path + "/cgroup.kill");
+    if (file && (file << "1").flush())
+    {
+        return;
+    }
+
+    std::ifstream procs(path + "/cgroup.procs");
+    pid_t pid;
+    while (procs >> pid)
+    {
+        UNUSED(::kill(pid, SIGKILL));
+    }
+}
+
+u8 Cgroup::configure(const std::string &root,
+                     const std::map<std::string, Limits> &limits)
+{
+    FF_DEBUG("{}:{} Cgroup::configure", LOG_FILE_PATH(__FILE__), __LINE__);
+    FF_DEBUG("{}:{} root: {}", LOG_FILE_PATH(__FILE__), __LINE__, root);
+
+    if (root.empty() || root[0] != '/')
+    {
+        spdlog::error("{}:{} cgroup root must be an absolute path",
+            LOG_FILE_PATH(__FILE__), __LINE__);
+        return 1;
+    }
+
+    if (mkdir(root.c_str(), 0755) == -1 && errno != EEXIST)
+    {
+        spdlog::error("{}:{} Fail to create {}: {}",
+            LOG_FILE_PATH(__FILE__), __LINE__, root, strerror(errno));
+        return 1;
+    }
+
+    // the limits of a queue need their controller
+    static const char *controllers[] = {"+cpu", "+memory", "+io"};
+    for (auto controller : controllers)
+    {
+        if (writeFile(root + "/cgroup.subtree_control", controller))
+        {
+            spdlog::warn("{}:{} {} is not enabled under {}, its limits are ignored",
+                LOG_FILE_PATH(__FILE__), __LINE__, controller + 1, root);
+        }
+    }
+
+    CgroupConfig &config = cgroupConfig();
+    config.root = root;
+    config.limits = limits;
+    return 0;
+}
+
+bool Cgroup::isEnabled()
+{
+    return !cgroupConfig().root.empty();
+}
+
+u8 Cgroup::create(const Task &task)
+{
+    FF_DEBUG("{}:{} Cgroup::create", LOG_FILE_PATH(__FILE__), __LINE__);
+
+    m_path.clear();
+    m_procsPath.clear();
+
+    const CgroupConfig &config = cgroupConfig();
+    if (config.root.empty())
+    {
+        return 0;
+    }
+
+    std::string path = fmt::format("{}/{}.{}", config.root,
+        task.queue.empty() ? "task" : task.queue, task.ID);
+    if (mkdir(path.c_str(), 0755) == -1 && errno != EEXIST)
+    {
+        spdlog::error("{}:{} Fail to create {}: {}",
+            LOG_FILE_PATH(__FILE__), __LINE__, path, strerror(errno));
+        return 1;
+    }
+
+    auto it = config.limits.find(task.queue);
+    if (it != config.limits.end() &&
+        ((!it->second.cpuMax.empty() &&
+          writeFile(path + "/cpu.max", it->second.cpuMax)) ||
+         (!it->second.memoryMax.empty() &&
+          writeFile(path + "/memory.max", it->second.memoryMax)) ||
+         (!it->second.ioMax.empty() &&
+          writeFile(path + "/io.max", it->second.ioMax))))
+    {
+        UNUSED(rmdir(path.c_str()));
+        return 1;
+    }
+
+    m_path = path;
+    m_procsPath = path + "/cgroup.procs";
+    return 0;
+}
+
+u8 Cgroup::join()
+{
+    if (m_procsPath.empty())
+    {
+        return 0;
+    }
+
+    int fd = open(m_procsPath.c_str(), O_WRONLY | O_CLOEXEC);
+    if (fd == -1)
+    {
+        return 1;
+    }
+
+    // "0" is the writer itself
+    ssize_t ret = write(fd, "0", 1);
+    close(fd);
+    return ret == 1 ? 0 : 1;
+}
+
+u8 Cgroup::cpuUsage(u64 &out)
+{
+    if (m_path.empty())
+    {
+        return 1;
+    }
+
+    out = readKey(m_path + "/cpu.stat", "usage_usec");
+    return 0;
+}
+
+void Cgroup::usage(Usage &out)
+{
+    FF_DEBUG("{}:{} Cgroup::usage", LOG_FILE_PATH(__FILE__), __LINE__);
+
+    out = Usage();
+    if (m_path.empty())
+    {
+        return;
+    }
+
+    out.cpuUs = readKey(m_path + "/cpu.stat", "usage_usec");
+    std::ifstream peak(m_path + "/memory.peak");
+    if (!(peak >> out.memoryPeakBytes))
+    {
+        out.memoryPeakBytes = 0;
+    }
+
+    // e.g. "8:0 rbytes=1024 wbytes=0 rios=1 wios=0 dbytes=0 dios=0"
+    std::ifstream io(m_path + "/io.stat");
+    std::string line;
+    while (std::getline(io, line))
+    {
+        std::istringstream fields(line);
+        std::string field;
+        while (fields >> field)
+        {
+            if (!field.compare(0, 7, "rbytes="))
+            {
+                out.ioReadBytes += std::strtoull(field.c_str() + 7, nullptr, 10);
+            }
+            else if (!field.compare(0, 7, "wbytes="))
+            {
+                out.ioWriteBytes += std::strtoull(field.c_str() + 7, nullptr, 10);
+            }
+        }
+    }
+}
+
+void Cgroup::kill()
+{
+    FF_DEBUG("{}:{} Cgroup::kill", LOG_FILE_PATH(__FILE__), __LINE__);
+
+    if (!m_path.empty())
+    {
+        killLeaf(m_path);
+    }
+}
+
+void Cgroup::remove()
+{
+    FF_DEBUG("{}:{} Cgroup::remove", LOG_FILE_PATH(__FILE__), __LINE__);
+
+    if (m_path.empty())
+    {
+        return;
+    }
+
+    std::string path = m_path;
+    m_path.clear();
+    m_procsPath.clear();
+    if (!rmdir(path.c_str()))
+    {
+        return;
+    }
+
+    if (errno != EBUSY)
+    {
+        spdlog::error("{}:{} Fail to remove {}: {}",
+            LOG_FILE_PATH(__FILE__), __LINE__, path, strerror(errno));
+        return;
+    }
+
+    // the task has exited, what it left behind goes with it
+    killLeaf(path);
+    removeLater(path, REMOVE_RETRIES);
+}
+
+// private member functions
+void Cgroup::removeLater(const std::string &path, const u32 retries)
+{
+    UNUSED(reactor().schedule(Reactor::TICK_MS, [path, retries]()
+    {
+        if (!rmdir(path.c_str()))
+        {
+            return;
+        }
+
+        if (errno != EBUSY || !retries)
+        {
+            spdlog::warn("{}:{} Fail to remove {}: {}",
+                LOG_FILE_PATH(__FILE__), __LINE__, path, strerror(errno));
+            return;
+        }
+
+        removeLater(path, retries - 1);
+    }));
+}
+
+} // end namespace Proc
+
+} // end namespace Model
@@ -0,0 +1,126 @@
+/*
+ * Flex Flow
+ * Copyright (c) 2026-present fdar0536
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#ifndef _MODEL_PROC_CGROUP_HPP_
+#define _MODEL_PROC_CGROUP_HPP_
+
+#include <map>
+#include <string>
+
+#include "model/defines.h"
+
+#include "task.hpp"
+
+namespace Model
+{
+
+namespace Proc
+{
+
+/**
+ * @brief cgroup v2 leaf of one task
+ *
+ * Leaves are created under a delegated root, e.g. the cgroup of the
+ * service with "Delegate=yes". The root must not hold processes itself,
+ * or the kernel refuses to enable the controllers for its children.
+ */
+class Cgroup
+{
+public:
+
+    typedef struct Limits
+    {
+        // written as they are to cpu.max, memory.max and io.max,
+        // e.g. "200000 100000", "4G", "8:0 wbps=10485760", empty means no limit
+        std::string cpuMax = "";
+        std::string memoryMax = "";
+        std::string ioMax = "";
+    } Limits;
+
+    typedef struct Usage
+    {
+        u64 cpuUs = 0;
+        // 0 if the kernel is older than 5.19
+        u64 memoryPeakBytes = 0;
+        u64 ioReadBytes = 0;
+        u64 ioWriteBytes = 0;
+    } Usage;
+
+    // a busy leaf is removed again after its processes are gone
+    static constexpr u32 REMOVE_RETRIES = 50;
+
+    /**
+     * @brief enable the cpu, memory and io controllers under root,
+     * call it once before any task starts
+     * @param limits queue name to the limits of each of its tasks
+     */
+    static u8 configure(const std::string &root,
+                        const std::map<std::string, Limits> &limits);
+
+    static bool isEnabled();
+
+    /**
+     * @brief create the leaf of the task with the limits of its queue,
+     * it does nothing if cgroups are not configured
+     */
+    u8 create(const Task &task);
+
+    /**
+     * @brief move the calling process into the leaf, for the forked child
+     */
+    u8 join();
+
+    void usage(Usage &out);
+
+    /**
+     * @brief usage_usec of the leaf, cheap enough to poll
+     * @return non-zero if the task has no leaf
+     */
+    u8 cpuUsage(u64 &out);
+
+    /**
+     * @brief kill every process in the leaf, the grandchildren too
+     */
+    void kill();
+
+    /**
+     * @brief kill what is left in the leaf and remove it
+     */
+    void remove();
+
+private:
+
+    std::string m_path = "";
+
+    // opened by the child, so it does not allocate after fork
+    std::string m_procsPath = "";
+
+    static void removeLater(const std::string &path, const u32 retries);
+
+}; // end class Cgroup
+
+} // end namespace Proc
+
+} // end namespace Model
+
+#endif // _MODEL_PROC_CGROUP_HPP_
@@ -40,6 +40,10 @@ public:
 
     virtual u8 start(const Task &task) = 0;
 
+    /**
+     * @brief ask the process to exit and return at once,
+     * it is killed if it does not exit in time, isRunning tells when it is gone
+     */
     virtual void stop() = 0;
 
     virtual bool isRunning() = 0;
@@ -48,6 +52,26 @@ public:
 
     virtual u8 exitCode(i32 &out) = 0;
 
+    /**
+     * @brief pause the running process, it keeps its memory
+     *
+     * The wall-clock limit of the task is paused with it.
+     */
+    virtual u8 suspend() = 0;
+
+    virtual u8 resume() = 0;
+
+    /**
+     * @brief whether the last process was ended for exceeding its time limit
+     */
+    virtual bool isTimedOut() = 0;
+
+    /**
+     * @brief fill the resources the last process used into out,
+     * the fields which the platform does not measure are left as they are
+     */
+    virtual void usage(Task &out) = 0;
+
 }; // end class IProc
 
 } // end namespace Proc
@@ -30,6 +30,7 @@
 
 #include "spdlog/spdlog.h"
 
+#include "model/metrics/metrics.hpp"
 #include "model/utils.hpp"
 
 #include "linuxproc.hpp"
@@ -47,12 +48,32 @@ LinuxProc::LinuxProc() :
 LinuxProc::~LinuxProc()
 {
     stopImpl();
+
+    // the read loop uses the members of this class
+    if (m_thread.joinable())
+    {
+        m_thread.join();
+    }
+}
+
+void LinuxProc::usage(Task &out)
+{
+    PosixProc::usage(out);
+    if (!Cgroup::isEnabled())
+    {
+        return;
+    }
+
+    out.cpuUsageUs = m_usage.cpuUs;
+    out.memoryPeakBytes = m_usage.memoryPeakBytes;
+    out.ioReadBytes = m_usage.ioReadBytes;
+    out.ioWriteBytes = m_usage.ioWriteBytes;
 }
 
 // protected member functions
 u8 LinuxProc::asioInit()
 {
-    spdlog::debug("{}:{} LinuxProc::asioInit", LOG_FILE_PATH(__FILE__), __LINE__);
+    FF_DEBUG("{}:{} LinuxProc::asioInit", LOG_FILE_PATH(__FILE__), __LINE__);
 
     if (epollInit())
     {
@@ -68,16 +89,21 @@ u8 LinuxProc::asioInit()
 
 void LinuxProc::asioFin()
 {
-    spdlog::debug("{}:{} LinuxProc::asioFin", LOG_FILE_PATH(__FILE__), __LINE__);
+    FF_DEBUG("{}:{} LinuxProc::asioFin", LOG_FILE_PATH(__FILE__), __LINE__);
 
     return epollFin();
 }
 
 void LinuxProc::readOutputLoop()
 {
-    spdlog::debug("{}:{} LinuxProc::readOutputLoop",
+    FF_DEBUG("{}:{} LinuxProc::readOutputLoop",
         LOG_FILE_PATH(__FILE__), __LINE__);
 
+    static auto outputBytes =
+        Metrics::registry().counter("ff_proc_output_bytes_total");
+    static auto droppedChunks =
+        Metrics::registry().counter("ff_proc_output_dropped_total");
+
     ssize_t count(0);
     while(1)
     {
@@ -97,9 +123,10 @@ void LinuxProc::readOutputLoop()
                 (m_events[i].events & EPOLLIN))
             {
                 std::string buf;
-                buf.resize(FF_READ_BUFFER_SIZE);
                 while (1)
                 {
+                    // buf is moved into the deque after each read
+                    buf.resize(FF_READ_BUFFER_SIZE);
                     count = read(m_events[i].data.fd, buf.data(), buf.size());
                     if (count == -1)
                     {
@@ -112,7 +139,7 @@ void LinuxProc::readOutputLoop()
                         if (errno == EINTR)
                         {
                             // read again
-                            spdlog::debug("{}:{} {}", LOG_FILE_PATH(__FILE__), __LINE__, strerror(errno));
+                            FF_DEBUG("{}:{} {}", LOG_FILE_PATH(__FILE__), __LINE__, strerror(errno));
                             continue;
                         }
                         else
@@ -125,18 +152,20 @@ void LinuxProc::readOutputLoop()
                     else if (count == 0)
                     {
                         // pipe is closed or child process is exited
-                        spdlog::debug("{}:{} {}",
+                        FF_DEBUG("{}:{} {}",
                             LOG_FILE_PATH(__FILE__), __LINE__, "Nothing to read");
                         return;
                     }
                     else // count != 0
                     {
                         buf.resize(count);
+                        outputBytes->add(static_cast<u64>(count));
                         {
                             std::unique_lock<std::mutex> lock(m_mutex);
                             if (m_deque.size() >= FF_MAX_READ_QUEUE_SIZE)
                             {
                                 m_deque.pop_front();
+                                droppedChunks->add();
                             }
 
                             m_deque.push_back(std::move(buf));
@@ -149,7 +178,7 @@ void LinuxProc::readOutputLoop()
             // others error
             if (m_events[i].events & (EPOLLHUP | EPOLLERR))
             {
-                spdlog::debug("{}:{} Epoll HUP/ERR on fd {}",
+                FF_DEBUG("{}:{} Epoll HUP/ERR on fd {}",
                     LOG_FILE_PATH(__FILE__), __LINE__,
                     static_cast<int>(m_events[i].data.fd));
                 return;
@@ -158,10 +187,41 @@ void LinuxProc::readOutputLoop()
     } // end while(1)
 }
 
+u8 LinuxProc::beforeStart(const Task &task)
+{
+    FF_DEBUG("{}:{} LinuxProc::beforeStart", LOG_FILE_PATH(__FILE__), __LINE__);
+
+    m_usage = Cgroup::Usage();
+    return m_cgroup.create(task);
+}
+
+u8 LinuxProc::childInit()
+{
+    return m_cgroup.join();
+}
+
+void LinuxProc::killTree()
+{
+    m_cgroup.kill();
+}
+
+void LinuxProc::afterReap()
+{
+    FF_DEBUG("{}:{} LinuxProc::afterReap", LOG_FILE_PATH(__FILE__), __LINE__);
+
+    m_cgroup.usage(m_usage);
+    m_cgroup.remove();
+}
+
+u8 LinuxProc::cpuUsage(u64 &out)
+{
+    return m_cgroup.cpuUsage(out);
+}
+
 // private member functions
 u8 LinuxProc::epollInit()
 {
-    spdlog::debug("{}:{} LinuxProc::epollInit", LOG_FILE_PATH(__FILE__), __LINE__);
+    FF_DEBUG("{}:{} LinuxProc::epollInit", LOG_FILE_PATH(__FILE__), __LINE__);
 
     m_epoll_fd = epoll_create1(0);
     if (m_epoll_fd == -1)
@@ -184,7 +244,7 @@ u8 LinuxProc::epollInit()
 
 void LinuxProc::epollFin()
 {
-    spdlog::debug("{}:{} LinuxProc::epollFin", LOG_FILE_PATH(__FILE__), __LINE__);
+    FF_DEBUG("{}:{} LinuxProc::epollFin", LOG_FILE_PATH(__FILE__), __LINE__);
 
     closeFile(&m_epoll_fd);
     closeFile(&m_masterFD);
@@ -26,6 +26,7 @@
 
 #include "sys/epoll.h"
 
+#include "cgroup.hpp"
 #include "posixproc.hpp"
 
 namespace Model
@@ -42,6 +43,8 @@ public:
 
     ~LinuxProc();
 
+    virtual void usage(Task &out) override;
+
 protected:
 
     virtual u8 asioInit() override;
@@ -50,6 +53,16 @@ protected:
 
     virtual void readOutputLoop() override;
 
+    virtual u8 beforeStart(const Task &) override;
+
+    virtual u8 childInit() override;
+
+    virtual void killTree() override;
+
+    virtual void afterReap() override;
+
+    virtual u8 cpuUsage(u64 &out) override;
+
 private:
 
     // epoll
@@ -57,6 +70,11 @@ private:
 
     int m_epoll_fd = -1;
 
+    // the leaf of the running task, and what the last one used
+    Cgroup m_cgroup;
+
+    Cgroup::Usage m_usage;
+
     u8 epollInit();
 
     void epollFin();
@@ -45,12 +45,18 @@ MacProc::MacProc():
 MacProc::~MacProc()
 {
     stopImpl();
+
+    // the read loop uses the members of this class
+    if (m_thread.joinable())
+    {
+        m_thread.join();
+    }
 }
 
 // protected member functions
 u8 MacProc::asioInit()
 {
-    spdlog::debug("{}:{} MacProc::asioInit", LOG_FILE_PATH(__FILE__), __LINE__);
+    FF_DEBUG("{}:{} MacProc::asioInit", LOG_FILE_PATH(__FILE__), __LINE__);
 
     m_kqueue = kqueue();
     if (m_kqueue == -1)
@@ -67,7 +73,7 @@ u8 MacProc::asioInit()
 
 void MacProc::asioFin()
 {
-    spdlog::debug("{}:{} MacProc::asioFin", LOG_FILE_PATH(__FILE__), __LINE__);
+    FF_DEBUG("{}:{} MacProc::asioFin", LOG_FILE_PATH(__FILE__), __LINE__);
 
     closeFile(&m_masterFD);
     closeFile(&m_kqueue);
@@ -75,7 +81,7 @@ void MacProc::asioFin()
 
 void MacProc::readOutputLoop()
 {
-    spdlog::debug("{}:{} MacProc::readOutputLoop",
+    FF_DEBUG("{}:{} MacProc::readOutputLoop",
         LOG_FILE_PATH(__FILE__), __LINE__);
 
     while (1)
@@ -21,13 +21,16 @@
  * SOFTWARE.
  */
 
+#include <cstring>
+
 #include <signal.h>
 
 #include "unistd.h"
 #include "fcntl.h"
+#include "sys/resource.h"
+#include "sys/wait.h"
 
 #ifdef __linux__
-#include "sys/wait.h"
 #include "pty.h"
 #else
 #include "util.h"
@@ -49,18 +52,23 @@ namespace Proc
 // implement public member functions
 PosixProc::PosixProc()
 {
-    spdlog::debug("{}:{} PosixProc::PosixProc", LOG_FILE_PATH(__FILE__), __LINE__);
+    FF_DEBUG("{}:{} PosixProc::PosixProc", LOG_FILE_PATH(__FILE__), __LINE__);
     m_pid = 0;
     m_exitCode.store(0, std::memory_order_relaxed);
+    m_isTimedOut.store(false, std::memory_order_relaxed);
+    memset(&m_rusage, 0, sizeof(m_rusage));
     m_deque.clear();
 }
 
 PosixProc::~PosixProc()
-{}
+{
+    // the callbacks hold this
+    cancelTimers();
+}
 
 u8 PosixProc::start(const Task &task)
 {
-    spdlog::debug("{}:{} PosixProc::start", LOG_FILE_PATH(__FILE__), __LINE__);
+    FF_DEBUG("{}:{} PosixProc::start", LOG_FILE_PATH(__FILE__), __LINE__);
 
     if (isRunning())
     {
@@ -76,13 +84,27 @@ u8 PosixProc::start(const Task &task)
 
     m_masterFD = -1;
     m_exitCode.store(0, std::memory_order_relaxed);
+    m_isTimedOut.store(false, std::memory_order_relaxed);
+    memset(&m_rusage, 0, sizeof(m_rusage));
 
+    if (beforeStart(task))
+    {
+        return 1;
+    }
+
+    u64 usedUs(0);
+    m_cpuLimitUs = static_cast<u64>(task.cpuTimeoutSec) * 1000000;
+    m_isCpuPolled = m_cpuLimitUs && !cpuUsage(usedUs);
+
+    std::unique_lock<std::mutex> signalLock(m_signalMutex);
     m_pid = forkpty(&m_masterFD, NULL, NULL, NULL);
     if (m_pid == -1)
     {
         // parent process
         spdlog::error("{}:{} {}",
             LOG_FILE_PATH(__FILE__), __LINE__, strerror(errno));
+        signalLock.unlock();
+        afterReap();
         return 1;
     }
 
@@ -92,6 +114,20 @@ u8 PosixProc::start(const Task &task)
         startChild(task);
     }
 
+    m_isReaped = false;
+    m_wallRemainingMs = 0;
+    if (task.wallTimeoutSec)
+    {
+        armTimeoutLocked(static_cast<u64>(task.wallTimeoutSec) * 1000);
+    }
+
+    if (m_isCpuPolled)
+    {
+        armCpuPollLocked(usedUs);
+    }
+
+    signalLock.unlock();
+
     int fileFlag = fcntl(m_masterFD, F_GETFL, 0);
     if (fileFlag == -1)
     {
@@ -114,19 +150,48 @@ u8 PosixProc::start(const Task &task)
 
 void PosixProc::stop()
 {
-    stopImpl();
+    FF_DEBUG("{}:{} PosixProc::stop", LOG_FILE_PATH(__FILE__), __LINE__);
+
+    // isRunning reaps it, the reactor escalates meanwhile
+    std::unique_lock<std::mutex> lock(m_signalMutex);
+    if (m_isReaped) return;
+    terminateLocked();
 }
 
 bool PosixProc::isRunning()
 {
-    spdlog::debug("{}:{} PosixProc::isRunning", LOG_FILE_PATH(__FILE__), __LINE__);
+    FF_DEBUG("{}:{} PosixProc::isRunning", LOG_FILE_PATH(__FILE__), __LINE__);
 
     int status;
-    pid_t ret = waitpid(m_pid, &status, WNOHANG);
+    pid_t ret(0);
+    bool isReaped(false);
+    {
+        std::unique_lock<std::mutex> lock(m_signalMutex);
+        isReaped = m_isReaped;
+        if (!isReaped)
+        {
+            ret = wait4(m_pid, &status, WNOHANG, &m_rusage);
+            if (ret)
+            {
+                m_isReaped = true;
+            }
+        }
+    }
+
+    // never started, or stopImpl has reaped it,
+    // wait4 would take a child of another process
+    if (isReaped)
+    {
+        asioFin();
+        return false;
+    }
+
     if (ret == -1)
     {
-        spdlog::debug("{}:{} {}",
+        FF_DEBUG("{}:{} {}",
             LOG_FILE_PATH(__FILE__), __LINE__, strerror(errno));
+        afterReap();
+        cancelTimers();
         asioFin();
         return false;
     }
@@ -140,13 +205,16 @@ bool PosixProc::isRunning()
         m_exitCode.store(status, std::memory_order_relaxed);
     }
 
+    afterReap();
+    checkCpuRlimit(status);
+    cancelTimers();
     asioFin();
     return false;
 }
 
 void PosixProc::readCurrentOutput(std::vector<std::string> &out)
 {
-    spdlog::debug("{}:{} PosixProc::readCurrentOutput",
+    FF_DEBUG("{}:{} PosixProc::readCurrentOutput",
         LOG_FILE_PATH(__FILE__), __LINE__);
 
     out.clear();
@@ -156,7 +224,7 @@ void PosixProc::readCurrentOutput(std::vector<std::string> &out)
 
         if (m_deque.empty())
         {
-            spdlog::debug("{}:{} nothing to read",
+            FF_DEBUG("{}:{} nothing to read",
                 LOG_FILE_PATH(__FILE__), __LINE__);
             return;
         }
@@ -172,7 +240,7 @@ void PosixProc::readCurrentOutput(std::vector<std::string> &out)
 
 u8 PosixProc::exitCode(i32 &out)
 {
-    spdlog::debug("{}:{} PosixProc::exitCode", LOG_FILE_PATH(__FILE__), __LINE__);
+    FF_DEBUG("{}:{} PosixProc::exitCode", LOG_FILE_PATH(__FILE__), __LINE__);
 
     if (isRunning())
     {
@@ -184,10 +252,129 @@ u8 PosixProc::exitCode(i32 &out)
     return 0;
 }
 
+u8 PosixProc::suspend()
+{
+    FF_DEBUG("{}:{} PosixProc::suspend", LOG_FILE_PATH(__FILE__), __LINE__);
+
+    // the pid may be reused once it is reaped
+    std::unique_lock<std::mutex> lock(m_signalMutex);
+    if (m_isReaped)
+    {
+        FF_DEBUG("{}:{} Process is reaped", LOG_FILE_PATH(__FILE__), __LINE__);
+        return 1;
+    }
+
+    // forkpty makes the child a session leader,
+    // so the whole process group is stopped
+    if (kill(-m_pid, SIGSTOP) == -1)
+    {
+        spdlog::error("{}:{} {}",
+            LOG_FILE_PATH(__FILE__), __LINE__, strerror(errno));
+        return 1;
+    }
+
+    // pause the wall-clock limit, resume() arms it with what is left
+    Reactor::TimerID timeoutTimer(m_timeoutTimer);
+    if (timeoutTimer)
+    {
+        auto now = std::chrono::steady_clock::now();
+        m_wallRemainingMs = m_wallDeadline > now ?
+            static_cast<u64>(std::chrono::duration_cast<std::chrono::milliseconds>(
+                m_wallDeadline - now).count()) : 0;
+        if (!m_wallRemainingMs)
+        {
+            m_wallRemainingMs = 1;
+        }
+
+        m_timeoutTimer = 0;
+    }
+
+    // not under m_signalMutex, onTimeout takes it
+    lock.unlock();
+    if (timeoutTimer) reactor().cancel(timeoutTimer);
+    return 0;
+}
+
+u8 PosixProc::resume()
+{
+    FF_DEBUG("{}:{} PosixProc::resume", LOG_FILE_PATH(__FILE__), __LINE__);
+
+    std::unique_lock<std::mutex> lock(m_signalMutex);
+    if (m_isReaped)
+    {
+        FF_DEBUG("{}:{} Process is reaped", LOG_FILE_PATH(__FILE__), __LINE__);
+        return 1;
+    }
+
+    if (kill(-m_pid, SIGCONT) == -1)
+    {
+        spdlog::error("{}:{} {}",
+            LOG_FILE_PATH(__FILE__), __LINE__, strerror(errno));
+        return 1;
+    }
+
+    if (m_wallRemainingMs)
+    {
+        armTimeoutLocked(m_wallRemainingMs);
+        m_wallRemainingMs = 0;
+    }
+
+    return 0;
+}
+
+bool PosixProc::isTimedOut()
+{
+    return m_isTimedOut.load(std::memory_order_relaxed);
+}
+
+void PosixProc::usage(Task &out)
+{
+    out.userTimeUs = static_cast<u64>(m_rusage.ru_utime.tv_sec) * 1000000 +
+                     static_cast<u64>(m_rusage.ru_utime.tv_usec);
+    out.systemTimeUs = static_cast<u64>(m_rusage.ru_stime.tv_sec) * 1000000 +
+                       static_cast<u64>(m_rusage.ru_stime.tv_usec);
+#ifdef __APPLE__
+    // bytes on macOS
+    out.maxRssKB = static_cast<u64>(m_rusage.ru_maxrss) / 1024;
+#else
+    out.maxRssKB = static_cast<u64>(m_rusage.ru_maxrss);
+#endif
+    out.majorFaults = static_cast<u64>(m_rusage.ru_majflt);
+    out.minorFaults = static_cast<u64>(m_rusage.ru_minflt);
+}
+
 // protected member function
 void PosixProc::startChild(const Task &task)
 {
-    spdlog::debug("{}:{} PosixProc::startChild", LOG_FILE_PATH(__FILE__), __LINE__);
+    FF_DEBUG("{}:{} PosixProc::startChild", LOG_FILE_PATH(__FILE__), __LINE__);
+
+    if (childInit())
+    {
+        spdlog::error("{}:{} {}",
+            LOG_FILE_PATH(__FILE__), __LINE__, strerror(errno));
+        exit(1);
+    }
+
+    // without a poller SIGXCPU at the limit, SIGKILL after the grace time,
+    // every process of the task has its own count
+    if (task.cpuTimeoutSec && !m_isCpuPolled)
+    {
+        struct rlimit limit;
+        limit.rlim_cur = task.cpuTimeoutSec;
+        limit.rlim_max = task.cpuTimeoutSec + (KILL_GRACE_MS + 999) / 1000;
+
+        // SIGXCPU dumps core by default
+        struct rlimit core;
+        core.rlim_cur = 0;
+        core.rlim_max = 0;
+        if (setrlimit(RLIMIT_CPU, &limit) == -1 ||
+            setrlimit(RLIMIT_CORE, &core) == -1)
+        {
+            spdlog::error("{}:{} {}",
+                LOG_FILE_PATH(__FILE__), __LINE__, strerror(errno));
+            exit(1);
+        }
+    }
 
     if (chdir(task.workDir.c_str()) == -1)
     {
@@ -216,7 +403,7 @@ void PosixProc::startChild(const Task &task)
 
 char **PosixProc::buildChildArgv(const Task &task)
 {
-    spdlog::debug("{}:{} PosixProc::buildChildArgv",
+    FF_DEBUG("{}:{} PosixProc::buildChildArgv",
         LOG_FILE_PATH(__FILE__), __LINE__);
 
     char **argv(nullptr);
@@ -290,53 +477,211 @@ char **PosixProc::buildChildArgv(const Task &task)
 
 void PosixProc::stopImpl()
 {
-    spdlog::debug("{}:{} PosixProc::stopImpl", LOG_FILE_PATH(__FILE__), __LINE__);
+    FF_DEBUG("{}:{} PosixProc::stopImpl", LOG_FILE_PATH(__FILE__), __LINE__);
 
-    if (!isRunning()) return;
-    
-    if (kill(m_pid, SIGTERM) == -1)
     {
-        spdlog::error("sent sigterm failed: {}", strerror(errno));
-        return;
+        std::unique_lock<std::mutex> lock(m_signalMutex);
+        if (m_isReaped) return;
+        terminateLocked();
     }
 
-    int status;
-    int timeout_ms = 2000;
-    int elapsed = 0;
-    int interval = 100;
+    // the kill timer sends sigkill if it does not exit in time,
+    // WNOWAIT keeps the pid ours until it is reaped under m_signalMutex
+    siginfo_t info;
+    int ret(0), status(0);
+    do
+    {
+        ret = waitid(P_PID, m_pid, &info, WEXITED | WNOWAIT);
+    } while (ret == -1 && errno == EINTR);
 
-    bool exited = false;
-    while (elapsed < timeout_ms)
     {
-        pid_t result = waitpid(m_pid, &status, WNOHANG);
-        
-        if (result == m_pid)
+        std::unique_lock<std::mutex> lock(m_signalMutex);
+        if (m_isReaped)
         {
-            exited = true;
-            break;
+            // isRunning has reaped it
+            return;
         }
-        else if (result == -1)
+
+        if (wait4(m_pid, &status, WNOHANG, &m_rusage) == m_pid &&
+            (WIFEXITED(status) || WIFSIGNALED(status)))
         {
-            spdlog::error("waitpid error: {}", strerror(errno));
-            break;
+            m_exitCode.store(status, std::memory_order_relaxed);
         }
 
-        std::this_thread::sleep_for(std::chrono::milliseconds(interval));
-        elapsed += interval;
+        m_isReaped = true;
     }
 
-    // timeout, send sigkill
-    if (!exited) {
-        spdlog::warn("Child process {} cannot stop in {}ms, send sigkill",
-            m_pid, timeout_ms);
-        kill(m_pid, SIGKILL);
-        waitpid(m_pid, &status, 0);
+    afterReap();
+    checkCpuRlimit(status);
+
+    cancelTimers();
+}
+
+void PosixProc::armTimeoutLocked(const u64 delayMs)
+{
+    m_wallDeadline = std::chrono::steady_clock::now() +
+        std::chrono::milliseconds(delayMs);
+    m_timeoutTimer = reactor().schedule(delayMs, [this]()
+    {
+        onTimeout();
+    });
+}
+
+void PosixProc::onTimeout()
+{
+    std::unique_lock<std::mutex> lock(m_signalMutex);
+    m_timeoutTimer = 0;
+    if (m_isReaped)
+    {
+        return;
+    }
+
+    spdlog::warn("{}:{} process {} is out of time, terminate it",
+        LOG_FILE_PATH(__FILE__), __LINE__, m_pid);
+    m_isTimedOut.store(true, std::memory_order_relaxed);
+    terminateLocked();
+}
+
+void PosixProc::armCpuPollLocked(const u64 usedUs)
+{
+    // poll again when the limit may be reached, at least every CPU_POLL_MS
+    u64 delayMs = (m_cpuLimitUs - usedUs + 999) / 1000;
+    if (delayMs > CPU_POLL_MS)
+    {
+        delayMs = CPU_POLL_MS;
+    }
+
+    m_cpuTimer = reactor().schedule(delayMs, [this]()
+    {
+        onCpuPoll();
+    });
+}
+
+void PosixProc::onCpuPoll()
+{
+    std::unique_lock<std::mutex> lock(m_signalMutex);
+    m_cpuTimer = 0;
+    if (m_isReaped)
+    {
+        return;
+    }
+
+    u64 usedUs(0);
+    if (cpuUsage(usedUs))
+    {
+        return;
+    }
+
+    if (usedUs < m_cpuLimitUs)
+    {
+        armCpuPollLocked(usedUs);
+        return;
+    }
+
+    spdlog::warn("{}:{} process {} is out of cpu time, terminate it",
+        LOG_FILE_PATH(__FILE__), __LINE__, m_pid);
+    m_isTimedOut.store(true, std::memory_order_relaxed);
+    terminateLocked();
+}
+
+void PosixProc::checkCpuRlimit(const int status)
+{
+    if (!m_cpuLimitUs || m_isCpuPolled || !WIFSIGNALED(status))
+    {
+        return;
+    }
+
+    // SIGKILL at the hard limit if it ignores or handles SIGXCPU
+    u64 usedUs = static_cast<u64>(m_rusage.ru_utime.tv_sec) * 1000000 +
+                 static_cast<u64>(m_rusage.ru_utime.tv_usec) +
+                 static_cast<u64>(m_rusage.ru_stime.tv_sec) * 1000000 +
+                 static_cast<u64>(m_rusage.ru_stime.tv_usec);
+    if (WTERMSIG(status) == SIGXCPU ||
+        (WTERMSIG(status) == SIGKILL && usedUs >= m_cpuLimitUs))
+    {
+        m_isTimedOut.store(true, std::memory_order_relaxed);
+    }
+}
+
+void PosixProc::terminateLocked()
+{
+    FF_DEBUG("{}:{} PosixProc::terminateLocked", LOG_FILE_PATH(__FILE__), __LINE__);
+
+    // ESRCH if it has exited but is not reaped yet
+    if (kill(-m_pid, SIGTERM) == -1 && errno != ESRCH)
+    {
+        spdlog::error("{}:{} {}",
+            LOG_FILE_PATH(__FILE__), __LINE__, strerror(errno));
+    }
+
+    // a suspended process handles sigterm only after it continues
+    kill(-m_pid, SIGCONT);
+    if (m_killTimer)
+    {
+        return;
+    }
+
+    m_killTimer = reactor().schedule(KILL_GRACE_MS, [this]()
+    {
+        std::unique_lock<std::mutex> lock(m_signalMutex);
+        m_killTimer = 0;
+        if (m_isReaped)
+        {
+            return;
+        }
+
+        spdlog::warn("{}:{} process {} cannot stop in {}ms, send sigkill",
+            LOG_FILE_PATH(__FILE__), __LINE__, m_pid, KILL_GRACE_MS);
+        kill(-m_pid, SIGKILL);
+        killTree();
+    });
+}
+
+void PosixProc::cancelTimers()
+{
+    // not under m_signalMutex, the callbacks take it
+    Reactor::TimerID timeoutTimer(0), killTimer(0), cpuTimer(0);
+    {
+        std::unique_lock<std::mutex> lock(m_signalMutex);
+        timeoutTimer = m_timeoutTimer;
+        killTimer = m_killTimer;
+        cpuTimer = m_cpuTimer;
+        m_timeoutTimer = 0;
+        m_killTimer = 0;
+        m_cpuTimer = 0;
     }
+
+    if (timeoutTimer) reactor().cancel(timeoutTimer);
+    if (killTimer) reactor().cancel(killTimer);
+    if (cpuTimer) reactor().cancel(cpuTimer);
+}
+
+u8 PosixProc::beforeStart(const Task &task)
+{
+    UNUSED(task);
+    return 0;
+}
+
+u8 PosixProc::childInit()
+{
+    return 0;
+}
+
+void PosixProc::killTree()
+{}
+
+void PosixProc::afterReap()
+{}
+
+u8 PosixProc::cpuUsage(u64 &out)
+{
+    UNUSED(out);
+    return 1;
 }
 
 void PosixProc::closeFile(int *fd)
 {
-    spdlog::debug("{}:{} PosixProc::closeFile", LOG_FILE_PATH(__FILE__), __LINE__);
+    FF_DEBUG("{}:{} PosixProc::closeFile", LOG_FILE_PATH(__FILE__), __LINE__);
 
     if (*fd != -1)
     {
@@ -25,11 +25,15 @@
 #define _MODEL_PROC_POSIXPROC_HPP_
 
 #include <atomic>
+#include <chrono>
 #include <deque>
 #include <mutex>
 #include <thread>
 
+#include "sys/resource.h"
+
 #include "iproc.hpp"
+#include "reactor.hpp"
 
 namespace Model
 {
@@ -55,6 +59,20 @@ public:
 
     virtual u8 exitCode(i32 &out) override;
 
+    virtual u8 suspend() override;
+
+    virtual u8 resume() override;
+
+    virtual bool isTimedOut() override;
+
+    virtual void usage(Task &out) override;
+
+    // time between SIGTERM and SIGKILL
+    static constexpr u32 KILL_GRACE_MS = 2000;
+
+    // how often the cpu time of a task with a cpu limit is read
+    static constexpr u32 CPU_POLL_MS = 1000;
+
 protected:
 
     pid_t m_pid = 0;
@@ -63,10 +81,59 @@ protected:
 
     std::atomic<i32> m_exitCode;
 
+    std::atomic<bool> m_isTimedOut;
+
+    // of the last process and the descendants it has waited for,
+    // written when it is reaped
+    struct rusage m_rusage;
+
+    // guards m_isReaped and the timers, so no signal is sent
+    // after the pid is reaped and may be reused
+    std::mutex m_signalMutex;
+
+    bool m_isReaped = true;
+
+    Reactor::TimerID m_timeoutTimer = 0;
+
+    // the wall-clock limit does not run while the task is suspended,
+    // m_wallRemainingMs is the budget left, 0 unless it is paused
+    std::chrono::steady_clock::time_point m_wallDeadline;
+
+    u64 m_wallRemainingMs = 0;
+
+    Reactor::TimerID m_killTimer = 0;
+
+    // the cpu limit is polled if cpuUsage can measure the whole task,
+    // otherwise each process gets RLIMIT_CPU
+    u64 m_cpuLimitUs = 0;
+
+    bool m_isCpuPolled = false;
+
+    Reactor::TimerID m_cpuTimer = 0;
+
+    // call it with m_signalMutex
+    void armTimeoutLocked(const u64 delayMs);
+
+    void onTimeout();
+
+    // call it with m_signalMutex
+    void armCpuPollLocked(const u64 usedUs);
+
+    void onCpuPoll();
+
+    // the rlimit fallback, call it after the process is reaped
+    void checkCpuRlimit(const int status);
+
+    // SIGTERM now, SIGKILL after KILL_GRACE_MS, call it with m_signalMutex
+    void terminateLocked();
+
+    void cancelTimers();
+
     void startChild(const Task &);
 
     char **buildChildArgv(const Task &);
 
+    // stop and wait until it is reaped, for the destructors
     void stopImpl();
 
     void closeFile(int *);
@@ -82,6 +149,23 @@ protected:
 
     virtual void readOutputLoop() = 0;
 
+    // hooks of the platforms, nothing by default
+
+    // before fork, non-zero refuses to start
+    virtual u8 beforeStart(const Task &);
+
+    // in the child before exec, non-zero ends the child
+    virtual u8 childInit();
+
+    // after SIGKILL is sent, for the processes out of the process group
+    virtual void killTree();
+
+    // after the process is reaped
+    virtual void afterReap();
+
+    // cpu time of every process of the task, non-zero if it cannot be measured
+    virtual u8 cpuUsage(u64 &out);
+
     // for reading current output
     std::jthread m_thread;
 };
@@ -0,0 +1,197 @@
+/*
+ * Flex Flow
+ * Copyright (c) 2026-present fdar0536
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+#include <chrono>
+#include <vector>
+
+#include "spdlog/spdlog.h"
+
+#include "model/utils.hpp"
+
+#include "reactor.hpp"
+
+namespace Model
+{
+
+namespace Proc
+{
+
+Reactor::Reactor()
+{
+    m_thread = std::jthread([this](std::stop_token token)
+    {
+        run(token);
+    });
+}
+
+Reactor::~Reactor()
+{
+    m_thread.request_stop();
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_cv.notify_all();
+    }
+}
+
+Reactor::TimerID Reactor::schedule(const u64 delayMs, Callback callback)
+{
+    FF_DEBUG("{}:{} Reactor::schedule", LOG_FILE_PATH(__FILE__), __LINE__);
+    FF_DEBUG("{}:{} delayMs: {}", LOG_FILE_PATH(__FILE__), __LINE__, delayMs);
+
+    u64 ticks = (delayMs + TICK_MS - 1) / TICK_MS;
+    if (!ticks) ticks = 1;
+
+    TimerID id(0);
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        id = m_nextID++;
+        u32 slot = static_cast<u32>((m_cursor + ticks) % WHEEL_SIZE);
+        m_wheel[slot].push_back(Timer{id, (ticks - 1) / WHEEL_SIZE, std::move(callback)});
+        m_slots[id] = slot;
+    }
+
+    // the thread sleeps while there is no timer
+    m_cv.notify_all();
+    return id;
+}
+
+void Reactor::cancel(const TimerID id)
+{
+    FF_DEBUG("{}:{} Reactor::cancel", LOG_FILE_PATH(__FILE__), __LINE__);
+
+    std::unique_lock<std::mutex> lock(m_mutex);
+    auto it = m_slots.find(id);
+    if (it != m_slots.end())
+    {
+        std::list<Timer> &slot = m_wheel[it->second];
+        for (auto timer = slot.begin(); timer != slot.end(); ++timer)
+        {
+            if (timer->ID == id)
+            {
+                slot.erase(timer);
+                break;
+            }
+        }
+
+        m_slots.erase(it);
+        return;
+    }
+
+    if (m_due.erase(id))
+    {
+        return;
+    }
+
+    m_cv.wait(lock, [&]() -> bool
+    {
+        return m_firing != id;
+    });
+}
+
+// private member functions
+void Reactor::run(std::stop_token token)
+{
+    FF_DEBUG("{}:{} Reactor::run", LOG_FILE_PATH(__FILE__), __LINE__);
+
+    auto nextTick = std::chrono::steady_clock::now();
+    std::vector<Timer> due;
+    while (!token.stop_requested())
+    {
+        {
+            std::unique_lock<std::mutex> lock(m_mutex);
+            if (m_slots.empty())
+            {
+                m_cv.wait(lock, [&]() -> bool
+                {
+                    return !m_slots.empty() || token.stop_requested();
+                });
+
+                // the first tick is a full one after the timer is scheduled
+                nextTick = std::chrono::steady_clock::now();
+            }
+
+            nextTick += std::chrono::milliseconds(TICK_MS);
+            m_cv.wait_until(lock, nextTick, [&]() -> bool
+            {
+                return token.stop_requested();
+            });
+
+            if (token.stop_requested())
+            {
+                break;
+            }
+
+            m_cursor = (m_cursor + 1) % WHEEL_SIZE;
+            std::list<Timer> &slot = m_wheel[m_cursor];
+            for (auto it = slot.begin(); it != slot.end();)
+            {
+                if (it->rounds)
+                {
+                    --it->rounds;
+                    ++it;
+                    continue;
+                }
+
+                m_slots.erase(it->ID);
+                m_due.insert(it->ID);
+                due.push_back(std::move(*it));
+                it = slot.erase(it);
+            }
+        }
+
+        for (auto it = due.begin(); it != due.end(); ++it)
+        {
+            {
+                std::lock_guard<std::mutex> lock(m_mutex);
+                if (!m_due.erase(it->ID))
+                {
+                    // cancelled after it was due
+                    continue;
+                }
+
+                m_firing = it->ID;
+            }
+
+            it->callback();
+
+            {
+                std::lock_guard<std::mutex> lock(m_mutex);
+                m_firing = 0;
+            }
+
+            m_cv.notify_all();
+        }
+
+        due.clear();
+    }
+}
+
+// global functions
+Reactor &reactor()
+{
+    static Reactor instance;
+    return instance;
+}
+
+} // end namespace Proc
+
+} // end namespace Model
@@ -0,0 +1,122 @@
+/*
+ * Flex Flow
+ * Copyright (c) 2026-present fdar0536
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+#ifndef _MODEL_PROC_REACTOR_HPP_
+#define _MODEL_PROC_REACTOR_HPP_
+
+#include <array>
+#include <condition_variable>
+#include <functional>
+#include <list>
+#include <mutex>
+#include <thread>
+#include <unordered_map>
+#include <unordered_set>
+
+#include "model/defines.h"
+
+namespace Model
+{
+
+namespace Proc
+{
+
+/**
+ * @brief one thread which runs the timers of every process
+ *
+ * Timers are kept in a hashed wheel of 100 ms ticks, so scheduling and
+ * cancelling are O(1) however many processes are watched. Callbacks run
+ * on the reactor thread one at a time and must not block.
+ */
+class Reactor
+{
+public:
+
+    static constexpr u32 TICK_MS = 100;
+
+    static constexpr u32 WHEEL_SIZE = 512;
+
+    typedef u64 TimerID;
+
+    typedef std::function<void()> Callback;
+
+    Reactor();
+
+    ~Reactor();
+
+    /**
+     * @return TimerID never 0
+     */
+    TimerID schedule(const u64 delayMs, Callback callback);
+
+    /**
+     * @brief drop the timer, or wait until its callback returns if it is running
+     *
+     * It must not be called by the callback of the same timer.
+     */
+    void cancel(const TimerID id);
+
+private:
+
+    typedef struct Timer
+    {
+        TimerID ID;
+        // full turns of the wheel before it is due
+        u64 rounds;
+        Callback callback;
+    } Timer;
+
+    std::mutex m_mutex;
+
+    std::condition_variable m_cv;
+
+    std::array<std::list<Timer>, WHEEL_SIZE> m_wheel;
+
+    // timer to its slot
+    std::unordered_map<TimerID, u32> m_slots;
+
+    u32 m_cursor = 0;
+
+    TimerID m_nextID = 1;
+
+    // timers taken out of the wheel, but whose callbacks have not run yet
+    std::unordered_set<TimerID> m_due;
+
+    // the timer whose callback is running
+    TimerID m_firing = 0;
+
+    std::jthread m_thread;
+
+    void run(std::stop_token token);
+
+}; // end class Reactor
+
+/**
+ * @brief the reactor of this process
+ */
+Reactor &reactor();
+
+} // end namespace Proc
+
+} // end namespace Model
+
+#endif // _MODEL_PROC_REACTOR_HPP_
@@ -35,7 +35,7 @@ namespace Proc
 
 void printTask(const Task &task)
 {
-    spdlog::debug("{}:{} printTask", LOG_FILE_PATH(__FILE__), __LINE__);
+    FF_DEBUG("{}:{} printTask", LOG_FILE_PATH(__FILE__), __LINE__);
     
     fmt::println("execName: {}", task.execName);
     fmt::println("args: ");
@@ -49,6 +49,25 @@ void printTask(const Task &task)
     fmt::println("ID: {}", task.ID);
     fmt::println("exitCode: {}", task.exitCode);
     fmt::println("isSuccess: {}", std::to_string(task.isSuccess));
+    fmt::println("cpus: {}", task.cpus);
+    fmt::println("memoryMB: {}", task.memoryMB);
+    fmt::println("priority: {}", task.priority);
+    fmt::println("suspendedMs: {}", task.suspendedMs);
+    fmt::println("enqueueTime: {}", task.enqueueTime);
+    fmt::println("startTime: {}", task.startTime);
+    fmt::println("endTime: {}", task.endTime);
+    fmt::println("wallTimeoutSec: {}", task.wallTimeoutSec);
+    fmt::println("cpuTimeoutSec: {}", task.cpuTimeoutSec);
+    fmt::println("isTimedOut: {}", task.isTimedOut);
+    fmt::println("cpuUsageUs: {}", task.cpuUsageUs);
+    fmt::println("memoryPeakBytes: {}", task.memoryPeakBytes);
+    fmt::println("ioReadBytes: {}", task.ioReadBytes);
+    fmt::println("ioWriteBytes: {}", task.ioWriteBytes);
+    fmt::println("userTimeUs: {}", task.userTimeUs);
+    fmt::println("systemTimeUs: {}", task.systemTimeUs);
+    fmt::println("maxRssKB: {}", task.maxRssKB);
+    fmt::println("majorFaults: {}", task.majorFaults);
+    fmt::println("minorFaults: {}", task.minorFaults);
 }
 
 } // end namespace Proc
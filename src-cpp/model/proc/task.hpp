@@ -43,6 +43,35 @@ typedef struct Task
     i32 ID = 0;
     i32 exitCode = 0;
     bool isSuccess = false;
+    // resources reserved in the scheduler while the task runs
+    u32 cpus = 1;
+    u64 memoryMB = 0;
+    // higher runs first
+    i32 priority = 0;
+    // time the task was paused for tasks of higher priority
+    u64 suspendedMs = 0;
+    // unix time in milliseconds, 0 if it is unknown
+    i64 enqueueTime = 0;
+    i64 startTime = 0;
+    i64 endTime = 0;
+    // limits of the task, 0 means no limit,
+    // the wall-clock limit does not count the time it is suspended
+    u32 wallTimeoutSec = 0;
+    u32 cpuTimeoutSec = 0;
+    bool isTimedOut = false;
+    // measured by the cgroup of the task, 0 if it is unknown
+    u64 cpuUsageUs = 0;
+    u64 memoryPeakBytes = 0;
+    u64 ioReadBytes = 0;
+    u64 ioWriteBytes = 0;
+    // from wait4, they do not count the descendants which were not waited for
+    u64 userTimeUs = 0;
+    u64 systemTimeUs = 0;
+    u64 maxRssKB = 0;
+    u64 majorFaults = 0;
+    u64 minorFaults = 0;
+    // name of the queue which runs it, not stored
+    std::string queue = "";
 } Task; // end class Task
 
 void printTask(const Task &task);
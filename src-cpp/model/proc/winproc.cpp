@@ -21,12 +21,16 @@
  * SOFTWARE.
  */
 
+#include <algorithm>
 #include <new>
 
 #include "spdlog/spdlog.h"
 
 #include "winproc.hpp"
 
+#include "tlhelp32.h"
+
+#include "model/metrics/metrics.hpp"
 #include "model/utils.hpp"
 
 namespace Model
@@ -40,7 +44,7 @@ WinProc::WinProc() :
     m_childStdoutWrite(nullptr),
     m_procInfo(PROCESS_INFORMATION())
 {
-    spdlog::debug("{}:{} WinProc::WinProc", LOG_FILE_PATH(__FILE__), __LINE__);
+    FF_DEBUG("{}:{} WinProc::WinProc", LOG_FILE_PATH(__FILE__), __LINE__);
 
     m_exitCode.store(0, std::memory_order_relaxed);
     m_procInfo.hProcess = NULL;
@@ -56,7 +60,7 @@ WinProc::~WinProc()
 
 u8 WinProc::start(const Task &task)
 {
-    spdlog::debug("{}:{} WinProc::start", LOG_FILE_PATH(__FILE__), __LINE__);
+    FF_DEBUG("{}:{} WinProc::start", LOG_FILE_PATH(__FILE__), __LINE__);
 
     if (isRunning())
     {
@@ -123,7 +127,7 @@ void WinProc::stop()
 
 bool WinProc::isRunning()
 {
-    spdlog::debug("{}:{} WinProc::isRunning", LOG_FILE_PATH(__FILE__), __LINE__);
+    FF_DEBUG("{}:{} WinProc::isRunning", LOG_FILE_PATH(__FILE__), __LINE__);
     if (m_procInfo.hProcess == NULL)
     {
         return false;
@@ -152,7 +156,7 @@ bool WinProc::isRunning()
 
 void WinProc::readCurrentOutput(std::vector<std::string> &out)
 {
-    spdlog::debug("{}:{} WinProc::readCurrentOutput",
+    FF_DEBUG("{}:{} WinProc::readCurrentOutput",
         LOG_FILE_PATH(__FILE__), __LINE__);
 
     out.clear();
@@ -162,7 +166,7 @@ void WinProc::readCurrentOutput(std::vector<std::string> &out)
 
         if (m_deque.empty())
         {
-            spdlog::debug("{}:{} nothing to read",
+            FF_DEBUG("{}:{} nothing to read",
                 LOG_FILE_PATH(__FILE__), __LINE__);
             return;
         }
@@ -178,7 +182,7 @@ void WinProc::readCurrentOutput(std::vector<std::string> &out)
 
 u8 WinProc::exitCode(i32 &out)
 {
-    spdlog::debug("{}:{} WinProc::exitCode", LOG_FILE_PATH(__FILE__), __LINE__);
+    FF_DEBUG("{}:{} WinProc::exitCode", LOG_FILE_PATH(__FILE__), __LINE__);
 
     if (isRunning())
     {
@@ -191,10 +195,113 @@ u8 WinProc::exitCode(i32 &out)
     return 0;
 }
 
+// time limits are not enforced on Windows yet
+bool WinProc::isTimedOut()
+{
+    return false;
+}
+
+// no usage is measured on Windows yet
+void WinProc::usage(Task &out)
+{
+    UNUSED(out);
+}
+
+// grandchildren are not suspended, the same as SIGSTOP on posix
+u8 WinProc::suspend()
+{
+    FF_DEBUG("{}:{} WinProc::suspend", LOG_FILE_PATH(__FILE__), __LINE__);
+
+    std::unique_lock<std::mutex> lock(m_suspendMutex);
+    if (!m_suspendedThreads.empty())
+    {
+        return 0;
+    }
+
+    if (m_procInfo.hProcess == NULL)
+    {
+        spdlog::error("{}:{} {}",
+            LOG_FILE_PATH(__FILE__), __LINE__, "Process is not running");
+        return 1;
+    }
+
+    std::vector<DWORD> suspendedIDs;
+    bool isAnySuspended(true);
+
+    // a running thread may create new ones while the snapshot is walked,
+    // so walk a new snapshot until it has no thread left to suspend
+    while (isAnySuspended)
+    {
+        isAnySuspended = false;
+        HANDLE snapshot = CreateToolhelp32Snapshot(TH32CS_SNAPTHREAD, 0);
+        if (snapshot == INVALID_HANDLE_VALUE)
+        {
+            Utils::writeLastError(LOG_FILE_PATH(__FILE__), __LINE__);
+            resumeThreadsLocked();
+            return 1;
+        }
+
+        THREADENTRY32 entry;
+        entry.dwSize = sizeof(THREADENTRY32);
+        for (BOOL isOk = Thread32First(snapshot, &entry);
+             isOk;
+             isOk = Thread32Next(snapshot, &entry))
+        {
+            if (entry.th32OwnerProcessID != m_procInfo.dwProcessId ||
+                std::find(suspendedIDs.begin(), suspendedIDs.end(),
+                          entry.th32ThreadID) != suspendedIDs.end())
+            {
+                continue;
+            }
+
+            HANDLE thread = OpenThread(THREAD_SUSPEND_RESUME, FALSE, entry.th32ThreadID);
+            if (thread == NULL)
+            {
+                // exited after the snapshot was taken
+                continue;
+            }
+
+            if (SuspendThread(thread) == static_cast<DWORD>(-1))
+            {
+                Utils::writeLastError(LOG_FILE_PATH(__FILE__), __LINE__);
+                CloseHandle(thread);
+                CloseHandle(snapshot);
+                resumeThreadsLocked();
+                return 1;
+            }
+
+            m_suspendedThreads.push_back(thread);
+            suspendedIDs.push_back(entry.th32ThreadID);
+            isAnySuspended = true;
+        }
+
+        CloseHandle(snapshot);
+    }
+
+    if (m_suspendedThreads.empty())
+    {
+        spdlog::error("{}:{} {}",
+            LOG_FILE_PATH(__FILE__), __LINE__, "No thread to suspend");
+        return 1;
+    }
+
+    return 0;
+}
+
+u8 WinProc::resume()
+{
+    FF_DEBUG("{}:{} WinProc::resume", LOG_FILE_PATH(__FILE__), __LINE__);
+
+    std::unique_lock<std::mutex> lock(m_suspendMutex);
+    // nothing to do, the same as SIGCONT to a running process
+    resumeThreadsLocked();
+    return 0;
+}
+
 // private member functions
 u8 WinProc::prepareStartupInformation(STARTUPINFOEXA *output)
 {
-    spdlog::debug("{}:{} WinProc::prepareStartupInformation",
+    FF_DEBUG("{}:{} WinProc::prepareStartupInformation",
         LOG_FILE_PATH(__FILE__), __LINE__);
 
     if (!output)
@@ -245,7 +352,7 @@ u8 WinProc::prepareStartupInformation(STARTUPINFOEXA *output)
 
 u8 WinProc::CreateChildProcess(const Task &task)
 {
-    spdlog::debug("{}:{} WinProc::CreateChildProcess",
+    FF_DEBUG("{}:{} WinProc::CreateChildProcess",
         LOG_FILE_PATH(__FILE__), __LINE__);
 
     if (task.execName.empty())
@@ -314,7 +421,7 @@ u8 WinProc::CreateChildProcess(const Task &task)
 
 void WinProc::resetHandle()
 {
-    spdlog::debug("{}:{} WinProc::resetHandle", LOG_FILE_PATH(__FILE__), __LINE__);
+    FF_DEBUG("{}:{} WinProc::resetHandle", LOG_FILE_PATH(__FILE__), __LINE__);
 
     if (m_childStdoutRead)
     {
@@ -358,12 +465,37 @@ void WinProc::resetHandle()
         m_pseudoConsole = nullptr;
     }
 
+    {
+        std::unique_lock<std::mutex> lock(m_suspendMutex);
+        for (auto it = m_suspendedThreads.begin(); it != m_suspendedThreads.end(); ++it)
+        {
+            CloseHandle(*it);
+        }
+
+        m_suspendedThreads.clear();
+    }
+
     memset(&m_procInfo, 0, sizeof(PROCESS_INFORMATION));
 }
 
+void WinProc::resumeThreadsLocked()
+{
+    for (auto it = m_suspendedThreads.begin(); it != m_suspendedThreads.end(); ++it)
+    {
+        if (ResumeThread(*it) == static_cast<DWORD>(-1))
+        {
+            Utils::writeLastError(LOG_FILE_PATH(__FILE__), __LINE__);
+        }
+
+        CloseHandle(*it);
+    }
+
+    m_suspendedThreads.clear();
+}
+
 void WinProc::stopImpl()
 {
-    spdlog::debug("{}:{} WinProc::stopImpl", LOG_FILE_PATH(__FILE__), __LINE__);
+    FF_DEBUG("{}:{} WinProc::stopImpl", LOG_FILE_PATH(__FILE__), __LINE__);
 
     if (m_pseudoConsole)
     {
@@ -376,7 +508,12 @@ void WinProc::stopImpl()
 
 void WinProc::readOutputLoop()
 {
-    spdlog::debug("{}:{} WinProc::readOutputLoop", LOG_FILE_PATH(__FILE__), __LINE__);
+    FF_DEBUG("{}:{} WinProc::readOutputLoop", LOG_FILE_PATH(__FILE__), __LINE__);
+
+    static auto outputBytes =
+        Metrics::registry().counter("ff_proc_output_bytes_total");
+    static auto droppedChunks =
+        Metrics::registry().counter("ff_proc_output_dropped_total");
 
     BOOL bSuccess;
     DWORD dwRead;
@@ -396,6 +533,7 @@ void WinProc::readOutputLoop()
 
         // set correct buffer size
         buf.resize(dwRead);
+        outputBytes->add(dwRead);
 
         {
             std::unique_lock<std::mutex> lock(m_mutex);
@@ -403,6 +541,7 @@ void WinProc::readOutputLoop()
             if (m_deque.size() == FF_MAX_READ_QUEUE_SIZE)
             {
                 m_deque.pop_front();
+                droppedChunks->add();
             }
 
             m_deque.push_back(std::move(buf));
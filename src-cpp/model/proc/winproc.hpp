@@ -28,6 +28,7 @@
 #include <deque>
 #include <mutex>
 #include <thread>
+#include <vector>
 
 #include "windows.h"
 
@@ -61,6 +62,18 @@ public:
 
     virtual u8 exitCode(i32 &out) override;
 
+    /**
+     * @brief suspend every thread of the child, including the threads
+     * it creates while they are being suspended
+     */
+    virtual u8 suspend() override;
+
+    virtual u8 resume() override;
+
+    virtual bool isTimedOut() override;
+
+    virtual void usage(Task &out) override;
+
 private:
 
     HANDLE m_childStdoutRead = nullptr;
@@ -86,6 +99,13 @@ private:
 
     void stopImpl();
 
+    // held open so a thread ID cannot be reused before resume
+    std::vector<HANDLE> m_suspendedThreads;
+
+    std::mutex m_suspendMutex;
+
+    void resumeThreadsLocked();
+
     std::jthread m_thread;
 
     std::mutex m_mutex;
@@ -0,0 +1,106 @@
+/*
+ * Flex Flow
+ * Copyright (c) 2026-present fdar0536
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+#include "spdlog/spdlog.h"
+
+#include "model/utils.hpp"
+
+#include "estimator.hpp"
+
+namespace Model
+{
+
+namespace Sched
+{
+
+std::string Estimator::shape(const Proc::Task &task)
+{
+    std::string out = task.execName;
+    for (auto it = task.args.begin(); it != task.args.end(); ++it)
+    {
+        out += (!it->empty() && it->front() == '-') ? " " + *it : " *";
+    }
+
+    return out;
+}
+
+void Estimator::record(const Proc::Task &task, const u64 runMs)
+{
+    FF_DEBUG("{}:{} Estimator::record", LOG_FILE_PATH(__FILE__), __LINE__);
+
+    std::string key = shape(task);
+    std::lock_guard<std::mutex> lock(m_mutex);
+    auto it = m_averageMs.find(key);
+    if (it != m_averageMs.end())
+    {
+        it->second += ALPHA * (static_cast<f64>(runMs) - it->second);
+        return;
+    }
+
+    // commands with generated names would grow it without bound
+    if (m_averageMs.size() >= MAX_SHAPES)
+    {
+        m_averageMs.erase(m_averageMs.begin());
+    }
+
+    m_averageMs[key] = static_cast<f64>(runMs);
+}
+
+u64 Estimator::expectedMs(const Proc::Task &task)
+{
+    std::string key = shape(task);
+    std::lock_guard<std::mutex> lock(m_mutex);
+    auto it = m_averageMs.find(key);
+    return it == m_averageMs.end() ? 0 : static_cast<u64>(it->second);
+}
+
+void Estimator::configure(const std::vector<std::string> &queues, const f64 aging)
+{
+    FF_DEBUG("{}:{} Estimator::configure", LOG_FILE_PATH(__FILE__), __LINE__);
+
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_shortestFirst = std::unordered_set<std::string>(queues.begin(), queues.end());
+    m_aging = aging;
+}
+
+bool Estimator::isShortestFirst(const std::string &queue)
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return m_shortestFirst.find(queue) != m_shortestFirst.end();
+}
+
+f64 Estimator::aging()
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return m_aging;
+}
+
+// global functions
+Estimator &estimator()
+{
+    static Estimator instance;
+    return instance;
+}
+
+} // end namespace Sched
+
+} // end namespace Model
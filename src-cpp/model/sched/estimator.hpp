@@ -0,0 +1,102 @@
+/*
+ * Flex Flow
+ * Copyright (c) 2026-present fdar0536
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+#ifndef _MODEL_SCHED_ESTIMATOR_HPP_
+#define _MODEL_SCHED_ESTIMATOR_HPP_
+
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
+#include "model/defines.h"
+#include "model/proc/task.hpp"
+
+namespace Model
+{
+
+namespace Sched
+{
+
+/**
+ * @brief expected run time of a command, from the runs which have finished
+ *
+ * Tasks of the same shape (see shape()) share one exponentially weighted
+ * moving average of their run time.
+ */
+class Estimator
+{
+public:
+
+    // weight of the latest run
+    static constexpr f64 ALPHA = 0.3;
+
+    static constexpr size_t MAX_SHAPES = 4096;
+
+    /**
+     * @brief execName, the flags (arguments which start with '-')
+     * and the position of the other arguments
+     * e.g. "ffmpeg -i a.mp4 -c:v libx264 b.mp4" is "ffmpeg -i * -c:v * *"
+     */
+    static std::string shape(const Proc::Task &task);
+
+    void record(const Proc::Task &task, const u64 runMs);
+
+    /**
+     * @return u64 0 if no task of the same shape has finished yet
+     */
+    u64 expectedMs(const Proc::Task &task);
+
+    /**
+     * @param queues which run the shortest expected task first
+     * @param aging how much the expected time of a pending task
+     * is lowered for every second it has waited
+     */
+    void configure(const std::vector<std::string> &queues, const f64 aging);
+
+    bool isShortestFirst(const std::string &queue);
+
+    f64 aging();
+
+private:
+
+    std::mutex m_mutex;
+
+    std::unordered_map<std::string, f64> m_averageMs;
+
+    std::unordered_set<std::string> m_shortestFirst;
+
+    f64 m_aging = 0;
+
+}; // end class Estimator
+
+/**
+ * @brief the estimator of this process
+ */
+Estimator &estimator();
+
+} // end namespace Sched
+
+} // end namespace Model
+
+#endif // _MODEL_SCHED_ESTIMATOR_HPP_
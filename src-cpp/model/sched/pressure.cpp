@@ -0,0 +1,188 @@
+/*
+ * Flex Flow
+ * Copyright (c) 2026-present fdar0536
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+#include <cstdio>
+#include <cstring>
+#include <thread>
+
+#include "spdlog/spdlog.h"
+
+#include "model/errmsg.hpp"
+#include "model/metrics/metrics.hpp"
+#include "model/utils.hpp"
+
+#include "pressure.hpp"
+
+namespace Model
+{
+
+namespace Sched
+{
+
+void Pressure::configure(const Thresholds &thresholds)
+{
+    FF_DEBUG("{}:{} Pressure::configure", LOG_FILE_PATH(__FILE__), __LINE__);
+
+    m_thresholds = thresholds;
+    if (!m_thresholds.sampleMs)
+    {
+        m_thresholds.sampleMs = 1000;
+    }
+
+    // sample again at the next call
+    m_sampleTime = std::chrono::steady_clock::time_point();
+    m_isSaturated = false;
+}
+
+bool Pressure::isEnabled() const
+{
+    return m_thresholds.cpu > 0 ||
+           m_thresholds.memory > 0 ||
+           m_thresholds.io > 0 ||
+           m_thresholds.load > 0;
+}
+
+bool Pressure::isSaturated()
+{
+    if (!isEnabled())
+    {
+        return false;
+    }
+
+    auto now = std::chrono::steady_clock::now();
+    if (now - m_sampleTime < std::chrono::milliseconds(m_thresholds.sampleMs))
+    {
+        return m_isSaturated;
+    }
+
+    m_sampleTime = now;
+    sample();
+
+    auto isAbove = [](f64 threshold, f64 value) -> bool
+    {
+        return threshold > 0 && value > threshold;
+    };
+
+    m_isSaturated = isAbove(m_thresholds.cpu, m_sample.cpu) ||
+                    isAbove(m_thresholds.memory, m_sample.memory) ||
+                    isAbove(m_thresholds.io, m_sample.io) ||
+                    isAbove(m_thresholds.load, m_sample.load);
+    return m_isSaturated;
+}
+
+u32 Pressure::sampleMs() const
+{
+    return m_thresholds.sampleMs;
+}
+
+const Pressure::Sample &Pressure::lastSample() const
+{
+    return m_sample;
+}
+
+// private member functions
+void Pressure::sample()
+{
+    static auto samples = Metrics::registry().counter("ff_host_pressure_samples_total");
+    samples->add();
+
+    // unreadable values count as no pressure
+    m_sample = Sample();
+    if (m_thresholds.cpu > 0)
+    {
+        UNUSED(readPSI("/proc/pressure/cpu", m_sample.cpu));
+    }
+
+    if (m_thresholds.memory > 0)
+    {
+        UNUSED(readPSI("/proc/pressure/memory", m_sample.memory));
+    }
+
+    if (m_thresholds.io > 0)
+    {
+        UNUSED(readPSI("/proc/pressure/io", m_sample.io));
+    }
+
+    if (m_thresholds.load > 0)
+    {
+        UNUSED(readLoad(m_sample.load));
+    }
+
+    FF_DEBUG("{}:{} cpu: {}, memory: {}, io: {}, load: {}",
+        LOG_FILE_PATH(__FILE__), __LINE__,
+        m_sample.cpu, m_sample.memory, m_sample.io, m_sample.load);
+}
+
+u8 Pressure::readPSI(const char *path, f64 &out)
+{
+    FILE *file = fopen(path, "r");
+    if (!file)
+    {
+        if (!m_isPSIWarned)
+        {
+            // kernel without CONFIG_PSI, or not Linux
+            spdlog::warn("{}:{} Fail to open {}: {}",
+                LOG_FILE_PATH(__FILE__), __LINE__, path, strerror(errno));
+            m_isPSIWarned = true;
+        }
+
+        return ErrCode_OS_ERROR;
+    }
+
+    // some avg10=1.24 avg60=2.09 avg300=1.97 total=119025966
+    u8 ret(ErrCode_OK);
+    if (fscanf(file, "some avg10=%lf", &out) != 1)
+    {
+        spdlog::error("{}:{} Fail to parse {}", LOG_FILE_PATH(__FILE__), __LINE__, path);
+        out = 0;
+        ret = ErrCode_OS_ERROR;
+    }
+
+    fclose(file);
+    return ret;
+}
+
+u8 Pressure::readLoad(f64 &out)
+{
+    FILE *file = fopen("/proc/loadavg", "r");
+    if (!file)
+    {
+        return ErrCode_OS_ERROR;
+    }
+
+    u8 ret(ErrCode_OK);
+    if (fscanf(file, "%lf", &out) != 1)
+    {
+        out = 0;
+        ret = ErrCode_OS_ERROR;
+    }
+
+    fclose(file);
+
+    u32 cores = std::thread::hardware_concurrency();
+    out /= cores ? cores : 1;
+    return ret;
+}
+
+} // end namespace Sched
+
+} // end namespace Model
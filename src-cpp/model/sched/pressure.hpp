@@ -0,0 +1,106 @@
+/*
+ * Flex Flow
+ * Copyright (c) 2026-present fdar0536
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+#ifndef _MODEL_SCHED_PRESSURE_HPP_
+#define _MODEL_SCHED_PRESSURE_HPP_
+
+#include <chrono>
+
+#include "model/defines.h"
+
+namespace Model
+{
+
+namespace Sched
+{
+
+/**
+ * @brief tell whether the host is saturated, from /proc/pressure and /proc/loadavg
+ *
+ * The files are read at most once every sampleMs, callers share the last sample.
+ * It is not thread safe, the scheduler calls it under its own lock.
+ */
+class Pressure
+{
+public:
+
+    // 0 means the value is not checked
+    typedef struct Thresholds
+    {
+        // "some avg10" of /proc/pressure/*, in percent
+        f64 cpu = 0;
+        f64 memory = 0;
+        f64 io = 0;
+
+        // 1-minute load average per core
+        f64 load = 0;
+
+        u32 sampleMs = 1000;
+    } Thresholds;
+
+    typedef struct Sample
+    {
+        f64 cpu = 0;
+        f64 memory = 0;
+        f64 io = 0;
+        f64 load = 0;
+    } Sample;
+
+    void configure(const Thresholds &);
+
+    bool isEnabled() const;
+
+    /**
+     * @brief compare the latest sample with the thresholds
+     * @return true if any value is above its threshold
+     */
+    bool isSaturated();
+
+    u32 sampleMs() const;
+
+    const Sample &lastSample() const;
+
+private:
+
+    Thresholds m_thresholds;
+
+    Sample m_sample;
+
+    bool m_isSaturated = false;
+
+    bool m_isPSIWarned = false;
+
+    std::chrono::steady_clock::time_point m_sampleTime;
+
+    void sample();
+
+    u8 readPSI(const char *path, f64 &out);
+
+    static u8 readLoad(f64 &out);
+
+}; // end class Pressure
+
+} // end namespace Sched
+
+} // end namespace Model
+
+#endif // _MODEL_SCHED_PRESSURE_HPP_
@@ -0,0 +1,474 @@
+/*
+ * Flex Flow
+ * Copyright (c) 2026-present fdar0536
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+#include <algorithm>
+#include <thread>
+#include <vector>
+
+#include "spdlog/spdlog.h"
+
+#include "model/errmsg.hpp"
+#include "model/metrics/metrics.hpp"
+#include "model/utils.hpp"
+
+#include "scheduler.hpp"
+
+namespace Model
+{
+
+namespace Sched
+{
+
+static u32 coreCount()
+{
+    u32 out = std::thread::hardware_concurrency();
+    return out ? out : 1;
+}
+
+static u64 elapsedMs(const std::chrono::steady_clock::time_point &since)
+{
+    return static_cast<u64>(
+        std::chrono::duration_cast<std::chrono::milliseconds>(
+            std::chrono::steady_clock::now() - since).count());
+}
+
+Scheduler::Scheduler() :
+    m_cpuSlots(coreCount())
+{}
+
+void Scheduler::configure(const u32 cpuSlots,
+                          const u64 memoryMB,
+                          const std::map<std::string, u32> &weights)
+{
+    FF_DEBUG("{}:{} Scheduler::configure", LOG_FILE_PATH(__FILE__), __LINE__);
+
+    u32 slots = cpuSlots ? cpuSlots : coreCount();
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_cpuSlots = slots;
+        m_memoryMB = memoryMB;
+        m_weights = weights;
+    }
+
+    spdlog::info("{}:{} scheduler budget: {} cpu slots, {} MB memory",
+        LOG_FILE_PATH(__FILE__), __LINE__, slots, memoryMB);
+    m_cv.notify_all();
+}
+
+void Scheduler::setPressure(const Pressure::Thresholds &thresholds)
+{
+    FF_DEBUG("{}:{} Scheduler::setPressure", LOG_FILE_PATH(__FILE__), __LINE__);
+
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_pressure.configure(thresholds);
+    }
+
+    m_cv.notify_all();
+}
+
+void Scheduler::setPreemption(const bool isEnabled)
+{
+    FF_DEBUG("{}:{} Scheduler::setPreemption", LOG_FILE_PATH(__FILE__), __LINE__);
+
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_isPreemptive = isEnabled;
+}
+
+u8 Scheduler::acquire(const std::string &queue,
+                      const Proc::Task &task,
+                      const std::atomic<bool> &keepWaiting,
+                      Grant &out)
+{
+    FF_DEBUG("{}:{} Scheduler::acquire", LOG_FILE_PATH(__FILE__), __LINE__);
+    FF_DEBUG("{}:{} queue: {}, cpus: {}, memoryMB: {}, priority: {}",
+        LOG_FILE_PATH(__FILE__), __LINE__, queue,
+        task.cpus, task.memoryMB, task.priority);
+
+    static auto waiting = Metrics::registry().gauge("ff_sched_waiting");
+
+    auto start = std::chrono::steady_clock::now();
+    std::unique_lock<std::mutex> lock(m_mutex);
+
+    // a task bigger than the budget runs alone
+    Waiter self{queue, task.cpus ? task.cpus : 1, task.memoryMB, task.priority};
+    if (self.cpus > m_cpuSlots) self.cpus = m_cpuSlots;
+    if (m_memoryMB && self.memoryMB > m_memoryMB) self.memoryMB = m_memoryMB;
+
+    auto it = m_waiters.insert(m_waiters.end(), self);
+    waiting->add(1);
+    bool isHeldByPressure(false);
+    std::chrono::steady_clock::time_point pressureStart;
+    while (true)
+    {
+        if (next() == &*it)
+        {
+            if (!fits(it->cpus, it->memoryMB) && m_isPreemptive)
+            {
+                UNUSED(preemptFor(*it));
+            }
+
+            if (fits(it->cpus, it->memoryMB))
+            {
+                if (!m_pressure.isSaturated())
+                {
+                    break;
+                }
+
+                // the host is busy, sample it again later
+                if (!isHeldByPressure)
+                {
+                    const Pressure::Sample &sample = m_pressure.lastSample();
+                    spdlog::info("{}:{} hold a task of {}, cpu: {}%, memory: {}%, io: {}%, load: {}",
+                        LOG_FILE_PATH(__FILE__), __LINE__, queue,
+                        sample.cpu, sample.memory, sample.io, sample.load);
+                    isHeldByPressure = true;
+                    pressureStart = std::chrono::steady_clock::now();
+                }
+            }
+        }
+
+        if (!keepWaiting.load(std::memory_order_relaxed))
+        {
+            m_waiters.erase(it);
+            waiting->add(-1);
+
+            // suspended tasks may wait for this one only
+            resumeSuspended();
+            lock.unlock();
+
+            // the waiter behind may be the next one now
+            m_cv.notify_all();
+            return ErrCode_INVALID_ARGUMENT;
+        }
+
+        if (isHeldByPressure)
+        {
+            m_cv.wait_for(lock, std::chrono::milliseconds(m_pressure.sampleMs()));
+            continue;
+        }
+
+        m_cv.wait(lock);
+    }
+
+    m_usedCpus += it->cpus;
+    m_usedMemoryMB += it->memoryMB;
+    out.queue = queue;
+    out.cpus = it->cpus;
+    out.memoryMB = it->memoryMB;
+    out.start = std::chrono::steady_clock::now();
+    out.ID = m_nextID++;
+    Running &running = m_running[out.ID];
+    running.queue = queue;
+    running.cpus = it->cpus;
+    running.memoryMB = it->memoryMB;
+    running.priority = it->priority;
+    running.start = out.start;
+    m_waiters.erase(it);
+    waiting->add(-1);
+    updateGauges();
+    lock.unlock();
+
+    std::string labels = Metrics::label("queue", queue);
+    Metrics::registry().histogram("ff_sched_wait", labels)
+        ->record(Metrics::elapsedUs(start));
+    if (isHeldByPressure)
+    {
+        Metrics::registry().histogram("ff_sched_pressure_wait", labels)
+            ->record(Metrics::elapsedUs(pressureStart));
+    }
+
+    m_cv.notify_all();
+    return ErrCode_OK;
+}
+
+void Scheduler::bind(const Grant &grant, const std::shared_ptr<Proc::IProc> &proc)
+{
+    FF_DEBUG("{}:{} Scheduler::bind", LOG_FILE_PATH(__FILE__), __LINE__);
+
+    std::lock_guard<std::mutex> lock(m_mutex);
+    auto it = m_running.find(grant.ID);
+    if (it != m_running.end())
+    {
+        it->second.proc = proc;
+    }
+}
+
+u64 Scheduler::release(const Grant &grant)
+{
+    FF_DEBUG("{}:{} Scheduler::release", LOG_FILE_PATH(__FILE__), __LINE__);
+
+    u64 suspendedMs(0);
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        auto it = m_running.find(grant.ID);
+        if (it == m_running.end())
+        {
+            return 0;
+        }
+
+        Running &running = it->second;
+        suspendedMs = running.suspendedMs;
+        if (running.isSuspended)
+        {
+            // stopped while suspended, its budget is already given back
+            suspendedMs += elapsedMs(running.suspendTime);
+        }
+        else
+        {
+            m_usedCpus -= running.cpus;
+            m_usedMemoryMB -= running.memoryMB;
+        }
+
+        u64 runMs = elapsedMs(running.start);
+        runMs = runMs > suspendedMs ? runMs - suspendedMs : 0;
+        auto weight = m_weights.find(grant.queue);
+        m_usage[grant.queue] = usage(grant.queue) + running.cpus * (runMs / 1000.0) /
+            (weight == m_weights.end() || !weight->second ? 1 : weight->second);
+
+        m_running.erase(it);
+        resumeSuspended();
+        updateGauges();
+    }
+
+    m_cv.notify_all();
+    return suspendedMs;
+}
+
+void Scheduler::interrupt()
+{
+    // under the lock, so a waiter cannot miss it between its check and wait
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_cv.notify_all();
+}
+
+// private member functions
+const Scheduler::Waiter *Scheduler::next()
+{
+    const Waiter *out = nullptr;
+    f64 least(0);
+    for (auto it = m_waiters.begin(); it != m_waiters.end(); ++it)
+    {
+        f64 current = usage(it->queue);
+        if (!out ||
+            it->priority > out->priority ||
+            (it->priority == out->priority && current < least))
+        {
+            out = &*it;
+            least = current;
+        }
+    }
+
+    return out;
+}
+
+bool Scheduler::fits(const u32 cpus, const u64 memoryMB) const
+{
+    return m_usedCpus + cpus <= m_cpuSlots &&
+           (!m_memoryMB || m_usedMemoryMB + memoryMB <= m_memoryMB);
+}
+
+u8 Scheduler::preemptFor(const Waiter &waiter)
+{
+    FF_DEBUG("{}:{} Scheduler::preemptFor", LOG_FILE_PATH(__FILE__), __LINE__);
+
+    static auto preemptions = Metrics::registry().counter("ff_sched_preemptions_total");
+
+    // lowest priority first, then the latest started, which has done the least work
+    std::vector<std::map<u64, Running>::iterator> victims;
+    for (auto it = m_running.begin(); it != m_running.end(); ++it)
+    {
+        if (it->second.proc &&
+            !it->second.isSuspended &&
+            it->second.priority < waiter.priority)
+        {
+            victims.push_back(it);
+        }
+    }
+
+    std::sort(victims.begin(), victims.end(),
+        [](const auto &a, const auto &b) -> bool
+        {
+            if (a->second.priority != b->second.priority)
+            {
+                return a->second.priority < b->second.priority;
+            }
+
+            return a->second.start > b->second.start;
+        });
+
+    // suspend nothing unless it is enough
+    u32 cpus(m_usedCpus);
+    u64 memoryMB(m_usedMemoryMB);
+    size_t count(0);
+    while (count < victims.size() &&
+           (cpus + waiter.cpus > m_cpuSlots ||
+            (m_memoryMB && memoryMB + waiter.memoryMB > m_memoryMB)))
+    {
+        cpus -= victims[count]->second.cpus;
+        memoryMB -= victims[count]->second.memoryMB;
+        ++count;
+    }
+
+    if (cpus + waiter.cpus > m_cpuSlots ||
+        (m_memoryMB && memoryMB + waiter.memoryMB > m_memoryMB))
+    {
+        return ErrCode_NOT_FOUND;
+    }
+
+    for (size_t i = 0; i < count; ++i)
+    {
+        Running &running = victims[i]->second;
+        if (running.proc->suspend())
+        {
+            // most likely it has exited and is about to be released,
+            // never signal it again
+            spdlog::error("{}:{} Fail to suspend a task of {}",
+                LOG_FILE_PATH(__FILE__), __LINE__, running.queue);
+            running.proc = nullptr;
+            continue;
+        }
+
+        spdlog::info("{}:{} suspend a task of {} (priority {}) for a task of {} (priority {})",
+            LOG_FILE_PATH(__FILE__), __LINE__,
+            running.queue, running.priority, waiter.queue, waiter.priority);
+        running.isSuspended = true;
+        running.suspendTime = std::chrono::steady_clock::now();
+        m_usedCpus -= running.cpus;
+        m_usedMemoryMB -= running.memoryMB;
+        preemptions->add();
+    }
+
+    updateGauges();
+    return ErrCode_OK;
+}
+
+void Scheduler::resumeSuspended()
+{
+    i32 waiting(0);
+    const Waiter *head = next();
+    bool hasWaiter(head != nullptr);
+    if (hasWaiter)
+    {
+        waiting = head->priority;
+    }
+
+    while (true)
+    {
+        // the suspended task of the highest priority, then the earliest started
+        Running *candidate(nullptr);
+        for (auto it = m_running.begin(); it != m_running.end(); ++it)
+        {
+            Running &running = it->second;
+            if (running.isSuspended &&
+                (!candidate ||
+                 running.priority > candidate->priority ||
+                 (running.priority == candidate->priority &&
+                  running.start < candidate->start)))
+            {
+                candidate = &running;
+            }
+        }
+
+        if (!candidate ||
+            (hasWaiter && waiting > candidate->priority) ||
+            !fits(candidate->cpus, candidate->memoryMB))
+        {
+            return;
+        }
+
+        if (candidate->proc->resume())
+        {
+            // most likely it has exited, release() will clean it up
+            spdlog::error("{}:{} Fail to resume a task of {}",
+                LOG_FILE_PATH(__FILE__), __LINE__, candidate->queue);
+            candidate->proc = nullptr;
+        }
+        else
+        {
+            spdlog::info("{}:{} resume a task of {}",
+                LOG_FILE_PATH(__FILE__), __LINE__, candidate->queue);
+        }
+
+        candidate->isSuspended = false;
+        candidate->suspendedMs += elapsedMs(candidate->suspendTime);
+        m_usedCpus += candidate->cpus;
+        m_usedMemoryMB += candidate->memoryMB;
+        updateGauges();
+    }
+}
+
+void Scheduler::updateGauges()
+{
+    static auto usedCpus = Metrics::registry().gauge("ff_sched_cpus_used");
+    static auto usedMemory = Metrics::registry().gauge("ff_sched_memory_used_mb");
+    static auto suspended = Metrics::registry().gauge("ff_sched_suspended");
+
+    i64 count(0);
+    for (auto it = m_running.begin(); it != m_running.end(); ++it)
+    {
+        if (it->second.isSuspended)
+        {
+            ++count;
+        }
+    }
+
+    usedCpus->set(m_usedCpus);
+    usedMemory->set(static_cast<i64>(m_usedMemoryMB));
+    suspended->set(count);
+}
+
+f64 Scheduler::usage(const std::string &queue)
+{
+    auto it = m_usage.find(queue);
+    if (it != m_usage.end())
+    {
+        return it->second;
+    }
+
+    // a new queue starts level with the least used one,
+    // so it cannot take the whole budget for a long time
+    f64 least(0);
+    bool isFirst(true);
+    for (auto used = m_usage.begin(); used != m_usage.end(); ++used)
+    {
+        if (isFirst || used->second < least)
+        {
+            least = used->second;
+            isFirst = false;
+        }
+    }
+
+    m_usage[queue] = least;
+    return least;
+}
+
+// global functions
+Scheduler &scheduler()
+{
+    static Scheduler instance;
+    return instance;
+}
+
+} // end namespace Sched
+
+} // end namespace Model
@@ -0,0 +1,190 @@
+/*
+ * Flex Flow
+ * Copyright (c) 2026-present fdar0536
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+#ifndef _MODEL_SCHED_SCHEDULER_HPP_
+#define _MODEL_SCHED_SCHEDULER_HPP_
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <list>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+
+#include "model/defines.h"
+#include "model/proc/iproc.hpp"
+
+#include "pressure.hpp"
+
+namespace Model
+{
+
+namespace Sched
+{
+
+/**
+ * @brief server-wide budget of cpu slots and memory for running tasks
+ *
+ * Waiting tasks are admitted by priority, then in weighted fair order:
+ * the queue which has used the fewest cpu seconds per weight goes first.
+ * A task which does not fit blocks the ones behind it, so big tasks are
+ * never starved. While the host is saturated (see Pressure) no task is
+ * admitted.
+ *
+ * With preemption, a task which does not fit suspends running tasks of
+ * lower priority until it fits. They are resumed, before any waiter of
+ * the same or lower priority is admitted, once the budget allows.
+ */
+class Scheduler
+{
+public:
+
+    typedef struct Grant
+    {
+        std::string queue;
+        u32 cpus = 0;
+        u64 memoryMB = 0;
+        std::chrono::steady_clock::time_point start;
+        // 0 if nothing is granted
+        u64 ID = 0;
+    } Grant;
+
+    Scheduler();
+
+    /**
+     * @param cpuSlots 0 means the number of cores
+     * @param memoryMB 0 means memory is not limited
+     * @param weights share of the queues, 1 if a queue is not listed
+     */
+    void configure(const u32 cpuSlots,
+                   const u64 memoryMB,
+                   const std::map<std::string, u32> &weights);
+
+    void setPressure(const Pressure::Thresholds &);
+
+    void setPreemption(const bool isEnabled);
+
+    /**
+     * @brief wait until it is the turn of the queue, the task fits
+     * and the host is not saturated
+     * @param keepWaiting give up once it is false, see interrupt()
+     * @return u8 ErrCode_INVALID_ARGUMENT if it gives up
+     */
+    u8 acquire(const std::string &queue,
+               const Proc::Task &task,
+               const std::atomic<bool> &keepWaiting,
+               Grant &out);
+
+    /**
+     * @brief the process of the grant can be suspended from now on
+     */
+    void bind(const Grant &grant, const std::shared_ptr<Proc::IProc> &proc);
+
+    /**
+     * @return u64 how long the task was suspended, in milliseconds
+     */
+    u64 release(const Grant &grant);
+
+    /**
+     * @brief let every waiter check its keepWaiting again
+     */
+    void interrupt();
+
+private:
+
+    typedef struct Waiter
+    {
+        std::string queue;
+        u32 cpus;
+        u64 memoryMB;
+        i32 priority;
+    } Waiter;
+
+    typedef struct Running
+    {
+        std::string queue;
+        u32 cpus;
+        u64 memoryMB;
+        i32 priority;
+        std::chrono::steady_clock::time_point start;
+        // nullptr until the process is started
+        std::shared_ptr<Proc::IProc> proc;
+        bool isSuspended = false;
+        std::chrono::steady_clock::time_point suspendTime;
+        u64 suspendedMs = 0;
+    } Running;
+
+    std::mutex m_mutex;
+
+    std::condition_variable m_cv;
+
+    u32 m_cpuSlots;
+
+    u64 m_memoryMB = 0;
+
+    u32 m_usedCpus = 0;
+
+    u64 m_usedMemoryMB = 0;
+
+    std::map<std::string, u32> m_weights;
+
+    Pressure m_pressure;
+
+    bool m_isPreemptive = false;
+
+    u64 m_nextID = 1;
+
+    std::map<u64, Running> m_running;
+
+    // weighted cpu seconds of every queue
+    std::unordered_map<std::string, f64> m_usage;
+
+    // in arrival order
+    std::list<Waiter> m_waiters;
+
+    const Waiter *next();
+
+    bool fits(const u32 cpus, const u64 memoryMB) const;
+
+    u8 preemptFor(const Waiter &);
+
+    void resumeSuspended();
+
+    void updateGauges();
+
+    f64 usage(const std::string &queue);
+
+}; // end class Scheduler
+
+/**
+ * @brief the scheduler of this process
+ */
+Scheduler &scheduler();
+
+} // end namespace Sched
+
+} // end namespace Model
+
+#endif // _MODEL_SCHED_SCHEDULER_HPP_
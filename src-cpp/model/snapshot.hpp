@@ -0,0 +1,106 @@
+/*
+ * Flex Flow
+ * Copyright (c) 2026-present fdar0536
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#ifndef _MODEL_SNAPSHOT_HPP_
+#define _MODEL_SNAPSHOT_HPP_
+
+#include <atomic>
+#include <memory>
+#include <mutex>
+#include <version>
+
+#include "model/defines.h"
+
+namespace Model
+{
+
+/**
+ * @brief read-mostly container published as immutable versions
+ *
+ * Readers grab the current version without taking any lock and keep it alive
+ * for as long as they hold the returned pointer. Writers are serialized, work
+ * on a private copy and publish it as the next version.
+ */
+template <typename T>
+class Snapshot
+{
+public:
+
+    Snapshot() :
+        m_data(std::make_shared<const T>())
+    {}
+
+    /**
+     * @brief get the current version
+     * @return std::shared_ptr<const T> never nullptr
+     */
+    std::shared_ptr<const T> load() const
+    {
+#ifdef __cpp_lib_atomic_shared_ptr
+        return m_data.load(std::memory_order_acquire);
+#else
+        return std::atomic_load_explicit(&m_data, std::memory_order_acquire);
+#endif
+    }
+
+    /**
+     * @brief copy the current version, let fn modify the copy and publish it
+     * @param fn u8(T &), the copy is only published when fn returns 0
+     * @return u8 the value returned by fn
+     */
+    template <typename Fn>
+    u8 update(Fn &&fn)
+    {
+        std::unique_lock<std::mutex> lock(m_writeMutex);
+        std::shared_ptr<T> next = std::make_shared<T>(*load());
+        u8 ret = fn(*next);
+        if (ret)
+        {
+            return ret;
+        }
+
+        std::shared_ptr<const T> toPublish = std::move(next);
+#ifdef __cpp_lib_atomic_shared_ptr
+        m_data.store(std::move(toPublish), std::memory_order_release);
+#else
+        std::atomic_store_explicit(&m_data, std::move(toPublish),
+                                   std::memory_order_release);
+#endif
+        return ret;
+    }
+
+private:
+
+#ifdef __cpp_lib_atomic_shared_ptr
+    std::atomic<std::shared_ptr<const T>> m_data;
+#else
+    std::shared_ptr<const T> m_data;
+#endif
+
+    std::mutex m_writeMutex;
+
+}; // end class Snapshot
+
+} // end namespace Model
+
+#endif // _MODEL_SNAPSHOT_HPP_
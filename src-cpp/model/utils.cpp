@@ -24,6 +24,7 @@
 #include <filesystem>
 #include <regex>
 #include <mutex>
+#include <unordered_map>
 
 #include "controller/global/global.hpp"
 #include "spdlog/spdlog.h"
@@ -47,9 +48,11 @@ static std::regex ipRegex = std::regex("^((25[0-5]|2[0-4][0-9]|[01]?[0-9][0-9]?)
 
 static std::mutex consoleMutex;
 
+std::atomic<u32> debugSubsystems = (1u << LogSubsystem_COUNT) - 1;
+
 void writeLastError(const std::string_view &file, int line)
 {
-    spdlog::debug("{}:{} writeLastError", LOG_FILE_PATH(__FILE__), __LINE__);
+    FF_DEBUG("{}:{} writeLastError", LOG_FILE_PATH(__FILE__), __LINE__);
 #ifdef _WIN32
     LPSTR msgBuf = nullptr;
     DWORD errID = GetLastError();
@@ -78,14 +81,14 @@ void writeLastError(const std::string_view &file, int line)
 
 void writeConsole(const std::string &in)
 {
-    spdlog::debug("{}:{} writeConsole", LOG_FILE_PATH(__FILE__), __LINE__);
+    FF_DEBUG("{}:{} writeConsole", LOG_FILE_PATH(__FILE__), __LINE__);
     std::unique_lock<std::mutex> lock(consoleMutex);
     fmt::print("{}", in.c_str());
 }
 
 u8 verifyIP(const std::string &in)
 {
-    spdlog::debug("{}:{} verifyIP", LOG_FILE_PATH(__FILE__), __LINE__);
+    FF_DEBUG("{}:{} verifyIP", LOG_FILE_PATH(__FILE__), __LINE__);
     if (!std::regex_match(in, ipRegex))
     {
         return 1;
@@ -96,7 +99,7 @@ u8 verifyIP(const std::string &in)
 
 bool isAdmin()
 {
-    spdlog::debug("{}:{} isAdmin", LOG_FILE_PATH(__FILE__), __LINE__);
+    FF_DEBUG("{}:{} isAdmin", LOG_FILE_PATH(__FILE__), __LINE__);
 #ifdef _WIN32
     PSID sid;
     SID_IDENTIFIER_AUTHORITY auth = SECURITY_NT_AUTHORITY;
@@ -132,7 +135,7 @@ bool isAdmin()
 // for dir
 u8 verifyDir(const std::string &in)
 {
-    spdlog::debug("{}:{} verifyDir", LOG_FILE_PATH(__FILE__), __LINE__);
+    FF_DEBUG("{}:{} verifyDir", LOG_FILE_PATH(__FILE__), __LINE__);
 
     if (in.empty())
     {
@@ -165,7 +168,7 @@ u8 verifyDir(const std::string &in)
 
 u8 verifyFile(const std::string &in)
 {
-    spdlog::debug("{}:{} verifyFile", LOG_FILE_PATH(__FILE__), __LINE__);
+    FF_DEBUG("{}:{} verifyFile", LOG_FILE_PATH(__FILE__), __LINE__);
 
     if (in.empty())
     {
@@ -193,7 +196,7 @@ u8 verifyFile(const std::string &in)
 
 void deleteDirectoryContents(const std::string& dir_path)
 {
-    spdlog::debug("{}:{} deleteDirectoryContents",
+    FF_DEBUG("{}:{} deleteDirectoryContents",
         LOG_FILE_PATH(__FILE__), __LINE__);
 
     std::error_code ec;
@@ -203,7 +206,7 @@ void deleteDirectoryContents(const std::string& dir_path)
 
 void convertPath(std::string &toConvert)
 {
-    spdlog::debug("{}:{} convertPath", LOG_FILE_PATH(__FILE__), __LINE__);
+    FF_DEBUG("{}:{} convertPath", LOG_FILE_PATH(__FILE__), __LINE__);
 
 #ifdef _WIN32
     std::string from = "\\";
@@ -219,6 +222,39 @@ void convertPath(std::string &toConvert)
 #endif
 }
 
+u8 setDebugSubsystems(const std::vector<std::string> &names)
+{
+    FF_DEBUG("{}:{} setDebugSubsystems", LOG_FILE_PATH(__FILE__), __LINE__);
+
+    static const std::unordered_map<std::string, u8> table =
+    {
+        {"global", LogSubsystem_GLOBAL},
+        {"server", LogSubsystem_SERVER},
+        {"auth", LogSubsystem_AUTH},
+        {"connect", LogSubsystem_CONNECT},
+        {"dao", LogSubsystem_DAO},
+        {"proc", LogSubsystem_PROC},
+        {"metrics", LogSubsystem_METRICS}
+    };
+
+    u32 mask(0);
+    for (auto it = names.begin(); it != names.end(); ++it)
+    {
+        auto subsystem = table.find(*it);
+        if (subsystem == table.end())
+        {
+            spdlog::error("{}:{} Unknown subsystem: {}",
+                LOG_FILE_PATH(__FILE__), __LINE__, *it);
+            return 1;
+        }
+
+        mask |= 1u << subsystem->second;
+    }
+
+    debugSubsystems.store(mask, std::memory_order_relaxed);
+    return 0;
+}
+
 } // end namespace Utils
 
 } // end namespace Model
@@ -24,7 +24,12 @@
 #ifndef _MODEL_UTILS_HPP_
 #define _MODEL_UTILS_HPP_
 
+#include <atomic>
 #include <string>
+#include <type_traits>
+#include <vector>
+
+#include "spdlog/common.h"
 
 #include "defines.h"
 #include "config.h"
@@ -43,6 +48,71 @@ std::string_view relative_path(std::string_view path, std::string_view prefix)
 // Your logging macro uses this function:
 #define LOG_FILE_PATH(x) relative_path(x, PROJECT_ROOT_DIR)
 
+/** @name subsystems which can toggle their debug logs at runtime */
+/**{@*/
+#define LogSubsystem_GLOBAL  0
+#define LogSubsystem_SERVER  1
+#define LogSubsystem_AUTH    2
+#define LogSubsystem_CONNECT 3
+#define LogSubsystem_DAO     4
+#define LogSubsystem_PROC    5
+#define LogSubsystem_METRICS 6
+#define LogSubsystem_COUNT   7
+/**@}*/
+
+constexpr bool path_contains(std::string_view path, std::string_view dir)
+{
+    for (size_t i = 0; i + dir.size() <= path.size(); ++i)
+    {
+        size_t j(0);
+        for (; j < dir.size(); ++j)
+        {
+            char c = (path[i + j] == '\\') ? '/' : path[i + j];
+            if (c != dir[j])
+            {
+                break;
+            }
+        }
+
+        if (j == dir.size())
+        {
+            return true;
+        }
+    }
+
+    return false;
+}
+
+constexpr u8 log_subsystem(std::string_view path)
+{
+    if (path_contains(path, "controller/grpcserver/")) return LogSubsystem_SERVER;
+    if (path_contains(path, "model/auth/")) return LogSubsystem_AUTH;
+    if (path_contains(path, "model/connect/")) return LogSubsystem_CONNECT;
+    if (path_contains(path, "model/dao/")) return LogSubsystem_DAO;
+    if (path_contains(path, "model/proc/")) return LogSubsystem_PROC;
+    if (path_contains(path, "model/metrics/")) return LogSubsystem_METRICS;
+    return LogSubsystem_GLOBAL;
+}
+
+/**
+ * @brief debug log which is compiled out unless
+ * SPDLOG_ACTIVE_LEVEL <= SPDLOG_LEVEL_DEBUG,
+ * the arguments are only evaluated when the subsystem of the file is enabled
+ */
+#if SPDLOG_ACTIVE_LEVEL <= SPDLOG_LEVEL_DEBUG
+#define FF_DEBUG(...) \
+    do \
+    { \
+        if (Model::Utils::isDebugEnabled(std::integral_constant<u8, \
+                log_subsystem(__FILE__)>::value)) \
+        { \
+            spdlog::debug(__VA_ARGS__); \
+        } \
+    } while (0)
+#else
+#define FF_DEBUG(...) static_cast<void>(0)
+#endif
+
 namespace Model
 {
 
@@ -66,6 +136,21 @@ void deleteDirectoryContents(const std::string& dir_path);
 
 void convertPath(std::string &toConvert);
 
+// for log
+extern std::atomic<u32> debugSubsystems;
+
+inline bool isDebugEnabled(u8 subsystem)
+{
+    return debugSubsystems.load(std::memory_order_relaxed) & (1u << subsystem);
+}
+
+/**
+ * @brief only keep the debug logs of these subsystems
+ * @param names global, server, auth, connect, dao, proc or metrics
+ * @return u8 0 if success, 1 if there is an unknown name
+ */
+u8 setDebugSubsystems(const std::vector<std::string> &names);
+
 } // end namespace Utils
 
 } // end namespace Model
@@ -38,7 +38,7 @@ static BOOL eventHandler(DWORD dwCtrlType);
 int main(int argc, char **argv)
 {
     spdlog::cfg::load_env_levels();
-    spdlog::debug("{}:{} main", LOG_FILE_PATH(__FILE__), __LINE__);
+    FF_DEBUG("{}:{} main", LOG_FILE_PATH(__FILE__), __LINE__);
     if (Model::Utils::isAdmin())
     {
 #ifdef _WIN32
@@ -81,8 +81,9 @@ int main(int argc, char **argv)
         ret = 1;
     }
 
-    Controller::GRPCServer::fin();
+    // fin() stops the logger, say goodbye before it
     spdlog::info("{}", "Goodbye!");
+    Controller::GRPCServer::fin();
     return ret;
 }
 
@@ -0,0 +1,111 @@
+/*
+ * Flex Flow
+ * Copyright (c) 2026-present fdar0536
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include <atomic>
+#include <thread>
+
+#include "spdlog/spdlog.h"
+
+#include "model/dao/grpc/queuelist.hpp"
+#include "model/metrics/metrics.hpp"
+
+#include "testserver.hpp"
+
+namespace Test
+{
+
+// logins of many clients at once while another client lists the queues,
+// the password hashes run on the kdf pool, so the listing is not
+// stuck behind them on the gRPC threads
+TEST(LoginStorm, QueueRpcLatency)
+{
+    static constexpr size_t CALLS = 200;
+    static constexpr size_t STORM_CLIENTS = 16;
+
+    auto token = TestServer::connect("127.0.0.1");
+    ASSERT_NE(token, nullptr);
+
+    Model::DAO::GRPC::QueueList queueList;
+    ASSERT_EQ(queueList.init(token), 0);
+
+    auto measure = [&](std::vector<u64> &out)
+    {
+        out.clear();
+        out.reserve(CALLS);
+        for (size_t i = 0; i < CALLS; ++i)
+        {
+            std::vector<std::string> names;
+            auto start = std::chrono::steady_clock::now();
+            EXPECT_EQ(queueList.listQueue(names), 0);
+            out.push_back(Model::Metrics::elapsedUs(start));
+        }
+    };
+
+    std::vector<u64> idle;
+    measure(idle);
+
+    std::atomic<bool> isDone(false);
+    std::atomic<u64> logins(0), rejected(0);
+    std::vector<std::jthread> storm;
+    storm.reserve(STORM_CLIENTS);
+    for (size_t i = 0; i < STORM_CLIENTS; ++i)
+    {
+        storm.emplace_back([&]()
+        {
+            while (!isDone.load(std::memory_order_relaxed))
+            {
+                if (TestServer::connect("127.0.0.1"))
+                {
+                    logins.fetch_add(1, std::memory_order_relaxed);
+                }
+                else
+                {
+                    rejected.fetch_add(1, std::memory_order_relaxed);
+                }
+            }
+        });
+    }
+
+    std::vector<u64> busy;
+    measure(busy);
+    isDone.store(true, std::memory_order_relaxed);
+    storm.clear(); // join
+
+    u64 idleP99 = percentile(idle, 99);
+    u64 busyP99 = percentile(busy, 99);
+    RecordProperty("idle_p99_us", std::to_string(idleP99));
+    RecordProperty("storm_p99_us", std::to_string(busyP99));
+    RecordProperty("storm_logins", std::to_string(logins.load()));
+    RecordProperty("storm_rejected", std::to_string(rejected.load()));
+    fmt::println("queue rpc p99: {} us idle, {} us during the storm "
+                 "({} logins, {} rejected)",
+                 idleP99, busyP99, logins.load(), rejected.load());
+
+    EXPECT_GT(logins.load(), 0u);
+
+    // one argon2id takes a few hundred ms, a listing which waited for
+    // the hashes of the storm would take seconds
+    EXPECT_LT(busyP99, 1000000u);
+}
+
+} // end namespace Test
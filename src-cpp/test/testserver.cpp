@@ -0,0 +1,175 @@
+/*
+ * Flex Flow
+ * Copyright (c) 2026-present fdar0536
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include <algorithm>
+#include <filesystem>
+#include <fstream>
+#include <thread>
+
+#include "netinet/in.h"
+#include "sys/socket.h"
+#include "unistd.h"
+
+#include "controller/grpcserver/init.hpp"
+#include "model/auth/crypto.hpp"
+
+#include "testserver.hpp"
+
+namespace Test
+{
+
+// base32 of "12345678901234567890", the key of the RFC 6238 examples
+static const std::string totpKey = "GEZDGNBVGY3TQOJQGEZDGNBVGY3TQOJQ";
+
+static std::string dir("");
+
+static u16 listenPort(0);
+
+static std::jthread serverThread;
+
+static ::testing::Environment *const environment =
+    ::testing::AddGlobalTestEnvironment(new TestServer);
+
+static u16 freePort()
+{
+    int fd = socket(AF_INET, SOCK_STREAM, 0);
+    if (fd == -1)
+    {
+        return 0;
+    }
+
+    sockaddr_in addr{};
+    addr.sin_family = AF_INET;
+    addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+    addr.sin_port = 0;
+    socklen_t length = sizeof(addr);
+    u16 port(0);
+    if (!bind(fd, reinterpret_cast<sockaddr *>(&addr), sizeof(addr)) &&
+        !getsockname(fd, reinterpret_cast<sockaddr *>(&addr), &length))
+    {
+        port = ntohs(addr.sin_port);
+    }
+
+    close(fd);
+    return port;
+}
+
+void TestServer::SetUp()
+{
+    char path[] = "/tmp/fftest.XXXXXX";
+    ASSERT_NE(mkdtemp(path), nullptr);
+    dir = path;
+
+    listenPort = freePort();
+    ASSERT_NE(listenPort, 0);
+
+    std::string configPath = dir + "/config.yaml";
+    {
+        std::ofstream config(configPath);
+        config << "db path: " << dir << "\n"
+               << "log path: " << dir << "\n"
+               << "ip: 127.0.0.1\n"
+               << "port: " << listenPort << "\n"
+               << "log level: 4\n"
+               << "extra listen addresses: [\"" << unixTarget() << "\"]\n"
+               << "auth:\n"
+               << "  username: " << USERNAME << "\n"
+               << "  password: \"" << PASSWORD << "\"\n"
+               << "  salt: \"\"\n"
+               << "  totp key: " << totpKey << "\n"
+               << "  ban time: 600\n"
+               << "  max retry: 255\n"
+               << "  token timeout: 86400\n";
+        ASSERT_TRUE(config.good());
+    }
+
+    std::string name("FlexFlowServerTest"), option("-c");
+    char *argv[] = { name.data(), option.data(), configPath.data(), nullptr };
+    ASSERT_EQ(Controller::GRPCServer::init(3, argv), 0);
+
+    serverThread = std::jthread([]()
+    {
+        UNUSED(Controller::GRPCServer::server.start());
+    });
+
+    // it listens once a login goes through
+    std::shared_ptr<Model::Connect::GRPC::Token> token(nullptr);
+    for (int i = 0; i < 50 && !token; ++i)
+    {
+        token = connect("127.0.0.1");
+        if (!token)
+        {
+            std::this_thread::sleep_for(std::chrono::milliseconds(100));
+        }
+    }
+
+    ASSERT_NE(token, nullptr);
+}
+
+void TestServer::TearDown()
+{
+    Controller::GRPCServer::server.stop();
+    serverThread = std::jthread(); // join
+    Controller::GRPCServer::fin();
+
+    std::error_code ec;
+    std::filesystem::remove_all(dir, ec);
+}
+
+u16 TestServer::port()
+{
+    return listenPort;
+}
+
+std::string TestServer::unixTarget()
+{
+    return "unix:" + dir + "/flexflow.sock";
+}
+
+std::string TestServer::otp()
+{
+    std::vector<u8> key;
+    Model::Auth::Crypto::decodeBase32(totpKey, key);
+    return Model::Auth::Crypto::generateTotp(key);
+}
+
+std::shared_ptr<Model::Connect::GRPC::Token>
+TestServer::connect(const std::string &target)
+{
+    return Model::Connect::GRPC::connect(target, listenPort,
+                                         USERNAME, PASSWORD, otp());
+}
+
+u64 percentile(std::vector<u64> &us, const f64 percent)
+{
+    if (us.empty())
+    {
+        return 0;
+    }
+
+    std::sort(us.begin(), us.end());
+    size_t index = static_cast<size_t>(percent / 100 * static_cast<f64>(us.size()));
+    return us[std::min(index, us.size() - 1)];
+}
+
+} // end namespace Test
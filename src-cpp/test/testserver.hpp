@@ -0,0 +1,78 @@
+/*
+ * Flex Flow
+ * Copyright (c) 2026-present fdar0536
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#ifndef _TEST_TESTSERVER_HPP_
+#define _TEST_TESTSERVER_HPP_
+
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "gtest/gtest.h"
+
+#include "model/defines.h"
+#include "model/connect/grpc/connect.hpp"
+
+namespace Test
+{
+
+/**
+ * @brief the whole server in this process, listening on a free loopback
+ * port and on a unix socket, with a fresh database in a temporary folder
+ */
+class TestServer : public ::testing::Environment
+{
+public:
+
+    static constexpr const char *USERNAME = "test";
+
+    static constexpr const char *PASSWORD = "12345";
+
+    void SetUp() override;
+
+    void TearDown() override;
+
+    static u16 port();
+
+    // "unix:<path>"
+    static std::string unixTarget();
+
+    static std::string otp();
+
+    /**
+     * @brief login as USERNAME
+     * @param target "127.0.0.1" or unixTarget()
+     */
+    static std::shared_ptr<Model::Connect::GRPC::Token>
+    connect(const std::string &target);
+
+}; // end class TestServer
+
+/**
+ * @brief sort the latencies, then take the one at percent of them
+ */
+u64 percentile(std::vector<u64> &us, const f64 percent);
+
+} // end namespace Test
+
+#endif // _TEST_TESTSERVER_HPP_
@@ -0,0 +1,103 @@
+/*
+ * Flex Flow
+ * Copyright (c) 2026-present fdar0536
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include "spdlog/spdlog.h"
+
+#include "model/dao/grpc/queuelist.hpp"
+#include "model/metrics/metrics.hpp"
+
+#include "testserver.hpp"
+
+namespace Test
+{
+
+static void listLatency(const std::string &target, std::vector<u64> &out)
+{
+    static constexpr size_t CALLS = 2000;
+
+    auto token = TestServer::connect(target);
+    ASSERT_NE(token, nullptr);
+
+    Model::DAO::GRPC::QueueList queueList;
+    ASSERT_EQ(queueList.init(token), 0);
+
+    // warm up the channel first
+    std::vector<std::string> names;
+    ASSERT_EQ(queueList.listQueue(names), 0);
+
+    out.clear();
+    out.reserve(CALLS);
+    for (size_t i = 0; i < CALLS; ++i)
+    {
+        auto start = std::chrono::steady_clock::now();
+        ASSERT_EQ(queueList.listQueue(names), 0);
+        out.push_back(Model::Metrics::elapsedUs(start));
+    }
+}
+
+// the same calls over loopback tcp and over the unix socket
+TEST(UnixSocket, LoopbackLatency)
+{
+    std::vector<u64> tcp, local;
+    listLatency("127.0.0.1", tcp);
+    listLatency(TestServer::unixTarget(), local);
+
+    u64 tcpP50 = percentile(tcp, 50), tcpP99 = percentile(tcp, 99);
+    u64 unixP50 = percentile(local, 50), unixP99 = percentile(local, 99);
+    RecordProperty("tcp_p50_us", std::to_string(tcpP50));
+    RecordProperty("tcp_p99_us", std::to_string(tcpP99));
+    RecordProperty("unix_p50_us", std::to_string(unixP50));
+    RecordProperty("unix_p99_us", std::to_string(unixP99));
+    fmt::println("list queues p50/p99: tcp {}/{} us, unix socket {}/{} us",
+                 tcpP50, tcpP99, unixP50, unixP99);
+}
+
+// a bad token on the unix socket must not lock out the other local clients
+TEST(UnixSocket, BadTokenDoesNotBanLocalPeers)
+{
+    auto token = TestServer::connect(TestServer::unixTarget());
+    ASSERT_NE(token, nullptr);
+
+    auto bad = TestServer::connect(TestServer::unixTarget());
+    ASSERT_NE(bad, nullptr);
+    {
+        std::unique_lock<std::mutex> lock(bad->mutex);
+        bad->token = "bad";
+    }
+
+    Model::DAO::GRPC::QueueList badList;
+    ASSERT_EQ(badList.init(bad), 0);
+    for (int i = 0; i < 10; ++i)
+    {
+        std::vector<std::string> names;
+        EXPECT_NE(badList.listQueue(names), 0);
+    }
+
+    Model::DAO::GRPC::QueueList queueList;
+    ASSERT_EQ(queueList.init(token), 0);
+    std::vector<std::string> names;
+    EXPECT_EQ(queueList.listQueue(names), 0);
+    EXPECT_NE(TestServer::connect(TestServer::unixTarget()), nullptr);
+}
+
+} // end namespace Test
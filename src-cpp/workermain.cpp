@@ -0,0 +1,128 @@
+/*
+ * Flex Flow
+ * Copyright (c) 2026-present fdar0536
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+#include <csignal>
+
+#include "spdlog/spdlog.h"
+#include "spdlog/cfg/env.h"
+
+#include "controller/global/global.hpp"
+#include "controller/worker/worker.hpp"
+#include "model/errmsg.hpp"
+#include "model/utils.hpp"
+
+static Controller::Worker::Agent agent;
+
+static void sighandler(int signum);
+
+#ifdef _WIN32
+static BOOL eventHandler(DWORD dwCtrlType);
+#endif
+
+int main(int argc, char **argv)
+{
+    spdlog::cfg::load_env_levels();
+    FF_DEBUG("{}:{} main", LOG_FILE_PATH(__FILE__), __LINE__);
+    if (Model::Utils::isAdmin())
+    {
+#ifdef _WIN32
+        spdlog::error("{}:{} Refuse to run as administrator", LOG_FILE_PATH(__FILE__), __LINE__);
+#else
+        spdlog::error("{}:{} Refuse to run as super user",
+            LOG_FILE_PATH(__FILE__), __LINE__);
+#endif
+        return 1;
+    }
+
+    if (Controller::Global::consoleInit())
+    {
+        spdlog::error("{}:{} initConsole failed", LOG_FILE_PATH(__FILE__), __LINE__);
+        return 1;
+    }
+
+    Controller::Worker::Config config;
+    u8 code(Controller::Worker::Config::parse(&config, argc, argv));
+    if (code)
+    {
+        Controller::Global::consoleFin();
+        if (code == 2)
+        {
+            return 0;
+        }
+
+        spdlog::error("{}:{} parse config failed", LOG_FILE_PATH(__FILE__), __LINE__);
+        return 1;
+    }
+
+    Model::ErrMsg::init();
+    if (!config.logPath.empty() &&
+        Controller::Global::spdlogInit(config.logPath + "/FFWorker.log",
+                                       config.logLevel))
+    {
+        spdlog::error("{}:{} Fail to initialize spdlog", LOG_FILE_PATH(__FILE__), __LINE__);
+        Controller::Global::consoleFin();
+        return 1;
+    }
+
+    spdlog::set_level(static_cast<spdlog::level::level_enum>(config.logLevel));
+
+    int ret(0);
+    if (agent.init(config))
+    {
+        spdlog::error("{}:{} Fail to initialize worker", LOG_FILE_PATH(__FILE__), __LINE__);
+        ret = 1;
+    }
+    else
+    {
+        signal(SIGABRT, sighandler);
+        signal(SIGFPE,  sighandler);
+        signal(SIGILL,  sighandler);
+        signal(SIGINT,  sighandler);
+        signal(SIGSEGV, sighandler);
+        signal(SIGTERM, sighandler);
+
+#ifdef _WIN32
+        SetConsoleCtrlHandler(eventHandler, TRUE);
+#endif
+
+        agent.run();
+    }
+
+    spdlog::info("{}", "Goodbye!");
+    Controller::Global::consoleFin();
+    Controller::Global::spdlogFin();
+    return ret;
+}
+
+static void sighandler(int signum)
+{
+    UNUSED(signum);
+    agent.stop();
+}
+
+#ifdef _WIN32
+static BOOL eventHandler(DWORD dwCtrlType)
+{
+    sighandler(dwCtrlType);
+    return TRUE;
+}
+#endif
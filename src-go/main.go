@@ -68,6 +68,11 @@ func run() error {
 		return err
 	}
 
+	err = pb.RegisterMetricsHandlerFromEndpoint(ctx, mux, serverAddr, opts)
+	if err != nil {
+		return err
+	}
+
 	fmt.Printf("FlexFlow Gateway start successfully, listen on: %s\n", listenAddr)
 	return http.ListenAndServe(listenAddr, mux)
 }
@@ -77,6 +82,7 @@ func main() {
 	var args struct {
 		ServerIp    string `arg:"-s,--server-ip" help:"grpc server ip"`
 		ServerPort  uint16 `arg:"-p,--server-port" help:"grpc server port"`
+		ServerUnix  string `arg:"-u,--server-unix" help:"grpc server unix socket path, overrides ip and port"`
 		ListenIp    string `arg:"-l,--listen-ip" help:"http gateway listen ip"`
 		ListenPort  uint16 `arg:"-P,--listen-port" help:"http gateway listen port"`
 	}
@@ -89,6 +95,9 @@ func main() {
 
 	arg.MustParse(&args)
 	serverAddr = args.ServerIp + ":" + fmt.Sprint(args.ServerPort)
+	if args.ServerUnix != "" {
+		serverAddr = "unix:" + args.ServerUnix
+	}
 	listenAddr = args.ListenIp + ":" + fmt.Sprint(args.ListenPort)
 
 	if err := run(); err != nil {